@@ -21,10 +21,23 @@
 #define MDS_EMFS_WRITE_RETRY 3
 #endif
 
-#define EMFS_FS_HEADER_MAGIC 0x533B
+#if (defined(MDS_EMFS_WRITEBACK) && (MDS_EMFS_WRITEBACK > 0))
+#ifndef MDS_EMFS_WRITEBACK_THRESHOLD
+#define MDS_EMFS_WRITEBACK_THRESHOLD 256
+#endif
+
+// no timer behind it, the age of deferred data is checked by the next deferred operation
+#ifndef MDS_EMFS_WRITEBACK_TICKS
+#define MDS_EMFS_WRITEBACK_TICKS MDS_SYSTICK_FREQ_HZ
+#endif
+#endif
+
+#define EMFS_FS_HEADER_MAGIC 0x533C
+#define EMFS_FS_LEGACY_MAGIC 0x533B
 #define EMFS_FS_PAGE_SIZE    1024
 #define EMFS_FILE_SPLIT_SIZE 16
 #define EMFS_FILE_ID_MAX     0xFFFU
+#define EMFS_FS_RING_PAGES   128
 
 /* Typedef ----------------------------------------------------------------- */
 // fs sector size = 1024B * (fs->sector + 1) , max 256K
@@ -44,6 +57,51 @@ typedef struct EMFS_FileHeader {
     uint8_t id_used[0x03];
 } EMFS_FileHeader_t;
 
+// log record = data[length] + 0xFF padding + trailer, aligned to split size, appended from the page end downwards
+// length is the page length after the patch, check covers the record up to the trailer check field
+typedef struct EMFS_LogTrailer {
+    uint8_t offset[0x03];
+    uint8_t size[0x03];
+    uint8_t length[0x02];
+    uint8_t check[0x02];
+} EMFS_LogTrailer_t;
+
+/* Variable ---------------------------------------------------------------- */
+static const uint16_t G_EMFS_CHECK_TABLE[] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+};
+
 /* Function ---------------------------------------------------------------- */
 static uint16_t EMFS_FileSystemGetCheck(const EMFS_FsHeader_t *header)
 {
@@ -51,12 +109,18 @@ static uint16_t EMFS_FileSystemGetCheck(const EMFS_FsHeader_t *header)
             ((uint16_t)(header->check[0x01]) << (MDS_BITS_OF_BYTE * 0x00)));
 }
 
+static uint16_t EMFS_FileSystemGetMagic(const EMFS_FsHeader_t *header)
+{
+    return (((uint16_t)(header->magic[0x00]) << (MDS_BITS_OF_BYTE * 0x01)) |
+            ((uint16_t)(header->magic[0x01]) << (MDS_BITS_OF_BYTE * 0x00)));
+}
+
+// legacy pages rotated through the whole partition before the ring cap, they stay readable
 static bool EMFS_FileSystemJudgMagic(const EMFS_FsHeader_t *header)
 {
-    uint16_t magic = (((uint16_t)(header->magic[0x00]) << (MDS_BITS_OF_BYTE * 0x01)) |
-                      ((uint16_t)(header->magic[0x01]) << (MDS_BITS_OF_BYTE * 0x00)));
+    uint16_t magic = EMFS_FileSystemGetMagic(header);
 
-    return (magic == EMFS_FS_HEADER_MAGIC);
+    return ((magic == EMFS_FS_HEADER_MAGIC) || (magic == EMFS_FS_LEGACY_MAGIC));
 }
 
 static size_t EMFS_FileSystemGetPageSize(const EMFS_FsHeader_t *header)
@@ -138,7 +202,7 @@ static size_t EMFS_FileDataGetUsed(const EMFS_FileHeader_t *file)
 
 static void EMFS_FileDataSetSplitNum(EMFS_FileHeader_t *file, size_t split)
 {
-    file->split[0x00] = (uint8_t)(split);
+    file->split[0x00] = (uint8_t)(split - 1);
 }
 
 static void EMFS_FileDataSetId(EMFS_FileHeader_t *file, size_t id)
@@ -167,25 +231,55 @@ static void EMFS_FileDataSetCheck(EMFS_FileHeader_t *file, uint16_t check)
     file->check[0x01] = (uint8_t)(check >> (MDS_BITS_OF_BYTE * 0x00));
 }
 
-static uint16_t EMFS_DataCheckCalculate(uint16_t plus, const uint8_t *buff, size_t len)
+// walks buff backwards, see the byte order contract in emfs.h
+__attribute__((weak)) uint16_t MDS_EMFS_DataCheck(uint16_t plus, const uint8_t *buff, size_t len)
 {
     uint16_t crcValue = plus;
 
-    for (size_t idx = 1; idx <= len; idx++) {
-        uint16_t bitValue = buff[len - idx] << MDS_BITS_OF_BYTE;
-        for (size_t bit = 0; bit < MDS_BITS_OF_BYTE; bit++) {
-            crcValue = ((crcValue ^ bitValue) & 0x8000) ? ((crcValue << 1) ^ 0x1021) : (crcValue << 1);
-            bitValue <<= 1;
-        }
+    while (len > 0) {
+        len -= 1U;
+        crcValue = (uint16_t)(crcValue << MDS_BITS_OF_BYTE) ^
+                   G_EMFS_CHECK_TABLE[(uint8_t)(crcValue >> MDS_BITS_OF_BYTE) ^ buff[len]];
     }
 
     return (crcValue);
 }
 
+static uint16_t EMFS_DataCheckCalculate(uint16_t plus, const uint8_t *buff, size_t len)
+{
+    return (MDS_EMFS_DataCheck(plus, buff, len));
+}
+
+static uint16_t EMFS_DataCheckErased(uint16_t plus, size_t len)
+{
+    static const uint8_t erased[EMFS_FILE_SPLIT_SIZE] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    };
+    uint16_t check = plus;
+
+    while (len > 0) {
+        size_t cnt = (len > sizeof(erased)) ? (sizeof(erased)) : (len);
+        check = EMFS_DataCheckCalculate(check, erased, cnt);
+        len -= cnt;
+    }
+
+    return (check);
+}
+
+/* the unused page tail is checked as erased, so log records appended there keep the page check valid */
 static uint16_t EMFS_FileSystemSectorCheck(const EMFS_FsHeader_t *header)
 {
-    return (EMFS_DataCheckCalculate(0, (uint8_t *)header + sizeof(header->check),
-                                    EMFS_FileSystemGetPageSize(header) - sizeof(header->check)));
+    size_t pageSize = EMFS_FileSystemGetPageSize(header);
+    size_t length = sizeof(EMFS_FsHeader_t) + EMFS_FileSystemGetPageLength(header);
+
+    if (length > pageSize) {
+        length = pageSize;
+    }
+
+    uint16_t check = EMFS_DataCheckErased(0, pageSize - length);
+
+    return (EMFS_DataCheckCalculate(check, (uint8_t *)header + sizeof(header->check),
+                                    length - sizeof(header->check)));
 }
 
 static uint16_t EMFS_FileDataSingleCheck(const EMFS_FileHeader_t *file)
@@ -205,7 +299,7 @@ static size_t EMFS_DeviceSearchPageSize(DEV_STORAGE_Periph_t *device, uint8_t *p
     }
 
     for (size_t readOfs = 0; readOfs < totalSize; readOfs += EMFS_FS_PAGE_SIZE) {
-        err = DEV_STORAGE_PeriphRead(device, 0, readOfs, pageBuff, buffSize);
+        err = DEV_STORAGE_PeriphRead(device, 0, readOfs, pageBuff, sizeof(EMFS_FsHeader_t));
         if (err != MDS_EOK) {
             continue;
         }
@@ -216,7 +310,8 @@ static size_t EMFS_DeviceSearchPageSize(DEV_STORAGE_Periph_t *device, uint8_t *p
         }
 
         pageSize = EMFS_FileSystemGetPageSize(header);
-        if ((pageSize < EMFS_FS_PAGE_SIZE) || ((pageSize % EMFS_FS_PAGE_SIZE) != 0) || (pageSize > buffSize)) {
+        if ((pageSize > buffSize) || ((readOfs + pageSize) > totalSize) ||
+            (DEV_STORAGE_PeriphRead(device, 0, readOfs, pageBuff, pageSize) != MDS_EOK)) {
             pageSize = 0;
             continue;
         }
@@ -231,7 +326,96 @@ static size_t EMFS_DeviceSearchPageSize(DEV_STORAGE_Periph_t *device, uint8_t *p
 
     DEV_STORAGE_PeriphClose(device);
 
-    return (0);
+    return (pageSize);
+}
+
+static size_t EMFS_LogRecordSize(size_t size)
+{
+    return (VALUE_ALIGN(size + sizeof(EMFS_LogTrailer_t) + EMFS_FILE_SPLIT_SIZE - 1, EMFS_FILE_SPLIT_SIZE));
+}
+
+static uint16_t EMFS_LogRecordCheck(const uint8_t *record, size_t recsz)
+{
+    return (EMFS_DataCheckCalculate(0, record, recsz - sizeof(((EMFS_LogTrailer_t *)0)->check)));
+}
+
+static void EMFS_FileSystemLogReplay(MDS_EMFS_FileSystem_t *fs)
+{
+    uint8_t *page = fs->init.buff;
+    EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)page;
+    size_t logOfs = fs->init.size;
+    size_t logLimit = sizeof(EMFS_FsHeader_t) + EMFS_FileSystemGetPageLength(header);
+
+    while (logOfs >= (logLimit + EMFS_FILE_SPLIT_SIZE)) {
+        const EMFS_LogTrailer_t *trailer = (const EMFS_LogTrailer_t *)(page + logOfs - sizeof(EMFS_LogTrailer_t));
+        size_t idx = 0;
+
+        while ((idx < sizeof(EMFS_LogTrailer_t)) && (((const uint8_t *)trailer)[idx] == 0xFF)) {
+            idx++;
+        }
+        if (idx == sizeof(EMFS_LogTrailer_t)) {
+            break;
+        }
+
+        size_t offset = ((size_t)(trailer->offset[0x00]) << (MDS_BITS_OF_BYTE * 0x02)) |
+                        ((size_t)(trailer->offset[0x01]) << (MDS_BITS_OF_BYTE * 0x01)) |
+                        ((size_t)(trailer->offset[0x02]) << (MDS_BITS_OF_BYTE * 0x00));
+        size_t size = ((size_t)(trailer->size[0x00]) << (MDS_BITS_OF_BYTE * 0x02)) |
+                      ((size_t)(trailer->size[0x01]) << (MDS_BITS_OF_BYTE * 0x01)) |
+                      ((size_t)(trailer->size[0x02]) << (MDS_BITS_OF_BYTE * 0x00));
+        size_t length = MDS_GetU16BE(trailer->length);
+        size_t recsz = EMFS_LogRecordSize(size);
+
+        if ((recsz > (logOfs - logLimit)) || (offset < sizeof(EMFS_FsHeader_t)) ||
+            ((sizeof(EMFS_FsHeader_t) + length) > (logOfs - recsz)) ||
+            ((offset + size) > (sizeof(EMFS_FsHeader_t) + length)) ||
+            (MDS_GetU16BE(trailer->check) != EMFS_LogRecordCheck(page + logOfs - recsz, recsz))) {
+            MDS_LOG_W("[emfs] fs:%p drop broken log at page ofs:%u", fs, logOfs);
+            logOfs = 0;
+            break;
+        }
+
+        MDS_MemBuffCopy(page + offset, size, page + logOfs - recsz, size);
+        EMFS_FileSystemSetPageLength(header, length);
+        logOfs -= recsz;
+        if (logLimit < (sizeof(EMFS_FsHeader_t) + length)) {
+            logLimit = sizeof(EMFS_FsHeader_t) + length;
+        }
+    }
+
+    size_t used = sizeof(EMFS_FsHeader_t) + EMFS_FileSystemGetPageLength(header);
+    MDS_MemBuffSet(page + used, 0xFF, fs->init.size - used);
+
+    fs->logOfs = logOfs;
+    fs->logLimit = logLimit;
+    fs->dirtyS = 0;
+    fs->dirtyE = 0;
+}
+
+static EMFS_FileHeader_t *EMFS_FileSystemSearchFile(const MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id)
+{
+    EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)(fs->init.buff);
+    EMFS_FileHeader_t *find = (EMFS_FileHeader_t *)((uint8_t *)header + sizeof(EMFS_FsHeader_t));
+    EMFS_FileHeader_t *limit = (EMFS_FileHeader_t *)((uint8_t *)find + EMFS_FileSystemGetPageLength(header));
+
+    while (find < limit) {
+        if (EMFS_FileDataGetId(find) == id) {
+            return (find);
+        }
+        find = (EMFS_FileHeader_t *)((uint8_t *)find + EMFS_FileDataGetSplitSize(find));
+    }
+
+    return (NULL);
+}
+
+/* a reload brings back the flushed layout, resize may have moved open records since */
+static void EMFS_FileSystemRelinkOpened(MDS_EMFS_FileSystem_t *fs)
+{
+    MDS_EMFS_FileDesc_t *iter = NULL;
+
+    MDS_LIST_FOREACH_NEXT (iter, node, &(fs->list)) {
+        iter->data = (uint8_t *)EMFS_FileSystemSearchFile(fs, iter->id);
+    }
 }
 
 static MDS_Err_t EMFS_FileSystemReadCheckPage(MDS_EMFS_FileSystem_t *fs, size_t readOfs)
@@ -249,52 +433,160 @@ static MDS_Err_t EMFS_FileSystemReadCheckPage(MDS_EMFS_FileSystem_t *fs, size_t
     }
 
     EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)(fs->init.buff);
-    if ((EMFS_FileSystemJudgMagic(header) == false) || (EMFS_FileSystemGetPageSize(header) > fs->init.size) ||
+    if ((EMFS_FileSystemJudgMagic(header) == false) || (EMFS_FileSystemGetPageSize(header) != fs->init.size) ||
         (EMFS_FileSystemGetCheck(header) != EMFS_FileSystemSectorCheck(header))) {
         return (MDS_EAGAIN);
     }
 
+    EMFS_FileSystemLogReplay(fs);
+    EMFS_FileSystemRelinkOpened(fs);
+
     return (MDS_EOK);
 }
 
-static MDS_Err_t EMFS_FileSystemSearchLastPage(MDS_EMFS_FileSystem_t *fs)
+/* the 8-bit page index only orders pages within half of its range, so the rotation ring is capped to that */
+static size_t EMFS_FileSystemRingSize(MDS_EMFS_FileSystem_t *fs)
 {
-    size_t totalSize = DEV_STORAGE_PeriphTotalSize(fs->init.device);
-    if (totalSize < EMFS_FS_PAGE_SIZE) {
-        return (MDS_EIO);
+    size_t pages = DEV_STORAGE_PeriphTotalSize(fs->init.device) / fs->init.size;
+
+    if (pages > EMFS_FS_RING_PAGES) {
+        pages = EMFS_FS_RING_PAGES;
     }
 
+    return (pages * fs->init.size);
+}
+
+static bool EMFS_FileSystemReadHeader(MDS_EMFS_FileSystem_t *fs, size_t readOfs, uint16_t magic, size_t *index)
+{
+    EMFS_FsHeader_t header;
+
+    MDS_Err_t err = DEV_STORAGE_PeriphRead(fs->init.device, 0, readOfs, (uint8_t *)(&header), sizeof(header));
+    if ((err != MDS_EOK) || (EMFS_FileSystemGetMagic(&header) != magic) ||
+        (EMFS_FileSystemGetPageSize(&header) != fs->init.size) ||
+        ((sizeof(EMFS_FsHeader_t) + EMFS_FileSystemGetPageLength(&header)) > fs->init.size)) {
+        return (false);
+    }
+
+    *index = EMFS_FileSystemGetIndex(&header);
+
+    return (true);
+}
+
+/* newest header index in the ring, or the newest one older than upper and within half the index range of newest */
+static bool EMFS_FileSystemScanIndex(MDS_EMFS_FileSystem_t *fs, size_t totalSize, uint16_t magic,
+                                     const size_t *newest, size_t upper, size_t *index)
+{
     bool hasFind = false;
-    bool hasZero = false;
-    size_t findOfs = 0;
-    size_t findIdx = 0;
 
-    size_t tempOfs = ((fs->readOfs + fs->init.size) <= totalSize) ? (fs->readOfs) : (0);
-    do {
-        if (EMFS_FileSystemReadCheckPage(fs, tempOfs) == MDS_EOK) {
-            EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)(fs->init.buff);
-            size_t tempIdx = EMFS_FileSystemGetIndex(header);
-            if (tempIdx == 0) {
-                hasZero = true;
-            }
-            if (((hasZero == false) && (tempIdx >= findIdx)) ||
-                ((hasZero != false) && ((intptr_t)(tempIdx) >= (intptr_t)(findIdx)))) {
-                findOfs = tempOfs;
-                findIdx = tempIdx;
-                hasFind = true;
-            }
+    if (DEV_STORAGE_PeriphOpen(fs->init.device, MDS_TICK_FOREVER) != MDS_EOK) {
+        return (false);
+    }
+
+    for (size_t tempOfs = 0; (tempOfs + fs->init.size) <= totalSize; tempOfs += fs->init.size) {
+        size_t tempIdx;
+        if (EMFS_FileSystemReadHeader(fs, tempOfs, magic, &tempIdx) == false) {
+            continue;
+        }
+        if ((newest != NULL) && (((int8_t)(*newest - tempIdx) < 0) || ((int8_t)(upper - tempIdx) <= 0))) {
+            continue;
+        }
+        // the 8-bit index wraps, live pages always lie within half of its range
+        if ((hasFind == false) || ((int8_t)(tempIdx - *index) > 0)) {
+            *index = tempIdx;
+            hasFind = true;
+        }
+    }
+
+    DEV_STORAGE_PeriphClose(fs->init.device);
+
+    return (hasFind);
+}
+
+static MDS_Err_t EMFS_FileSystemSearchIndexPage(MDS_EMFS_FileSystem_t *fs, size_t totalSize, uint16_t magic,
+                                                size_t index)
+{
+    for (size_t tempOfs = 0; (tempOfs + fs->init.size) <= totalSize; tempOfs += fs->init.size) {
+        size_t tempIdx = 0;
+
+        MDS_Err_t err = DEV_STORAGE_PeriphOpen(fs->init.device, MDS_TICK_FOREVER);
+        if (err != MDS_EOK) {
+            return (err);
         }
-        tempOfs = ((tempOfs + fs->init.size) < totalSize) ? (tempOfs + fs->init.size) : (0);
-    } while (tempOfs != fs->readOfs);
+        bool hasHeader = EMFS_FileSystemReadHeader(fs, tempOfs, magic, &tempIdx);
+        DEV_STORAGE_PeriphClose(fs->init.device);
 
-    if (hasFind) {
-        fs->readOfs = findOfs;
-        return (EMFS_FileSystemReadCheckPage(fs, findOfs));
+        if ((hasHeader != false) && (tempIdx == index) && (EMFS_FileSystemReadCheckPage(fs, tempOfs) == MDS_EOK)) {
+            fs->readOfs = tempOfs;
+            return (MDS_EOK);
+        }
     }
 
+    return (MDS_ENOENT);
+}
+
+static MDS_Err_t EMFS_FileSystemSearchRingPage(MDS_EMFS_FileSystem_t *fs, size_t totalSize, uint16_t magic)
+{
+    // only headers are scanned, the full page read and check runs on candidates from the newest index down
+    size_t newest = 0;
+    if (EMFS_FileSystemScanIndex(fs, totalSize, magic, NULL, 0, &newest) == false) {
+        return (MDS_EIO);
+    }
+
+    size_t findIdx = newest;
+    do {
+        if (EMFS_FileSystemSearchIndexPage(fs, totalSize, magic, findIdx) == MDS_EOK) {
+            return (MDS_EOK);
+        }
+    } while (EMFS_FileSystemScanIndex(fs, totalSize, magic, &newest, findIdx, &findIdx));
+
     return (MDS_EIO);
 }
 
+/* a legacy layout rotates through every slot, so the first one past the ring is rewritten on each lap */
+static bool EMFS_FileSystemCheckPastRing(MDS_EMFS_FileSystem_t *fs, size_t totalSize)
+{
+    if ((totalSize + fs->init.size) > DEV_STORAGE_PeriphTotalSize(fs->init.device)) {
+        return (false);
+    }
+
+    if (DEV_STORAGE_PeriphOpen(fs->init.device, MDS_TICK_FOREVER) != MDS_EOK) {
+        return (false);
+    }
+
+    size_t index = 0;
+    bool hasHeader = EMFS_FileSystemReadHeader(fs, totalSize, EMFS_FS_LEGACY_MAGIC, &index);
+    DEV_STORAGE_PeriphClose(fs->init.device);
+
+    return (hasHeader);
+}
+
+/* same full scan and index order the legacy layout was mounted with, so it resumes from the same page */
+static MDS_Err_t EMFS_FileSystemSearchLegacyPage(MDS_EMFS_FileSystem_t *fs)
+{
+    size_t totalSize = DEV_STORAGE_PeriphTotalSize(fs->init.device);
+    size_t findOfs = totalSize;
+    size_t findIdx = 0;
+
+    for (size_t tempOfs = 0; (tempOfs + fs->init.size) <= totalSize; tempOfs += fs->init.size) {
+        if (EMFS_FileSystemReadCheckPage(fs, tempOfs) != MDS_EOK) {
+            continue;
+        }
+        size_t tempIdx = EMFS_FileSystemGetIndex((EMFS_FsHeader_t *)(fs->init.buff));
+        if ((findOfs == totalSize) || ((int8_t)(tempIdx - findIdx) >= 0)) {
+            findOfs = tempOfs;
+            findIdx = tempIdx;
+        }
+    }
+
+    if (findOfs == totalSize) {
+        return (MDS_EIO);
+    }
+
+    fs->readOfs = findOfs;
+
+    return (EMFS_FileSystemReadCheckPage(fs, findOfs));
+}
+
 static size_t EMFS_FileSystemGetBlockIndex(DEV_STORAGE_Periph_t *device, size_t blkNums, size_t offset)
 {
     size_t blkOffset = 0;
@@ -315,7 +607,7 @@ static size_t EMFS_FileSystemGetBlockIndex(DEV_STORAGE_Periph_t *device, size_t
 static MDS_Err_t EMFS_FileSystemEraseNextPage(MDS_EMFS_FileSystem_t *fs, size_t nextOfs)
 {
     size_t blkNums = DEV_STORAGE_PeriphBlockNums(fs->init.device);
-    size_t totalSize = DEV_STORAGE_PeriphTotalSize(fs->init.device);
+    size_t totalSize = EMFS_FileSystemRingSize(fs);
 
     size_t writeBlkS = EMFS_FileSystemGetBlockIndex(fs->init.device, blkNums, nextOfs);
     size_t writeBlkE = EMFS_FileSystemGetBlockIndex(fs->init.device, blkNums, nextOfs + fs->init.size - 1);
@@ -340,7 +632,31 @@ static MDS_Err_t EMFS_FileSystemEraseNextPage(MDS_EMFS_FileSystem_t *fs, size_t
     return (err);
 }
 
-static MDS_Err_t EMFS_FileSystemCheckBlankPage(MDS_EMFS_FileSystem_t *fs, size_t nextOfs)
+static MDS_Err_t EMFS_FileSystemErasePastRing(MDS_EMFS_FileSystem_t *fs, size_t totalSize)
+{
+    size_t blkNums = DEV_STORAGE_PeriphBlockNums(fs->init.device);
+    size_t blkS = EMFS_FileSystemGetBlockIndex(fs->init.device, blkNums, totalSize);
+
+    // a block shared with the last ring page is left alone
+    if (blkS == EMFS_FileSystemGetBlockIndex(fs->init.device, blkNums, totalSize - 1)) {
+        blkS += 1;
+    }
+    if (blkS >= blkNums) {
+        return (MDS_EOK);
+    }
+
+    MDS_Err_t err = DEV_STORAGE_PeriphOpen(fs->init.device, MDS_TICK_FOREVER);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    err = DEV_STORAGE_PeriphErase(fs->init.device, blkS, blkNums - blkS);
+    DEV_STORAGE_PeriphClose(fs->init.device);
+
+    return (err);
+}
+
+static MDS_Err_t EMFS_FileSystemCheckBlankPage(MDS_EMFS_FileSystem_t *fs, size_t nextOfs, size_t size)
 {
     MDS_Err_t err = DEV_STORAGE_PeriphOpen(fs->init.device, MDS_TICK_FOREVER);
     if (err != MDS_EOK) {
@@ -350,10 +666,10 @@ static MDS_Err_t EMFS_FileSystemCheckBlankPage(MDS_EMFS_FileSystem_t *fs, size_t
     uintptr_t buff[EMFS_FS_PAGE_SIZE / EMFS_FILE_SPLIT_SIZE];
     size_t ofs = 0;
 
-    while ((err == MDS_EOK) && (ofs < fs->init.size)) {
-        size_t read = ((fs->init.size - ofs) > sizeof(buff)) ? (sizeof(buff)) : (fs->init.size - ofs);
+    while ((err == MDS_EOK) && (ofs < size)) {
+        size_t read = ((size - ofs) > sizeof(buff)) ? (sizeof(buff)) : (size - ofs);
         err = DEV_STORAGE_PeriphRead(fs->init.device, 0, nextOfs + ofs, (uint8_t *)buff, read);
-        for (size_t idx = 0; (err == MDS_EOK) && (idx < read); idx++) {
+        for (size_t idx = 0; (err == MDS_EOK) && (idx < (read / sizeof(uintptr_t))); idx++) {
             if (buff[idx] != __UINTPTR_MAX__) {
                 err = MDS_EFAULT;
             }
@@ -368,65 +684,250 @@ static MDS_Err_t EMFS_FileSystemCheckBlankPage(MDS_EMFS_FileSystem_t *fs, size_t
 
 static MDS_Err_t EMFS_FileSystemFindNextPage(MDS_EMFS_FileSystem_t *fs, size_t nextOfs)
 {
-    size_t totalSize = DEV_STORAGE_PeriphTotalSize(fs->init.device);
+    size_t totalSize = EMFS_FileSystemRingSize(fs);
     if (totalSize < fs->init.size) {
         return (MDS_EIO);
     }
 
     MDS_Err_t err = MDS_EIO;
 
-    size_t tempOfs = ((nextOfs + fs->init.size) <= totalSize) ? (nextOfs) : (0);
+    size_t startOfs = ((nextOfs + fs->init.size) <= totalSize) ? (nextOfs) : (0);
+    size_t tempOfs = startOfs;
     do {
-        err = EMFS_FileSystemCheckBlankPage(fs, tempOfs);
+        err = EMFS_FileSystemCheckBlankPage(fs, tempOfs, fs->init.size);
         if (err == MDS_EOK) {
             fs->writeOfs = tempOfs;
             break;
         }
-        tempOfs = ((tempOfs + fs->init.size) < totalSize) ? (tempOfs + fs->init.size) : (0);
-    } while (tempOfs != fs->readOfs);
+        tempOfs = ((tempOfs + fs->init.size + fs->init.size) <= totalSize) ? (tempOfs + fs->init.size) : (0);
+    } while (tempOfs != startOfs);
 
+    while (err != MDS_EOK) {
+        err = EMFS_FileSystemEraseNextPage(fs, tempOfs);
+        if (err == MDS_EOK) {
+            fs->writeOfs = tempOfs;
+            break;
+        }
+        tempOfs = ((tempOfs + fs->init.size + fs->init.size) <= totalSize) ? (tempOfs + fs->init.size) : (0);
+        if (tempOfs == startOfs) {
+            break;
+        }
+    }
+
+    return (err);
+}
+
+static MDS_Err_t EMFS_FileSystemProgramVerify(MDS_EMFS_FileSystem_t *fs, size_t writeOfs, const uint8_t *data,
+                                              size_t size)
+{
+    MDS_Err_t err = DEV_STORAGE_PeriphOpen(fs->init.device, MDS_TICK_FOREVER);
     if (err != MDS_EOK) {
-        err = EMFS_FileSystemEraseNextPage(fs, nextOfs);
+        return (err);
     }
 
+    err = DEV_STORAGE_PeriphProgram(fs->init.device, 0, writeOfs, data, size);
+
+    uint8_t buff[EMFS_FS_PAGE_SIZE / EMFS_FILE_SPLIT_SIZE];
+    for (size_t ofs = 0; (err == MDS_EOK) && (ofs < size); ofs += sizeof(buff)) {
+        size_t read = ((size - ofs) > sizeof(buff)) ? (sizeof(buff)) : (size - ofs);
+        err = DEV_STORAGE_PeriphReadThrough(fs->init.device, 0, writeOfs + ofs, buff, read);
+        if ((err == MDS_EOK) && (MDS_MemBuffCmp(buff, data + ofs, read) != 0)) {
+            err = MDS_EIO;
+        }
+    }
+
+    DEV_STORAGE_PeriphClose(fs->init.device);
+
     return (err);
 }
 
 static MDS_Err_t EMFS_FileSystemWriteFlush(MDS_EMFS_FileSystem_t *fs)
 {
-    MDS_Err_t err;
+    MDS_Err_t err = MDS_EIO;
     EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)(fs->init.buff);
 
     size_t index = EMFS_FileSystemGetIndex(header) + 1;
+    EMFS_FileSystemSetMagic(header);
     EMFS_FileSystemSetIndex(header, index);
 
     uint16_t check = EMFS_FileSystemSectorCheck(header);
     EMFS_FileSystemSetCheck(header, check);
 
     for (size_t retry = 0; retry <= MDS_EMFS_WRITE_RETRY; retry++) {
-        err = EMFS_FileSystemFindNextPage(fs, fs->writeOfs);
+        err = EMFS_FileSystemFindNextPage(fs, fs->readOfs + fs->init.size);
         if (err != MDS_EOK) {
             continue;
         }
-        err = DEV_STORAGE_PeriphOpen(fs->init.device, MDS_TICK_FOREVER);
-        if (err != MDS_EOK) {
-            break;
-        }
-        err = DEV_STORAGE_PeriphProgram(fs->init.device, 0, fs->writeOfs, fs->init.buff, fs->init.size);
-        DEV_STORAGE_PeriphClose(fs->init.device);
 
-        if ((err == MDS_EOK) && (EMFS_FileSystemReadCheckPage(fs, fs->writeOfs) == MDS_EOK)) {
+        err = EMFS_FileSystemProgramVerify(fs, fs->writeOfs, fs->init.buff, fs->init.size);
+        if (err == MDS_EOK) {
             fs->readOfs = fs->writeOfs;
+            fs->logOfs = fs->init.size;
+            fs->logLimit = sizeof(EMFS_FsHeader_t) + EMFS_FileSystemGetPageLength(header);
+            fs->dirtyS = 0;
+            fs->dirtyE = 0;
             break;
         }
     }
 
     if (err != MDS_EOK) {
-        err = EMFS_FileSystemReadCheckPage(fs, fs->readOfs);
+        MDS_LOG_E("[emfs] fs:%p flush err:%d reload ofs:%u", fs, err, fs->readOfs);
+        EMFS_FileSystemReadCheckPage(fs, fs->readOfs);
+    }
+
+    return (err);
+}
+
+static MDS_Err_t EMFS_FileSystemSearchLastPage(MDS_EMFS_FileSystem_t *fs)
+{
+    size_t totalSize = EMFS_FileSystemRingSize(fs);
+    if (totalSize < fs->init.size) {
+        return (MDS_EIO);
+    }
+
+    // pages of the ring layout win, legacy ones only count until the first flush after an upgrade
+    bool pastRing = EMFS_FileSystemCheckPastRing(fs, totalSize);
+    MDS_Err_t err = EMFS_FileSystemSearchRingPage(fs, totalSize, EMFS_FS_HEADER_MAGIC);
+    if (pastRing == false) {
+        return ((err == MDS_EOK) ? (err) : (EMFS_FileSystemSearchRingPage(fs, totalSize, EMFS_FS_LEGACY_MAGIC)));
+    }
+
+    // a legacy layout larger than the ring is mounted once with the full scan and its newest page moved in
+    if (err != MDS_EOK) {
+        MDS_LOG_W("[emfs] fs:%p migrate legacy layout into the %u page ring", fs, EMFS_FS_RING_PAGES);
+        err = EMFS_FileSystemSearchLegacyPage(fs);
+        if (err != MDS_EOK) {
+            return (err);
+        }
+        // the legacy pages stay in place until the copy is in, the next mount retries after a failure
+        if (EMFS_FileSystemWriteFlush(fs) != MDS_EOK) {
+            return (MDS_EOK);
+        }
+    }
+
+    if (EMFS_FileSystemErasePastRing(fs, totalSize) != MDS_EOK) {
+        MDS_LOG_W("[emfs] fs:%p legacy pages past the ring not erased", fs);
+    }
+
+    return (MDS_EOK);
+}
+
+#if (defined(MDS_EMFS_WRITEBACK) && (MDS_EMFS_WRITEBACK > 0))
+static MDS_Err_t EMFS_FileSystemLogAppend(MDS_EMFS_FileSystem_t *fs)
+{
+    uint8_t *page = fs->init.buff;
+    size_t length = EMFS_FileSystemGetPageLength((EMFS_FsHeader_t *)page);
+    size_t used = sizeof(EMFS_FsHeader_t) + length;
+    size_t dirtyE = (fs->dirtyE < used) ? (fs->dirtyE) : (used);
+    size_t size = (dirtyE > fs->dirtyS) ? (dirtyE - fs->dirtyS) : (0);
+    size_t recsz = EMFS_LogRecordSize(size);
+    size_t limit = (fs->logLimit > used) ? (fs->logLimit) : (used);
+
+    // replay patches the page in place, so a record never sits below any length the page had since its flush
+    if ((fs->dirtyS < sizeof(EMFS_FsHeader_t)) || (fs->logOfs < (limit + recsz))) {
+        return (MDS_ENOMEM);
+    }
+
+    size_t recOfs = fs->logOfs - recsz;
+    MDS_Err_t err = EMFS_FileSystemCheckBlankPage(fs, fs->readOfs + recOfs, recsz);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    // program split aligned data in place, the unaligned rest goes out together with the trailer
+    uint8_t tail[EMFS_FILE_SPLIT_SIZE * 0x03];
+    size_t head = VALUE_ALIGN(size, EMFS_FILE_SPLIT_SIZE);
+    size_t tailsz = recsz - head;
+    EMFS_LogTrailer_t *trailer = (EMFS_LogTrailer_t *)(tail + tailsz - sizeof(EMFS_LogTrailer_t));
+
+    MDS_MemBuffSet(tail, 0xFF, tailsz);
+    MDS_MemBuffCopy(tail, tailsz, page + fs->dirtyS + head, size - head);
+    trailer->offset[0x00] = (uint8_t)(fs->dirtyS >> (MDS_BITS_OF_BYTE * 0x02));
+    trailer->offset[0x01] = (uint8_t)(fs->dirtyS >> (MDS_BITS_OF_BYTE * 0x01));
+    trailer->offset[0x02] = (uint8_t)(fs->dirtyS >> (MDS_BITS_OF_BYTE * 0x00));
+    trailer->size[0x00] = (uint8_t)(size >> (MDS_BITS_OF_BYTE * 0x02));
+    trailer->size[0x01] = (uint8_t)(size >> (MDS_BITS_OF_BYTE * 0x01));
+    trailer->size[0x02] = (uint8_t)(size >> (MDS_BITS_OF_BYTE * 0x00));
+    MDS_PutU16BE(trailer->length, (uint16_t)length);
+
+    uint16_t check = EMFS_DataCheckCalculate(0, tail, tailsz - sizeof(trailer->check));
+    check = EMFS_DataCheckCalculate(check, page + fs->dirtyS, head);
+    MDS_PutU16BE(trailer->check, check);
+
+    if (head > 0) {
+        err = EMFS_FileSystemProgramVerify(fs, fs->readOfs + recOfs, page + fs->dirtyS, head);
+    }
+    if (err == MDS_EOK) {
+        err = EMFS_FileSystemProgramVerify(fs, fs->readOfs + recOfs + head, tail, tailsz);
+    }
+    if (err == MDS_EOK) {
+        fs->logOfs = recOfs;
+        fs->logLimit = limit;
+        fs->dirtyS = 0;
+        fs->dirtyE = 0;
     }
 
     return (err);
 }
+#endif
+
+static MDS_Err_t EMFS_FileSystemWriteBack(MDS_EMFS_FileSystem_t *fs)
+{
+    if (fs->dirtyE <= fs->dirtyS) {
+        return (MDS_EOK);
+    }
+
+#if (defined(MDS_EMFS_WRITEBACK) && (MDS_EMFS_WRITEBACK > 0))
+    if (EMFS_FileSystemLogAppend(fs) == MDS_EOK) {
+        return (MDS_EOK);
+    }
+#endif
+
+    return (EMFS_FileSystemWriteFlush(fs));
+}
+
+static MDS_Err_t EMFS_FileSystemCommit(MDS_EMFS_FileSystem_t *fs, bool barrier)
+{
+    if (!barrier) {
+#if (defined(MDS_EMFS_WRITEBACK) && (MDS_EMFS_WRITEBACK > 0))
+        if (((fs->dirtyE - fs->dirtyS) < MDS_EMFS_WRITEBACK_THRESHOLD) &&
+            ((MDS_SysTickGetCount() - fs->dirtyTick) < MDS_EMFS_WRITEBACK_TICKS)) {
+            return (MDS_EOK);
+        }
+#else
+        return (MDS_EOK);
+#endif
+    }
+
+    MDS_Err_t err = EMFS_FileSystemWriteBack(fs);
+    if ((err != MDS_EOK) || (!barrier)) {
+        return (err);
+    }
+
+    // a barrier also drains the device cache
+    err = DEV_STORAGE_PeriphOpen(fs->init.device, MDS_TICK_FOREVER);
+    if (err == MDS_EOK) {
+        err = DEV_STORAGE_PeriphSync(fs->init.device);
+        DEV_STORAGE_PeriphClose(fs->init.device);
+    }
+
+    return (err);
+}
+
+static void EMFS_FileSystemMarkDirty(MDS_EMFS_FileSystem_t *fs, const void *start, size_t size)
+{
+    size_t dirtyS = (uintptr_t)start - (uintptr_t)(fs->init.buff);
+    size_t dirtyE = dirtyS + size;
+
+    if (fs->dirtyE <= fs->dirtyS) {
+        fs->dirtyS = dirtyS;
+        fs->dirtyE = dirtyE;
+        fs->dirtyTick = MDS_SysTickGetCount();
+    } else {
+        fs->dirtyS = (dirtyS < fs->dirtyS) ? (dirtyS) : (fs->dirtyS);
+        fs->dirtyE = (dirtyE > fs->dirtyE) ? (dirtyE) : (fs->dirtyE);
+    }
+}
 
 MDS_Err_t MDS_EMFS_Mkfs(DEV_STORAGE_Periph_t *device, size_t pageSize)
 {
@@ -460,7 +961,7 @@ MDS_Err_t MDS_EMFS_Mkfs(DEV_STORAGE_Periph_t *device, size_t pageSize)
             check = EMFS_DataCheckCalculate(check, buff + sizeof(header->check), sizeof(buff) - sizeof(header->check));
             EMFS_FileSystemSetCheck(header, check);
         }
-        err = DEV_STORAGE_PeriphProgram(device, 0, 0, buff, sizeof(buff));
+        err = DEV_STORAGE_PeriphProgram(device, 0, ofs - sizeof(buff), buff, sizeof(buff));
     }
     DEV_STORAGE_PeriphClose(device);
 
@@ -490,8 +991,15 @@ MDS_Err_t MDS_EMFS_Mount(MDS_EMFS_FileSystem_t *fs, const MDS_EMFS_FsInitStruct_
         fs->init.device = init->device;
         fs->init.buff = init->buff;
         fs->init.size = pageSize;
+        fs->readOfs = 0;
+        fs->writeOfs = 0;
+        fs->logOfs = 0;
+        fs->logLimit = 0;
+        fs->dirtyS = 0;
+        fs->dirtyE = 0;
 
         err = EMFS_FileSystemSearchLastPage(fs);
+        fs->writeOfs = fs->readOfs;
 
         MDS_MutexRelease(&(fs->mutex));
     }
@@ -515,46 +1023,52 @@ MDS_Err_t MDS_EMFS_Unmout(MDS_EMFS_FileSystem_t *fs)
     if (!MDS_ListIsEmpty(&(fs->list))) {
         err = MDS_EBUSY;
     } else {
+        err = EMFS_FileSystemCommit(fs, true);
+    }
+
+    MDS_MutexRelease(&(fs->mutex));
+
+    if (err == MDS_EOK) {
         MDS_MutexDeInit(&(fs->mutex));
     }
 
-    return (MDS_EOK);
+    return (err);
 }
 
-MDS_EMFS_FileDesc_t *MDS_EMFS_FileGetOpened(MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id)
+MDS_Err_t MDS_EMFS_Sync(MDS_EMFS_FileSystem_t *fs)
 {
     MDS_ASSERT(fs != NULL);
-    MDS_ASSERT(id < EMFS_FILE_ID_MAX);
 
-    MDS_EMFS_FileDesc_t *iter = NULL;
-
-    MDS_LIST_FOREACH_NEXT (iter, node, &(fs->list)) {
-        if (EMFS_FileDataGetId((EMFS_FileHeader_t *)(iter->data)) == id) {
-            return (iter);
-        }
+    MDS_Err_t err = MDS_MutexAcquire(&(fs->mutex), MDS_EMFS_LOCK_TIMEOUT);
+    if (err != MDS_EOK) {
+        return (err);
     }
 
-    return (NULL);
+    err = EMFS_FileSystemCommit(fs, true);
+
+    MDS_MutexRelease(&(fs->mutex));
+
+    return (err);
 }
 
-static EMFS_FileHeader_t *EMFS_FileSystemSearchFile(const MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id)
+MDS_EMFS_FileDesc_t *MDS_EMFS_FileGetOpened(MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id)
 {
-    EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)(fs->init.buff);
-    EMFS_FileHeader_t *find = (EMFS_FileHeader_t *)((uint8_t *)header + sizeof(EMFS_FsHeader_t));
-    EMFS_FileHeader_t *limit = (EMFS_FileHeader_t *)((uint8_t *)find + EMFS_FileSystemGetPageLength(header));
+    MDS_ASSERT(fs != NULL);
+    MDS_ASSERT(id < EMFS_FILE_ID_MAX);
 
-    while (find < limit) {
-        if (EMFS_FileDataGetId(find) == id) {
-            return (find);
+    MDS_EMFS_FileDesc_t *iter = NULL;
+
+    MDS_LIST_FOREACH_NEXT (iter, node, &(fs->list)) {
+        if (iter->id == id) {
+            return (iter);
         }
-        find = (EMFS_FileHeader_t *)((uint8_t *)find + EMFS_FileDataGetSplitSize(find));
     }
 
     return (NULL);
 }
 
-static EMFS_FileHeader_t *EMFS_FileCreateData(const MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id,
-                                              const uint8_t *data, uint16_t len)
+static EMFS_FileHeader_t *EMFS_FileCreateData(MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id, const uint8_t *data,
+                                              uint16_t len)
 {
     EMFS_FileHeader_t *file = NULL;
     EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)(fs->init.buff);
@@ -563,13 +1077,13 @@ static EMFS_FileHeader_t *EMFS_FileCreateData(const MDS_EMFS_FileSystem_t *fs, M
     size_t splitnm = (len + sizeof(EMFS_FileHeader_t) + EMFS_FILE_SPLIT_SIZE) / EMFS_FILE_SPLIT_SIZE;
     size_t splitsz = EMFS_FILE_SPLIT_SIZE * splitnm;
 
-    if ((fs->init.size - length) >= splitsz) {
+    if ((fs->init.size - sizeof(EMFS_FsHeader_t) - length) >= splitsz) {
         file = (EMFS_FileHeader_t *)((uint8_t *)header + sizeof(EMFS_FsHeader_t) + length);
         EMFS_FileDataSetSplitNum(file, splitnm);
         EMFS_FileDataSetId(file, id);
-        EMFS_FileDataSetUsed(file, sizeof(EMFS_FileHeader_t) + len);
+        EMFS_FileDataSetUsed(file, len);
 
-        for (size_t idx = 0; idx < splitsz; idx++) {
+        for (size_t idx = 0; idx < (splitsz - sizeof(EMFS_FileHeader_t)); idx++) {
             *((uint8_t *)file + sizeof(EMFS_FileHeader_t) + idx) = ((idx < len) && (data != NULL)) ? (data[idx])
                                                                                                    : (0xFF);
         }
@@ -578,6 +1092,7 @@ static EMFS_FileHeader_t *EMFS_FileCreateData(const MDS_EMFS_FileSystem_t *fs, M
         EMFS_FileDataSetCheck(file, check);
 
         EMFS_FileSystemSetPageLength(header, length + splitsz);
+        EMFS_FileSystemMarkDirty(fs, file, splitsz);
     }
 
     return (file);
@@ -597,7 +1112,60 @@ static void EMFS_FileRemoveData(MDS_EMFS_FileSystem_t *fs, EMFS_FileHeader_t *fi
         *dst++ = (src < end) ? (*src++) : (__UINT16_MAX__);
     }
 
+    MDS_EMFS_FileDesc_t *iter = NULL;
+    MDS_LIST_FOREACH_NEXT (iter, node, &(fs->list)) {
+        if ((iter->data > (uint8_t *)file) && (iter->data < (uint8_t *)end)) {
+            iter->data -= split;
+        }
+    }
+
     EMFS_FileSystemSetPageLength(header, length - split);
+    EMFS_FileSystemMarkDirty(fs, file, (uint8_t *)end - (uint8_t *)file);
+}
+
+static void EMFS_FileReverseData(uint8_t *buff, size_t len)
+{
+    for (size_t idx = 0; idx < (len / 0x02); idx++) {
+        uint8_t swap = buff[idx];
+        buff[idx] = buff[len - 1 - idx];
+        buff[len - 1 - idx] = swap;
+    }
+}
+
+static EMFS_FileHeader_t *EMFS_FileResizeData(MDS_EMFS_FileSystem_t *fs, EMFS_FileHeader_t *file, size_t size)
+{
+    EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)(fs->init.buff);
+    size_t length = EMFS_FileSystemGetPageLength(header);
+    size_t splitsz = EMFS_FileDataGetSplitSize(file);
+    size_t splitnm = (size + EMFS_FILE_SPLIT_SIZE - 1) / EMFS_FILE_SPLIT_SIZE;
+    size_t resize = EMFS_FILE_SPLIT_SIZE * splitnm;
+
+    if ((splitnm > (__UINT8_MAX__ + 1U)) || ((fs->init.size - sizeof(EMFS_FsHeader_t) - length) < (resize - splitsz))) {
+        return (NULL);
+    }
+
+    // rotate the record behind the last file in place, then grow it into the free space
+    uint8_t *end = (uint8_t *)header + sizeof(EMFS_FsHeader_t) + length;
+    EMFS_FileReverseData((uint8_t *)file, splitsz);
+    EMFS_FileReverseData((uint8_t *)file + splitsz, end - (uint8_t *)file - splitsz);
+    EMFS_FileReverseData((uint8_t *)file, end - (uint8_t *)file);
+
+    EMFS_FileHeader_t *move = (EMFS_FileHeader_t *)(end - splitsz);
+    MDS_EMFS_FileDesc_t *iter = NULL;
+    MDS_LIST_FOREACH_NEXT (iter, node, &(fs->list)) {
+        if (iter->data == (uint8_t *)file) {
+            iter->data = (uint8_t *)move;
+        } else if ((iter->data > (uint8_t *)file) && (iter->data < end)) {
+            iter->data -= splitsz;
+        }
+    }
+
+    MDS_MemBuffSet(end, 0xFF, resize - splitsz);
+    EMFS_FileDataSetSplitNum(move, splitnm);
+    EMFS_FileSystemSetPageLength(header, length + resize - splitsz);
+    EMFS_FileSystemMarkDirty(fs, file, end + resize - splitsz - (uint8_t *)file);
+
+    return (move);
 }
 
 MDS_Err_t MDS_EMFS_Unlink(MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id)
@@ -618,7 +1186,7 @@ MDS_Err_t MDS_EMFS_Unlink(MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id)
 
     if (err == MDS_EOK) {
         EMFS_FileRemoveData(fs, file);
-        EMFS_FileSystemWriteFlush(fs);
+        err = EMFS_FileSystemCommit(fs, true);
     }
 
     MDS_MutexRelease(&(fs->mutex));
@@ -650,7 +1218,8 @@ MDS_Err_t MDS_EMFS_Rename(MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t oldid, MD
         uint16_t check = EMFS_FileDataSingleCheck(file);
         EMFS_FileDataSetCheck(file, check);
 
-        EMFS_FileSystemWriteFlush(fs);
+        EMFS_FileSystemMarkDirty(fs, file, sizeof(EMFS_FileHeader_t));
+        err = EMFS_FileSystemCommit(fs, true);
     }
 
     MDS_MutexRelease(&(fs->mutex));
@@ -677,9 +1246,14 @@ MDS_Err_t MDS_EMFS_FileCreate(MDS_EMFS_FileDesc_t *fd, MDS_EMFS_FileSystem_t *fs
         if (file == NULL) {
             err = MDS_ENOMEM;
         } else {
+            // a failed commit reloads the page, which drops the new file again
+            err = EMFS_FileSystemCommit(fs, false);
+        }
+        if (err == MDS_EOK) {
             MDS_ListInitNode(&(fd->node));
             MDS_ListInsertNodePrev(&(fs->list), &(fd->node));
             fd->fs = fs;
+            fd->id = id;
             fd->data = (uint8_t *)file;
         }
     }
@@ -707,6 +1281,7 @@ MDS_Err_t MDS_EMFS_FileOpen(MDS_EMFS_FileDesc_t *fd, MDS_EMFS_FileSystem_t *fs,
         MDS_ListInitNode(&(fd->node));
         MDS_ListInsertNodePrev(&(fs->list), &(fd->node));
         fd->fs = fs;
+        fd->id = id;
         fd->data = (uint8_t *)file;
     }
 
@@ -725,7 +1300,7 @@ MDS_Err_t MDS_EMFS_FileClose(MDS_EMFS_FileDesc_t *fd)
         return (err);
     }
 
-    EMFS_FileSystemWriteFlush(fd->fs);
+    err = EMFS_FileSystemCommit(fs, true);
 
     fd->data = NULL;
     fd->fs = NULL;
@@ -781,20 +1356,45 @@ size_t MDS_EMFS_FileTruncate(MDS_EMFS_FileDesc_t *fd, intptr_t ofs)
         return (MDS_EIO);
     }
 
+    MDS_EMFS_FileSystem_t *fs = fd->fs;
+    if (MDS_MutexAcquire(&(fs->mutex), MDS_EMFS_LOCK_TIMEOUT) != MDS_EOK) {
+        return (0);
+    }
+
     EMFS_FileHeader_t *file = (EMFS_FileHeader_t *)(fd->data);
+    if (file == NULL) {
+        MDS_MutexRelease(&(fs->mutex));
+        return (0);
+    }
+
     size_t used = EMFS_FileDataGetUsed(file);
+    size_t trunc = used;
 
     if (ofs >= 0) {
         if ((size_t)ofs < used) {
-            EMFS_FileDataSetUsed(file, used = ofs);
+            trunc = ofs;
         }
     } else if ((size_t)(-ofs) < used) {
         ofs = used + ofs;
-        used = MDS_MemBuffCopy((uint8_t *)file + sizeof(EMFS_FileHeader_t), used,
-                               (uint8_t *)file + sizeof(EMFS_FileHeader_t) + ofs, used - ofs);
+        trunc = MDS_MemBuffCopy((uint8_t *)file + sizeof(EMFS_FileHeader_t), used,
+                                (uint8_t *)file + sizeof(EMFS_FileHeader_t) + ofs, used - ofs);
     }
 
-    return (used);
+    if (trunc != used) {
+        EMFS_FileDataSetUsed(file, trunc);
+
+        uint16_t check = EMFS_FileDataSingleCheck(file);
+        EMFS_FileDataSetCheck(file, check);
+
+        EMFS_FileSystemMarkDirty(fs, file, sizeof(EMFS_FileHeader_t) + used);
+        if (EMFS_FileSystemCommit(fs, false) != MDS_EOK) {
+            trunc = used;
+        }
+    }
+
+    MDS_MutexRelease(&(fs->mutex));
+
+    return (trunc);
 }
 
 MDS_Err_t MDS_EMFS_FileRead(MDS_EMFS_FileDesc_t *fd, intptr_t ofs, uint8_t *buff, size_t len, size_t *read)
@@ -835,7 +1435,9 @@ MDS_Err_t MDS_EMFS_FileRead(MDS_EMFS_FileDesc_t *fd, intptr_t ofs, uint8_t *buff
             }
         }
 
-        if (MDS_GetU16BE(file->check) != EMFS_FileDataSingleCheck(file)) {
+        // the reload relinked the descriptor, its record may sit elsewhere or be gone
+        file = (EMFS_FileHeader_t *)(fd->data);
+        if ((file == NULL) || (MDS_GetU16BE(file->check) != EMFS_FileDataSingleCheck(file))) {
             err = MDS_EIO;
         }
 
@@ -872,10 +1474,11 @@ MDS_Err_t MDS_EMFS_FileWrite(MDS_EMFS_FileDesc_t *fd, intptr_t ofs, const uint8_
     MDS_Err_t err;
     size_t count = 0;
     size_t used = EMFS_FileDataGetUsed(file);
-    ofs = EFMS_FileUsedCalcOfs(used, ofs);
+    ofs = (ofs == (intptr_t)used) ? (ofs) : (EFMS_FileUsedCalcOfs(used, ofs));
 
     do {
         if (((ofs + len) <= used) && (memcmp((uint8_t *)file + sizeof(EMFS_FileHeader_t) + ofs, buff, len) == 0)) {
+            count = len;
             err = MDS_EOK;
             break;
         }
@@ -885,19 +1488,30 @@ MDS_Err_t MDS_EMFS_FileWrite(MDS_EMFS_FileDesc_t *fd, intptr_t ofs, const uint8_
             break;
         }
 
-        EMFS_FsHeader_t *header = (EMFS_FsHeader_t *)(fd->fs->init.buff);
-        size_t pageused = sizeof(EMFS_FsHeader_t) + EMFS_FileSystemGetPageLength(header);
-        size_t splitsz = EMFS_FileDataGetSplitSize(file);
-        size_t spacesz = EMFS_FileSystemGetPageSize(header) - pageused;
-        if ((splitsz < (len + sizeof(EMFS_FileHeader_t))) && (spacesz < (len + sizeof(EMFS_FileHeader_t) - splitsz))) {
-            err = MDS_ERANGE;
-        } else if ((ofs + len) < splitsz) {
-            count = MDS_MemBuffCopy((uint8_t *)file + sizeof(EMFS_FileHeader_t) + ofs, splitsz - ofs, buff, len);
-        } else {
-            MDS_MemBuffCopy((uint8_t *)(header) + pageused, spacesz, (uint8_t *)file, sizeof(EMFS_FileHeader_t) + used);
-            EMFS_FileRemoveData(fd->fs, file);
-            file = (EMFS_FileHeader_t *)((uint8_t *)(header) + pageused - sizeof(EMFS_FileHeader_t) - used);
-            count = MDS_MemBuffCopy((uint8_t *)file + sizeof(EMFS_FileHeader_t) + ofs, splitsz - ofs, buff, len);
+        // a reload under the lock may have dropped the record of this descriptor
+        file = (EMFS_FileHeader_t *)(fd->data);
+        size_t total = sizeof(EMFS_FileHeader_t) + ofs + len;
+        if (file == NULL) {
+            err = MDS_EIO;
+        } else if (total > EMFS_FileDataGetSplitSize(file)) {
+            file = ((ofs + len) <= 0xFFFU) ? (EMFS_FileResizeData(fd->fs, file, total)) : (NULL);
+            err = (file == NULL) ? (MDS_ERANGE) : (MDS_EOK);
+        }
+
+        if (err == MDS_EOK) {
+            count = MDS_MemBuffCopy((uint8_t *)file + sizeof(EMFS_FileHeader_t) + ofs, len, buff, len);
+            if ((ofs + count) > used) {
+                EMFS_FileDataSetUsed(file, ofs + count);
+            }
+
+            uint16_t check = EMFS_FileDataSingleCheck(file);
+            EMFS_FileDataSetCheck(file, check);
+
+            EMFS_FileSystemMarkDirty(fd->fs, file, total);
+            err = EMFS_FileSystemCommit(fd->fs, false);
+            if (err != MDS_EOK) {
+                count = 0;
+            }
         }
 
         MDS_MutexRelease(&(fd->fs->mutex));
@@ -34,6 +34,11 @@ typedef struct MDS_EMFS_FileSystem {
     size_t pageSize;
     size_t readOfs;
     size_t writeOfs;
+    size_t logOfs;
+    size_t logLimit;
+    size_t dirtyS;
+    size_t dirtyE;
+    MDS_Tick_t dirtyTick;
 
     MDS_EMFS_FsInitStruct_t init;
 } MDS_EMFS_FileSystem_t;
@@ -41,13 +46,24 @@ typedef struct MDS_EMFS_FileSystem {
 typedef struct MDS_EMFS_FileDesc {
     MDS_ListNode_t node;
     MDS_EMFS_FileSystem_t *fs;
+    MDS_EMFS_FileId_t id;
     uint8_t *data;
 } MDS_EMFS_FileDesc_t;
 
 /* Function ---------------------------------------------------------------- */
+/*
+ * CRC-16 step (poly 0x1021, MSB first, not reflected, no final xor) continued from plus.
+ * The bytes are consumed in REVERSE order: buff[len - 1] first, buff[0] last. This order is part of the on-media
+ * format and can not change without breaking formatted pages. The function is weak, a replacement such as a hw CRC
+ * engine must return the same value, e.g. by feeding the engine from the end of buff or from a reversed copy.
+ */
+extern uint16_t MDS_EMFS_DataCheck(uint16_t plus, const uint8_t *buff, size_t len);
+
 extern MDS_Err_t MDS_EMFS_Mkfs(DEV_STORAGE_Periph_t *device, size_t sctsz);
 extern MDS_Err_t MDS_EMFS_Mount(MDS_EMFS_FileSystem_t *fs, const MDS_EMFS_FsInitStruct_t *init);
 extern MDS_Err_t MDS_EMFS_Unmout(MDS_EMFS_FileSystem_t *fs);
+/* commits deferred data, nothing else does while the fs is idle, so write-back users call it periodically */
+extern MDS_Err_t MDS_EMFS_Sync(MDS_EMFS_FileSystem_t *fs);
 
 extern MDS_EMFS_FileDesc_t *MDS_EMFS_FileGetOpened(MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id);
 extern MDS_Err_t MDS_EMFS_Unlink(MDS_EMFS_FileSystem_t *fs, MDS_EMFS_FileId_t id);
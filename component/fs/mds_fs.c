@@ -12,6 +12,20 @@
 /* Include ----------------------------------------------------------------- */
 #include "mds_fs.h"
 
+/* Define ------------------------------------------------------------------ */
+#ifndef MDS_FILESYSTEM_PATH_SIZE
+#define MDS_FILESYSTEM_PATH_SIZE 64
+#endif
+
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+#if ((MDS_FILESYSTEM_HASH_SIZE & (MDS_FILESYSTEM_HASH_SIZE - 1)) != 0)
+#error "file system hash size must be power of 2"
+#endif
+#endif
+
+#define MDS_FILESYSTEM_HASH_INIT  0x811C9DC5U
+#define MDS_FILESYSTEM_HASH_PRIME 0x01000193U
+
 /* Memory ------------------------------------------------------------------ */
 __attribute__((weak)) void *MDS_FsMalloc(size_t size)
 {
@@ -40,27 +54,26 @@ __attribute__((weak)) char *MDS_FsStrdup(const char *str)
 }
 
 /* Path -------------------------------------------------------------------- */
-static char *MDS_FileSystemNormalizePath(char *fullpath)
+static char *MDS_FsPathCompact(char *fullpath)
 {
     char *src = fullpath;
     char *dst = fullpath;
 
     while (*src != '\0') {
-        if (src[0] == '.') {
-            if (src[1] == '/') {  // "./"
-                for (src += 1; *src == '/'; src++) {
-                }
-                continue;
-            } else if ((src[1] == '.') && (src[1 + 1] == '/')) {  // "../"
-                for (src += 1 + 1; *src == '/'; src++) {
-                }
-                if (dst <= fullpath) {
-                    return (NULL);
-                }
-                do {
-                    dst--;
-                } while ((fullpath < dst) && (dst[-1] != '/'));
+        if ((src[0] == '.') && ((src[1] == '/') || (src[1] == '\0'))) {  // "./"
+            for (src += 1; *src == '/'; src++) {
+            }
+            continue;
+        } else if ((src[0] == '.') && (src[1] == '.') && ((src[1 + 1] == '/') || (src[1 + 1] == '\0'))) {  // "../"
+            for (src += 1 + 1; *src == '/'; src++) {
             }
+            if ((dst - fullpath) <= 1) {
+                return (NULL);
+            }
+            do {
+                dst--;
+            } while ((fullpath < dst) && (dst[-1] != '/'));
+            continue;
         }
 
         while ((*src != '\0') && (*src != '/')) {
@@ -71,6 +84,7 @@ static char *MDS_FileSystemNormalizePath(char *fullpath)
             }
         }
     }
+    *dst = '\0';
 
     if ((dst > fullpath) && (dst[-1] == '/')) {
         dst[-1] = '\0';
@@ -83,43 +97,99 @@ static char *MDS_FileSystemNormalizePath(char *fullpath)
     return (fullpath);
 }
 
-char *MDS_FileSystemJoinPath(const char *dirpath, const char *filepath)
+char *MDS_FileSystemNormalizePath(char *buff, size_t size, const char *dirpath, const char *filepath)
 {
-    char *abspath = NULL;
+    if ((buff == NULL) || (filepath == NULL) || ((dirpath == NULL) && (filepath[0] != '/'))) {
+        return (NULL);
+    }
 
+    size_t dpathlen = (filepath[0] == '/') ? (0) : (strlen(dirpath) + 1);
+    size_t fpathlen = strlen(filepath) + 1;
+    if (size < (dpathlen + fpathlen)) {
+        return (NULL);
+    }
+
+    if (dpathlen > 0) {
+        MDS_MemBuffCopy(buff, size, dirpath, dpathlen - 1);
+        buff[dpathlen - 1] = '/';
+    }
+    MDS_MemBuffCopy(&(buff[dpathlen]), size - dpathlen, filepath, fpathlen);
+
+    return (MDS_FsPathCompact(buff));
+}
+
+char *MDS_FileSystemJoinPath(const char *dirpath, const char *filepath)
+{
     if ((filepath == NULL) || ((dirpath == NULL) && (filepath[0] != '/'))) {
         return (NULL);
     }
 
-    if (filepath[0] == '/') {
-        abspath = MDS_FsStrdup(filepath);
-        if (abspath == NULL) {
-            return (NULL);
-        }
-        return (MDS_FileSystemNormalizePath(abspath));
-    } else {
-        size_t dpathlen = strlen(dirpath) + 1;
-        size_t fpathlen = strlen(filepath) + 1;
-        char *fullpath = (char *)MDS_FsMalloc(dpathlen + fpathlen);
-        if (fullpath == NULL) {
-            return (NULL);
-        }
+    size_t size = strlen(filepath) + 1 + ((filepath[0] == '/') ? (0) : (strlen(dirpath) + 1));
+    char *fullpath = (char *)MDS_FsMalloc(size);
+    if (fullpath == NULL) {
+        return (NULL);
+    }
+
+    char *abspath = MDS_FileSystemNormalizePath(fullpath, size, dirpath, filepath);
+    if (abspath == NULL) {
+        MDS_FsFree(fullpath);
+    }
 
-        MDS_MemBuffCopy(fullpath, dpathlen + fpathlen, dirpath, dpathlen - 1);
-        fullpath[dpathlen - 1] = '/';
-        MDS_MemBuffCopy(&(fullpath[dpathlen]), fpathlen, filepath, fpathlen - 1);
-        fullpath[dpathlen + fpathlen - 1] = '\0';
+    return (abspath);
+}
 
-        abspath = MDS_FileSystemNormalizePath(fullpath);
+static char *MDS_FsPathAcquire(char *buff, size_t size, const char *path)
+{
+    // paths that fit are resolved in the caller's buffer, only longer ones go to the heap
+    char *abspath = MDS_FileSystemNormalizePath(buff, size, NULL, path);
+    if ((abspath == NULL) && (path[0] == '/') && (strlen(path) >= size)) {
+        abspath = MDS_FileSystemJoinPath(NULL, path);
     }
 
     return (abspath);
 }
 
+static void MDS_FsPathRelease(const char *buff, char *abspath)
+{
+    if ((abspath != NULL) && (abspath != buff)) {
+        MDS_FsFree(abspath);
+    }
+}
+
+#if ((defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0)) ||                                       \
+     (defined(MDS_FILESYSTEM_PATH_CACHE) && (MDS_FILESYSTEM_PATH_CACHE > 0)))
+static uint32_t MDS_FsPathHash(const char *path, size_t len)
+{
+    uint32_t hash = MDS_FILESYSTEM_HASH_INIT;
+
+    for (size_t idx = 0; idx < len; idx++) {
+        hash = (hash ^ (uint8_t)path[idx]) * MDS_FILESYSTEM_HASH_PRIME;
+    }
+
+    return (hash);
+}
+#endif
+
 /* FileSystem -------------------------------------------------------------- */
 static MDS_Mutex_t g_fsLock;
 static MDS_ListNode_t g_fsList = {.prev = &g_fsList, .next = &g_fsList};
 
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+static MDS_FileSystem_t *g_fsHash[MDS_FILESYSTEM_HASH_SIZE];
+#endif
+
+#if (defined(MDS_FILESYSTEM_PATH_CACHE) && (MDS_FILESYSTEM_PATH_CACHE > 0))
+typedef struct MDS_FsPathEntry {
+    MDS_FileSystem_t *fs;
+    uint32_t hash;
+    char path[MDS_FILESYSTEM_PATH_SIZE];
+    char abspath[MDS_FILESYSTEM_PATH_SIZE];
+} MDS_FsPathEntry_t;
+
+static MDS_FsPathEntry_t g_fsPathCache[MDS_FILESYSTEM_PATH_CACHE];
+static size_t g_fsPathVictim;
+#endif
+
 static void MDS_FsLock(void)
 {
     MDS_Err_t err;
@@ -142,20 +212,72 @@ static const MDS_FileSystemOps_t *MDS_FileSystemOpsFind(const char *fsName)
 {
     static const void *mdsFsOpsBegin __attribute__((section(MDS_FILE_SYSTEM_SECTION "\000"))) = NULL;
     static const void *mdsFsOpsLimit __attribute__((section(MDS_FILE_SYSTEM_SECTION "\177"))) = NULL;
-    const MDS_FileSystemOps_t *mdsFsOpsS = (const MDS_FileSystemOps_t *)((uintptr_t)(&mdsFsOpsBegin) + sizeof(void *));
-    const MDS_FileSystemOps_t *mdsFsOPsE = (const MDS_FileSystemOps_t *)((uintptr_t)(&mdsFsOpsLimit));
+    const MDS_FileSystemOps_t **mdsFsOpsS =
+        (const MDS_FileSystemOps_t **)((uintptr_t)(&mdsFsOpsBegin) + sizeof(void *));
+    const MDS_FileSystemOps_t **mdsFsOPsE = (const MDS_FileSystemOps_t **)((uintptr_t)(&mdsFsOpsLimit));
 
-    for (const MDS_FileSystemOps_t *ops = mdsFsOpsS; ops < mdsFsOPsE; ops++) {
-        if (strcmp(ops->name, fsName) == 0) {
-            return (ops);
+    for (const MDS_FileSystemOps_t **ops = mdsFsOpsS; ops < mdsFsOPsE; ops++) {
+        if ((*ops != NULL) && (strcmp((*ops)->name, fsName) == 0)) {
+            return (*ops);
         }
     }
 
     return (NULL);
 }
 
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+static size_t MDS_FsHashIndex(uint32_t hash)
+{
+    hash ^= hash >> 16;
+
+    return (hash & (MDS_FILESYSTEM_HASH_SIZE - 1));
+}
+
+static void MDS_FileSystemHashInsert(MDS_FileSystem_t *fs)
+{
+    MDS_FileSystem_t **bucket = &(g_fsHash[MDS_FsHashIndex(MDS_FsPathHash(fs->path, strlen(fs->path)))]);
+
+    fs->hash = *bucket;
+    *bucket = fs;
+}
+
+static void MDS_FileSystemHashRemove(MDS_FileSystem_t *fs)
+{
+    MDS_FileSystem_t **iter = &(g_fsHash[MDS_FsHashIndex(MDS_FsPathHash(fs->path, strlen(fs->path)))]);
+
+    while (*iter != NULL) {
+        if (*iter == fs) {
+            *iter = fs->hash;
+            break;
+        }
+        iter = &((*iter)->hash);
+    }
+    fs->hash = NULL;
+}
+#endif
+
 static MDS_FileSystem_t *MDS_FileSystemLookup(const char *abspath)
 {
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+    // mounts never nest, so probing each component prefix finds at most one mount
+    uint32_t hash = MDS_FILESYSTEM_HASH_INIT;
+
+    for (size_t len = 0;; len++) {
+        if ((len > 0) && ((abspath[len] == '/') || (abspath[len] == '\0'))) {
+            for (MDS_FileSystem_t *iter = g_fsHash[MDS_FsHashIndex(hash)]; iter != NULL; iter = iter->hash) {
+                if ((strncmp(iter->path, abspath, len) == 0) && (iter->path[len] == '\0')) {
+                    return (iter);
+                }
+            }
+        }
+        if (abspath[len] == '\0') {
+            break;
+        }
+        hash = (hash ^ (uint8_t)abspath[len]) * MDS_FILESYSTEM_HASH_PRIME;
+    }
+
+    return (NULL);
+#else
     MDS_FileSystem_t *iter = NULL;
     MDS_LIST_FOREACH_NEXT (iter, node, &g_fsList) {
         size_t plen = strlen(iter->path);
@@ -165,6 +287,55 @@ static MDS_FileSystem_t *MDS_FileSystemLookup(const char *abspath)
     }
 
     return (NULL);
+#endif
+}
+
+static MDS_FileSystem_t *MDS_FileSystemResolve(char *buff, size_t size, const char *path, char **abspath)
+{
+    MDS_FileSystem_t *fs = NULL;
+
+#if (defined(MDS_FILESYSTEM_PATH_CACHE) && (MDS_FILESYSTEM_PATH_CACHE > 0))
+    size_t plen = strlen(path);
+    uint32_t hash = MDS_FsPathHash(path, plen);
+
+    MDS_FsLock();
+    for (size_t idx = 0; (idx < ARRAY_SIZE(g_fsPathCache)) && (size >= MDS_FILESYSTEM_PATH_SIZE); idx++) {
+        MDS_FsPathEntry_t *entry = &(g_fsPathCache[idx]);
+        if ((entry->fs != NULL) && (entry->hash == hash) && (strcmp(entry->path, path) == 0)) {
+            MDS_MemBuffCopy(buff, size, entry->abspath, strlen(entry->abspath) + 1);
+            fs = entry->fs;
+            break;
+        }
+    }
+    MDS_FsUnlock();
+
+    if (fs != NULL) {
+        *abspath = buff;
+        return (fs);
+    }
+#endif
+
+    *abspath = MDS_FsPathAcquire(buff, size, path);
+    if (*abspath == NULL) {
+        return (NULL);
+    }
+
+    MDS_FsLock();
+    fs = MDS_FileSystemLookup(*abspath);
+#if (defined(MDS_FILESYSTEM_PATH_CACHE) && (MDS_FILESYSTEM_PATH_CACHE > 0))
+    // only hits are kept, a later mount can not make an entry stale as mounts never nest
+    if ((fs != NULL) && (plen < MDS_FILESYSTEM_PATH_SIZE) && (strlen(*abspath) < MDS_FILESYSTEM_PATH_SIZE)) {
+        MDS_FsPathEntry_t *entry = &(g_fsPathCache[g_fsPathVictim]);
+        g_fsPathVictim = (g_fsPathVictim + 1) % ARRAY_SIZE(g_fsPathCache);
+        MDS_MemBuffCopy(entry->path, sizeof(entry->path), path, plen + 1);
+        MDS_MemBuffCopy(entry->abspath, sizeof(entry->abspath), *abspath, strlen(*abspath) + 1);
+        entry->hash = hash;
+        entry->fs = fs;
+    }
+#endif
+    MDS_FsUnlock();
+
+    return (fs);
 }
 
 static const MDS_FileSystem_t *MDS_FileSystemMountDevice(MDS_FsDevice_t *device)
@@ -272,6 +443,9 @@ MDS_Err_t MDS_FileSystemMount(const MDS_FsDevice_t *device, const char *path, co
 
         if (err == MDS_EOK) {
             MDS_ListInsertNodePrev(&g_fsList, &(fs->node));
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+            MDS_FileSystemHashInsert(fs);
+#endif
         } else {
             MDS_FsFree(fs);
         }
@@ -291,7 +465,8 @@ MDS_Err_t MDS_FileSystemUnmount(const char *path)
 
     MDS_Err_t err = MDS_EOK;
 
-    char *abspath = MDS_FileSystemJoinPath(NULL, path);
+    char buff[MDS_FILESYSTEM_PATH_SIZE];
+    char *abspath = MDS_FsPathAcquire(buff, sizeof(buff), path);
     if (abspath == NULL) {
         return (MDS_EINVAL);
     }
@@ -321,13 +496,23 @@ MDS_Err_t MDS_FileSystemUnmount(const char *path)
         }
 
         MDS_ListRemoveNode(&(fs->node));
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+        MDS_FileSystemHashRemove(fs);
+#endif
+#if (defined(MDS_FILESYSTEM_PATH_CACHE) && (MDS_FILESYSTEM_PATH_CACHE > 0))
+        for (size_t idx = 0; idx < ARRAY_SIZE(g_fsPathCache); idx++) {
+            if (g_fsPathCache[idx].fs == fs) {
+                g_fsPathCache[idx].fs = NULL;
+            }
+        }
+#endif
         MDS_MutexDeInit(&(fs->lock));
         MDS_FsFree(fs->path);
         MDS_FsFree(fs);
     } while (0);
     MDS_FsUnlock();
 
-    MDS_FsFree(abspath);
+    MDS_FsPathRelease(buff, abspath);
 
     return (err);
 }
@@ -336,30 +521,60 @@ MDS_Err_t MDS_FileSystemStatfs(const char *path, MDS_FsStat_t *statfs)
 {
     MDS_Err_t err = MDS_EIO;
 
-    MDS_FsLock();
-    MDS_FileSystem_t *fs = MDS_FileSystemLookup(path);
-    MDS_FsUnlock();
+    char buff[MDS_FILESYSTEM_PATH_SIZE];
+    char *abspath = NULL;
+    MDS_FileSystem_t *fs = MDS_FileSystemResolve(buff, sizeof(buff), path, &abspath);
 
     if ((fs != NULL) && (fs->ops != NULL) && (fs->ops->statfs != NULL)) {
         err = fs->ops->statfs(fs, statfs);
     }
 
+    MDS_FsPathRelease(buff, abspath);
+
     return (err);
 }
 
 /* File -------------------------------------------------------------------- */
 static MDS_FileNode_t *MDS_FileNodeLookup(MDS_FileSystem_t *fs, const char *path)
 {
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+    MDS_FileNode_t *iter = fs->nodeHash[MDS_FsHashIndex(MDS_FsPathHash(path, strlen(path)))];
+    for (; iter != NULL; iter = iter->hash) {
+        if (strcmp(iter->path, path) == 0) {
+            return (iter);
+        }
+    }
+#else
     MDS_FileNode_t *iter = NULL;
     MDS_LIST_FOREACH_NEXT (iter, node, &(fs->list)) {
         if (strcmp(iter->path, path) == 0) {
             return (iter);
         }
     }
+#endif
 
     return (NULL);
 }
 
+static void MDS_FileNodeDestroy(MDS_FileNode_t *fnode)
+{
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+    MDS_FileNode_t **iter = &(fnode->fs->nodeHash[MDS_FsHashIndex(MDS_FsPathHash(fnode->path, strlen(fnode->path)))]);
+
+    while (*iter != NULL) {
+        if (*iter == fnode) {
+            *iter = fnode->hash;
+            break;
+        }
+        iter = &((*iter)->hash);
+    }
+#endif
+
+    MDS_ListRemoveNode(&(fnode->node));
+    MDS_FsFree(fnode->path);
+    MDS_FsFree(fnode);
+}
+
 MDS_FileNode_t *MDS_FileNodeCreate(MDS_FileSystem_t *fs, const char *abspath)
 {
     MDS_FileNode_t *fnode = MDS_FsCalloc(1, sizeof(MDS_FileNode_t));
@@ -371,6 +586,11 @@ MDS_FileNode_t *MDS_FileNodeCreate(MDS_FileSystem_t *fs, const char *abspath)
         } else {
             MDS_ListInitNode(&(fnode->node));
             MDS_ListInsertNodePrev(&(fs->list), &(fnode->node));
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+            size_t idx = MDS_FsHashIndex(MDS_FsPathHash(fnode->path, strlen(fnode->path)));
+            fnode->hash = fs->nodeHash[idx];
+            fs->nodeHash[idx] = fnode;
+#endif
             fnode->refCount = 1;
             fnode->fs = fs;
         }
@@ -385,22 +605,21 @@ MDS_Err_t MDS_FileOpen(MDS_FileDesc_t *fd, const char *path, MDS_Mask_t flags)
 
     MDS_Err_t err = MDS_EOK;
 
-    char *abspath = MDS_FileSystemJoinPath(NULL, path);
+    char buff[MDS_FILESYSTEM_PATH_SIZE];
+    char *abspath = NULL;
+    MDS_FileSystem_t *fs = MDS_FileSystemResolve(buff, sizeof(buff), path, &abspath);
     if (abspath == NULL) {
         return (MDS_EINVAL);
     }
 
-    MDS_FsLock();
-    MDS_FileSystem_t *fs = MDS_FileSystemLookup(abspath);
-    MDS_FsUnlock();
     if ((fs == NULL) || (fs->ops == NULL) || (fs->ops->open == NULL)) {
-        MDS_FsFree(abspath);
+        MDS_FsPathRelease(buff, abspath);
         return (MDS_ENOENT);
     }
 
     MDS_MutexAcquire(&(fs->lock), MDS_TICK_FOREVER);
     do {
-        MDS_FileNode_t *fnode = MDS_FileNodeLookup(fs, abspath);
+        MDS_FileNode_t *fnode = MDS_FileNodeLookup(fs, &(abspath[strlen(fs->path)]));
         if (fnode != NULL) {
             fnode->refCount += 1;
         } else {
@@ -419,9 +638,7 @@ MDS_Err_t MDS_FileOpen(MDS_FileDesc_t *fd, const char *path, MDS_Mask_t flags)
         if (err != MDS_EOK) {
             fnode->refCount -= 1;
             if (fnode->refCount == 0) {
-                MDS_ListRemoveNode(&(fnode->node));
-                MDS_FsFree(fnode->path);
-                MDS_FsFree(fnode);
+                MDS_FileNodeDestroy(fnode);
             }
             fd->node = NULL;
             fd->pos = 0;
@@ -430,7 +647,7 @@ MDS_Err_t MDS_FileOpen(MDS_FileDesc_t *fd, const char *path, MDS_Mask_t flags)
     } while (0);
     MDS_MutexRelease(&(fs->lock));
 
-    MDS_FsFree(abspath);
+    MDS_FsPathRelease(buff, abspath);
 
     return (err);
 }
@@ -459,13 +676,11 @@ MDS_Err_t MDS_FileClose(MDS_FileDesc_t *fd)
         fd->flags = MDS_FFLAG_NONE;
 
         fnode->refCount -= 1;
-        if (fnode->refCount <= 0) {
+        if (fnode->refCount < 0) {
             err = MDS_ERANGE;
         }
-        if (fnode->refCount <= 1) {
-            MDS_ListRemoveNode(&(fnode->node));
-            MDS_FsFree(fnode->path);
-            MDS_FsFree(fnode);
+        if (fnode->refCount <= 0) {
+            MDS_FileNodeDestroy(fnode);
         }
     } while (0);
     MDS_MutexRelease(&(fs->lock));
@@ -598,15 +813,14 @@ MDS_Err_t MDS_FileUnlink(const char *path)
 
     MDS_Err_t err = MDS_EOK;
 
-    char *abspath = MDS_FileSystemJoinPath(NULL, path);
+    char buff[MDS_FILESYSTEM_PATH_SIZE];
+    char *abspath = NULL;
+    MDS_FileSystem_t *fs = MDS_FileSystemResolve(buff, sizeof(buff), path, &abspath);
     if (abspath == NULL) {
         return (MDS_EINVAL);
     }
 
     do {
-        MDS_FsLock();
-        MDS_FileSystem_t *fs = MDS_FileSystemLookup(abspath);
-        MDS_FsUnlock();
         if (fs == NULL) {
             err = MDS_ENOENT;
             break;
@@ -629,7 +843,7 @@ MDS_Err_t MDS_FileUnlink(const char *path)
         err = fs->ops->unlink(fs, fspath);
     } while (0);
 
-    MDS_FsFree(abspath);
+    MDS_FsPathRelease(buff, abspath);
 
     return (err);
 }
@@ -641,26 +855,29 @@ MDS_Err_t MDS_FileRename(const char *oldpath, const char *newpath)
 
     MDS_Err_t err = MDS_EOK;
 
+    char oldbuff[MDS_FILESYSTEM_PATH_SIZE];
+    char newbuff[MDS_FILESYSTEM_PATH_SIZE];
     char *oldabspath = NULL;
     char *newabspath = NULL;
 
     do {
-        oldabspath = MDS_FileSystemJoinPath(NULL, oldpath);
+        MDS_FileSystem_t *oldfs = MDS_FileSystemResolve(oldbuff, sizeof(oldbuff), oldpath, &oldabspath);
         if (oldabspath == NULL) {
             err = MDS_EINVAL;
             break;
         }
 
-        newabspath = MDS_FileSystemJoinPath(NULL, newpath);
+        MDS_FileSystem_t *newfs = MDS_FileSystemResolve(newbuff, sizeof(newbuff), newpath, &newabspath);
         if (newabspath == NULL) {
             err = MDS_EINVAL;
             break;
         }
 
-        MDS_FsLock();
-        MDS_FileSystem_t *oldfs = MDS_FileSystemLookup(oldabspath);
-        MDS_FileSystem_t *newfs = MDS_FileSystemLookup(newabspath);
-        MDS_FsUnlock();
+        if (oldfs == NULL) {
+            err = MDS_ENOENT;
+            break;
+        }
+
         if (oldfs != newfs) {
             err = MDS_EFAULT;
             break;
@@ -684,12 +901,8 @@ MDS_Err_t MDS_FileRename(const char *oldpath, const char *newpath)
         err = oldfs->ops->rename(oldfs, oldfspath, newfspath);
     } while (0);
 
-    if (oldabspath != NULL) {
-        MDS_FsFree(oldabspath);
-    }
-    if (newabspath != NULL) {
-        MDS_FsFree(newabspath);
-    }
+    MDS_FsPathRelease(oldbuff, oldabspath);
+    MDS_FsPathRelease(newbuff, newabspath);
 
     return (err);
 }
@@ -700,15 +913,14 @@ MDS_Err_t MDS_FileStat(const char *path, MDS_FileStat_t *stat)
 
     MDS_Err_t err = MDS_EOK;
 
-    char *abspath = MDS_FileSystemJoinPath(NULL, path);
+    char buff[MDS_FILESYSTEM_PATH_SIZE];
+    char *abspath = NULL;
+    MDS_FileSystem_t *fs = MDS_FileSystemResolve(buff, sizeof(buff), path, &abspath);
     if (abspath == NULL) {
         return (MDS_EINVAL);
     }
 
     do {
-        MDS_FsLock();
-        MDS_FileSystem_t *fs = MDS_FileSystemLookup(abspath);
-        MDS_FsUnlock();
         if (fs == NULL) {
             err = MDS_ENOENT;
             break;
@@ -723,7 +935,7 @@ MDS_Err_t MDS_FileStat(const char *path, MDS_FileStat_t *stat)
         err = fs->ops->stat(fs, fspath, stat);
     } while (0);
 
-    MDS_FsFree(abspath);
+    MDS_FsPathRelease(buff, abspath);
 
     return (err);
 }
@@ -56,6 +56,7 @@ enum MDS_FileFlag {
 typedef MDS_Arg_t MDS_FsDevice_t;
 typedef struct MDS_FileSystem MDS_FileSystem_t;
 typedef struct MDS_FileDesc MDS_FileDesc_t;
+typedef struct MDS_FileNode MDS_FileNode_t;
 
 typedef struct MDS_FileStat {
     void *st_dev;
@@ -115,28 +116,36 @@ typedef struct MDS_FileSystemOps {
 
 #define MDS_FILE_SYSTEM_SECTION ".mds.fs."
 #define MDS_FILE_SYSTEM_EXPORT(name, ops)                                                                              \
-    __attribute__((section(MDS_FILE_SYSTEM_SECTION #name))) static const MDS_FileSystemOps_t *G_FS_OPS_##name = &(ops);
+    static const __attribute__((used, section(MDS_FILE_SYSTEM_SECTION #name)))                                         \
+        MDS_FileSystemOps_t *G_FS_OPS_##name = &(ops);
 
 struct MDS_FileSystem {
     MDS_Mutex_t lock;
     MDS_ListNode_t list;
     MDS_ListNode_t node;
     char *path;
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+    MDS_FileSystem_t *hash;
+    MDS_FileNode_t *nodeHash[MDS_FILESYSTEM_HASH_SIZE];
+#endif
 
     const MDS_FsDevice_t *device;
     const MDS_FileSystemOps_t *ops;
     MDS_Arg_t *data;
 };
 
-typedef struct MDS_FileNode {
+struct MDS_FileNode {
     MDS_ListNode_t node;
     char *path;
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+    MDS_FileNode_t *hash;
+#endif
 
     int32_t refCount;
 
     MDS_FileSystem_t *fs;
     MDS_Arg_t *data;
-} MDS_FileNode_t;
+};
 
 struct MDS_FileDesc {
     MDS_FileNode_t *node;
@@ -147,6 +156,7 @@ struct MDS_FileDesc {
 
 /* Function ---------------------------------------------------------------- */
 extern char *MDS_FileSystemJoinPath(const char *dirpath, const char *filepath);
+extern char *MDS_FileSystemNormalizePath(char *buff, size_t size, const char *dirpath, const char *filepath);
 
 extern MDS_Err_t MDS_FileSystemMkfs(MDS_FsDevice_t *device, const char *fsName);
 extern MDS_Err_t MDS_FileSystemMount(const MDS_FsDevice_t *device, const char *path, const char *fsName,
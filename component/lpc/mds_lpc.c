@@ -191,7 +191,7 @@ static void LPC_RunModeSwitch(MDS_LPC_Manager_t *mgr)
 void MDS_KernelIdleLowPowerControl(void)
 {
     if (g_lpcMgr.ops == NULL) {
-        MDS_CoreIdleSleep();
+        MDS_KernelIdleSleep();
         return;
     }
 
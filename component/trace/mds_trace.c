@@ -0,0 +1,353 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_trace.h"
+
+/* Define ------------------------------------------------------------------ */
+#if ((MDS_TRACE_EVENT_NUMS & (MDS_TRACE_EVENT_NUMS - 1)) != 0) || (MDS_TRACE_EVENT_NUMS > 0x8000)
+#error "MDS_TRACE_EVENT_NUMS must be a power of 2 and not larger than 32768"
+#endif
+
+/* already registered by an earlier init counts as registered */
+#define TRACE_HOOK_REGISTER(err, type, hook)                                                                           \
+    do {                                                                                                               \
+        if ((err) == MDS_EOK) {                                                                                        \
+            (err) = MDS_HOOK_REGISTER(type, hook);                                                                     \
+            (err) = ((err) == MDS_EEXIST) ? (MDS_EOK) : (err);                                                         \
+        }                                                                                                              \
+    } while (0)
+
+/* Variable ---------------------------------------------------------------- */
+MDS_TRACE_Buffer_t g_traceBuffer = {
+    .magic = MDS_TRACE_MAGIC,
+    .version = MDS_TRACE_VERSION,
+    .eventSize = sizeof(MDS_TRACE_Event_t),
+    .eventNums = MDS_TRACE_EVENT_NUMS,
+};
+
+/* Function ---------------------------------------------------------------- */
+/* the stamp is taken together with the slot, so an event that preempts the writer can not get an older stamp */
+static uint32_t TRACE_Reserve(uint32_t *stamp)
+{
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+    uint32_t seq = __atomic_load_n(&(g_traceBuffer.index), __ATOMIC_RELAXED);
+    do {
+        *stamp = (uint32_t)MDS_CoreCycleCount();
+    } while (!__atomic_compare_exchange_n(&(g_traceBuffer.index), &seq, seq + 1U, true, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED));
+
+    return (seq);
+#else
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    uint32_t seq = g_traceBuffer.index++;
+    *stamp = (uint32_t)MDS_CoreCycleCount();
+    MDS_CoreInterruptRestore(lock);
+
+    return (seq);
+#endif
+}
+
+static void TRACE_Write(uint8_t type, uint8_t ctx, uintptr_t obj, uintptr_t arg)
+{
+    uint32_t stamp = 0;
+    uint32_t seq = TRACE_Reserve(&stamp);
+    MDS_TRACE_Event_t *event = &(g_traceBuffer.events[seq & (MDS_TRACE_EVENT_NUMS - 1U)]);
+
+    event->stamp = stamp;
+    event->type = type;
+    event->ctx = ctx;
+    event->obj = obj;
+    event->arg = arg;
+    __atomic_store_n(&(event->seq), (uint16_t)seq, __ATOMIC_RELEASE);
+}
+
+static void TRACE_WriteName(uintptr_t obj, const char *name)
+{
+    for (size_t ofs = 0; ofs < MDS_OBJECT_NAME_SIZE; ofs += sizeof(uint32_t)) {
+        uint32_t chars = 0;
+        size_t idx = 0;
+
+        for (; (idx < sizeof(uint32_t)) && ((ofs + idx) < MDS_OBJECT_NAME_SIZE); idx++) {
+            if (name[ofs + idx] == '\0') {
+                break;
+            }
+            chars |= (uint32_t)((uint8_t)name[ofs + idx]) << (idx * 8U);
+        }
+        TRACE_Write(MDS_TRACE_TYPE_NAME, (uint8_t)ofs, obj, chars);
+        if (idx < sizeof(uint32_t)) {
+            break;
+        }
+    }
+}
+
+void MDS_TRACE_Record(uint8_t type, uintptr_t obj, uintptr_t arg)
+{
+    if (g_traceBuffer.enable != 0U) {
+        TRACE_Write(type, (MDS_CoreInterruptCurrent() != 0) ? (1U) : (0U), obj, arg);
+    }
+}
+
+#if (defined(MDS_HOOK_ENABLE) && (MDS_HOOK_ENABLE > 0))
+static void hookSchedulerSwitch(MDS_Thread_t *toThread, MDS_Thread_t *fromThread)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_THREAD_SWITCH, (uintptr_t)toThread, (uintptr_t)fromThread);
+}
+
+static void hookThreadInit(MDS_Thread_t *thread)
+{
+    if (g_traceBuffer.enable != 0U) {
+        TRACE_WriteName((uintptr_t)thread, thread->object.name);
+    }
+    MDS_TRACE_Record(MDS_TRACE_TYPE_THREAD_INIT, (uintptr_t)thread, thread->currPrio);
+}
+
+static void hookThreadExit(MDS_Thread_t *thread)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_THREAD_EXIT, (uintptr_t)thread, 0);
+}
+
+static void hookThreadResume(MDS_Thread_t *thread)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_THREAD_RESUME, (uintptr_t)thread, 0);
+}
+
+static void hookThreadSuspend(MDS_Thread_t *thread)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_THREAD_SUSPEND, (uintptr_t)thread, 0);
+}
+
+static void hookTimerEnter(MDS_Timer_t *timer)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_TIMER_ENTER, (uintptr_t)timer, 0);
+}
+
+static void hookTimerExit(MDS_Timer_t *timer)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_TIMER_EXIT, (uintptr_t)timer, 0);
+}
+
+#if (defined(MDS_TRACE_ISR) && (MDS_TRACE_ISR > 0))
+static void hookInterruptEnter(MDS_Item_t irq)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_INTERRUPT_ENTER, irq, 0);
+}
+
+static void hookInterruptExit(MDS_Item_t irq)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_INTERRUPT_EXIT, irq, 0);
+}
+#endif
+
+#if (defined(MDS_TRACE_IPC) && (MDS_TRACE_IPC > 0))
+static void hookSemaphoreTryAcquire(MDS_Semaphore_t *semaphore, MDS_Tick_t timeout)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_SEMAPHORE_TRY_ACQUIRE, (uintptr_t)semaphore, (uint32_t)timeout);
+}
+
+static void hookSemaphoreHasAcquire(MDS_Semaphore_t *semaphore, MDS_Err_t err)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_SEMAPHORE_HAS_ACQUIRE, (uintptr_t)semaphore, (uint32_t)err);
+}
+
+static void hookSemaphoreHasRelease(MDS_Semaphore_t *semaphore)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_SEMAPHORE_HAS_RELEASE, (uintptr_t)semaphore, 0);
+}
+
+static void hookMutexTryAcquire(MDS_Mutex_t *mutex, MDS_Tick_t timeout)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_MUTEX_TRY_ACQUIRE, (uintptr_t)mutex, (uint32_t)timeout);
+}
+
+static void hookMutexHasAcquire(MDS_Mutex_t *mutex, MDS_Err_t err)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_MUTEX_HAS_ACQUIRE, (uintptr_t)mutex, (uint32_t)err);
+}
+
+static void hookMutexHasRelease(MDS_Mutex_t *mutex)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_MUTEX_HAS_RELEASE, (uintptr_t)mutex, 0);
+}
+
+static void hookEventTryAcquire(MDS_Event_t *event, MDS_Tick_t timeout)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_EVENT_TRY_ACQUIRE, (uintptr_t)event, (uint32_t)timeout);
+}
+
+static void hookEventHasAcquire(MDS_Event_t *event, MDS_Err_t err)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_EVENT_HAS_ACQUIRE, (uintptr_t)event, (uint32_t)err);
+}
+
+static void hookEventHasSet(MDS_Event_t *event, MDS_Mask_t mask)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_EVENT_HAS_SET, (uintptr_t)event, (uint32_t)mask);
+}
+
+static void hookEventHasClr(MDS_Event_t *event, MDS_Mask_t mask)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_EVENT_HAS_CLR, (uintptr_t)event, (uint32_t)mask);
+}
+
+static void hookMsgQueueTryRecv(MDS_MsgQueue_t *msgQueue, MDS_Tick_t timeout)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_MSGQUEUE_TRY_RECV, (uintptr_t)msgQueue, (uint32_t)timeout);
+}
+
+static void hookMsgQueueHasRecv(MDS_MsgQueue_t *msgQueue, MDS_Err_t err)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_MSGQUEUE_HAS_RECV, (uintptr_t)msgQueue, (uint32_t)err);
+}
+
+static void hookMsgQueueTrySend(MDS_MsgQueue_t *msgQueue, MDS_Tick_t timeout)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_MSGQUEUE_TRY_SEND, (uintptr_t)msgQueue, (uint32_t)timeout);
+}
+
+static void hookMsgQueueHasSend(MDS_MsgQueue_t *msgQueue, MDS_Err_t err)
+{
+    MDS_TRACE_Record(MDS_TRACE_TYPE_MSGQUEUE_HAS_SEND, (uintptr_t)msgQueue, (uint32_t)err);
+}
+#endif
+
+static void TRACE_HookUnregister(void)
+{
+    MDS_HOOK_UNREGISTER(SCHEDULER_SWITCH, hookSchedulerSwitch);
+
+    MDS_HOOK_UNREGISTER(THREAD_INIT, hookThreadInit);
+    MDS_HOOK_UNREGISTER(THREAD_EXIT, hookThreadExit);
+    MDS_HOOK_UNREGISTER(THREAD_RESUME, hookThreadResume);
+    MDS_HOOK_UNREGISTER(THREAD_SUSPEND, hookThreadSuspend);
+
+    MDS_HOOK_UNREGISTER(TIMER_ENTER, hookTimerEnter);
+    MDS_HOOK_UNREGISTER(TIMER_EXIT, hookTimerExit);
+
+#if (defined(MDS_TRACE_ISR) && (MDS_TRACE_ISR > 0))
+    MDS_HOOK_UNREGISTER(INTERRUPT_ENTER, hookInterruptEnter);
+    MDS_HOOK_UNREGISTER(INTERRUPT_EXIT, hookInterruptExit);
+#endif
+
+#if (defined(MDS_TRACE_IPC) && (MDS_TRACE_IPC > 0))
+    MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, hookSemaphoreTryAcquire);
+    MDS_HOOK_UNREGISTER(SEMAPHORE_HAS_ACQUIRE, hookSemaphoreHasAcquire);
+    MDS_HOOK_UNREGISTER(SEMAPHORE_HAS_RELEASE, hookSemaphoreHasRelease);
+
+    MDS_HOOK_UNREGISTER(MUTEX_TRY_ACQUIRE, hookMutexTryAcquire);
+    MDS_HOOK_UNREGISTER(MUTEX_HAS_ACQUIRE, hookMutexHasAcquire);
+    MDS_HOOK_UNREGISTER(MUTEX_HAS_RELEASE, hookMutexHasRelease);
+
+    MDS_HOOK_UNREGISTER(EVENT_TRY_ACQUIRE, hookEventTryAcquire);
+    MDS_HOOK_UNREGISTER(EVENT_HAS_ACQUIRE, hookEventHasAcquire);
+    MDS_HOOK_UNREGISTER(EVENT_HAS_SET, hookEventHasSet);
+    MDS_HOOK_UNREGISTER(EVENT_HAS_CLR, hookEventHasClr);
+
+    MDS_HOOK_UNREGISTER(MSGQUEUE_TRY_RECV, hookMsgQueueTryRecv);
+    MDS_HOOK_UNREGISTER(MSGQUEUE_HAS_RECV, hookMsgQueueHasRecv);
+    MDS_HOOK_UNREGISTER(MSGQUEUE_TRY_SEND, hookMsgQueueTrySend);
+    MDS_HOOK_UNREGISTER(MSGQUEUE_HAS_SEND, hookMsgQueueHasSend);
+#endif
+}
+
+static MDS_Err_t TRACE_HookRegister(void)
+{
+    MDS_Err_t err = MDS_EOK;
+
+    TRACE_HOOK_REGISTER(err, SCHEDULER_SWITCH, hookSchedulerSwitch);
+
+    TRACE_HOOK_REGISTER(err, THREAD_INIT, hookThreadInit);
+    TRACE_HOOK_REGISTER(err, THREAD_EXIT, hookThreadExit);
+    TRACE_HOOK_REGISTER(err, THREAD_RESUME, hookThreadResume);
+    TRACE_HOOK_REGISTER(err, THREAD_SUSPEND, hookThreadSuspend);
+
+    TRACE_HOOK_REGISTER(err, TIMER_ENTER, hookTimerEnter);
+    TRACE_HOOK_REGISTER(err, TIMER_EXIT, hookTimerExit);
+
+#if (defined(MDS_TRACE_ISR) && (MDS_TRACE_ISR > 0))
+    TRACE_HOOK_REGISTER(err, INTERRUPT_ENTER, hookInterruptEnter);
+    TRACE_HOOK_REGISTER(err, INTERRUPT_EXIT, hookInterruptExit);
+#endif
+
+#if (defined(MDS_TRACE_IPC) && (MDS_TRACE_IPC > 0))
+    TRACE_HOOK_REGISTER(err, SEMAPHORE_TRY_ACQUIRE, hookSemaphoreTryAcquire);
+    TRACE_HOOK_REGISTER(err, SEMAPHORE_HAS_ACQUIRE, hookSemaphoreHasAcquire);
+    TRACE_HOOK_REGISTER(err, SEMAPHORE_HAS_RELEASE, hookSemaphoreHasRelease);
+
+    TRACE_HOOK_REGISTER(err, MUTEX_TRY_ACQUIRE, hookMutexTryAcquire);
+    TRACE_HOOK_REGISTER(err, MUTEX_HAS_ACQUIRE, hookMutexHasAcquire);
+    TRACE_HOOK_REGISTER(err, MUTEX_HAS_RELEASE, hookMutexHasRelease);
+
+    TRACE_HOOK_REGISTER(err, EVENT_TRY_ACQUIRE, hookEventTryAcquire);
+    TRACE_HOOK_REGISTER(err, EVENT_HAS_ACQUIRE, hookEventHasAcquire);
+    TRACE_HOOK_REGISTER(err, EVENT_HAS_SET, hookEventHasSet);
+    TRACE_HOOK_REGISTER(err, EVENT_HAS_CLR, hookEventHasClr);
+
+    TRACE_HOOK_REGISTER(err, MSGQUEUE_TRY_RECV, hookMsgQueueTryRecv);
+    TRACE_HOOK_REGISTER(err, MSGQUEUE_HAS_RECV, hookMsgQueueHasRecv);
+    TRACE_HOOK_REGISTER(err, MSGQUEUE_TRY_SEND, hookMsgQueueTrySend);
+    TRACE_HOOK_REGISTER(err, MSGQUEUE_HAS_SEND, hookMsgQueueHasSend);
+#endif
+
+    // a partial set would record switches without the events around them, take all or none
+    if (err != MDS_EOK) {
+        TRACE_HookUnregister();
+    }
+
+    return (err);
+}
+#endif
+
+MDS_Err_t MDS_TRACE_Init(uint32_t cycleFreq)
+{
+    MDS_Err_t err = MDS_EOK;
+
+    g_traceBuffer.enable = 0U;
+    g_traceBuffer.cycleFreq = cycleFreq;
+    g_traceBuffer.index = 0U;
+
+#if (defined(MDS_HOOK_ENABLE) && (MDS_HOOK_ENABLE > 0))
+    err = TRACE_HookRegister();
+#endif
+
+    return (err);
+}
+
+static void TRACE_WriteThreadNames(void)
+{
+    const MDS_ListNode_t *list = MDS_ObjectGetList(MDS_OBJECT_TYPE_THREAD);
+    MDS_Thread_t *iter = NULL;
+
+    MDS_LIST_FOREACH_NEXT (iter, object.node, list) {
+        TRACE_WriteName((uintptr_t)iter, iter->object.name);
+    }
+}
+
+void MDS_TRACE_Start(void)
+{
+    g_traceBuffer.enable = 1U;
+
+    TRACE_WriteThreadNames();
+    MDS_TRACE_Record(MDS_TRACE_TYPE_THREAD_SWITCH, (uintptr_t)MDS_KernelCurrentThread(), 0);
+}
+
+void MDS_TRACE_Stop(void)
+{
+    if (g_traceBuffer.enable != 0U) {
+        /* names recorded at start may have been overwritten by the ring */
+        TRACE_WriteThreadNames();
+        g_traceBuffer.enable = 0U;
+    }
+}
+
+const MDS_TRACE_Buffer_t *MDS_TRACE_GetBuffer(void)
+{
+    return (&g_traceBuffer);
+}
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+#ifndef __MDS_TRACE_H__
+#define __MDS_TRACE_H__
+
+/* Include ----------------------------------------------------------------- */
+#include "mds_sys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Define ------------------------------------------------------------------ */
+#ifndef MDS_TRACE_EVENT_NUMS
+#define MDS_TRACE_EVENT_NUMS 512
+#endif
+
+#define MDS_TRACE_MAGIC   0x5453444DU /* "MDST" */
+#define MDS_TRACE_VERSION 1U
+
+/* Typedef ----------------------------------------------------------------- */
+typedef enum MDS_TRACE_Type {
+    MDS_TRACE_TYPE_NONE = 0,
+    MDS_TRACE_TYPE_NAME,
+
+    MDS_TRACE_TYPE_THREAD_SWITCH,
+    MDS_TRACE_TYPE_THREAD_INIT,
+    MDS_TRACE_TYPE_THREAD_EXIT,
+    MDS_TRACE_TYPE_THREAD_RESUME,
+    MDS_TRACE_TYPE_THREAD_SUSPEND,
+
+    MDS_TRACE_TYPE_TIMER_ENTER,
+    MDS_TRACE_TYPE_TIMER_EXIT,
+
+    MDS_TRACE_TYPE_INTERRUPT_ENTER,
+    MDS_TRACE_TYPE_INTERRUPT_EXIT,
+
+    MDS_TRACE_TYPE_SEMAPHORE_TRY_ACQUIRE,
+    MDS_TRACE_TYPE_SEMAPHORE_HAS_ACQUIRE,
+    MDS_TRACE_TYPE_SEMAPHORE_HAS_RELEASE,
+    MDS_TRACE_TYPE_MUTEX_TRY_ACQUIRE,
+    MDS_TRACE_TYPE_MUTEX_HAS_ACQUIRE,
+    MDS_TRACE_TYPE_MUTEX_HAS_RELEASE,
+    MDS_TRACE_TYPE_EVENT_TRY_ACQUIRE,
+    MDS_TRACE_TYPE_EVENT_HAS_ACQUIRE,
+    MDS_TRACE_TYPE_EVENT_HAS_SET,
+    MDS_TRACE_TYPE_EVENT_HAS_CLR,
+    MDS_TRACE_TYPE_MSGQUEUE_TRY_RECV,
+    MDS_TRACE_TYPE_MSGQUEUE_HAS_RECV,
+    MDS_TRACE_TYPE_MSGQUEUE_TRY_SEND,
+    MDS_TRACE_TYPE_MSGQUEUE_HAS_SEND,
+
+    MDS_TRACE_TYPE_USER = 0x80,
+} MDS_TRACE_Type_t;
+
+/*
+ * stamp: low 32 bits of MDS_CoreCycleCount()
+ * type:  MDS_TRACE_Type_t
+ * ctx:   1 when recorded in interrupt context, or name offset for TYPE_NAME
+ * seq:   low 16 bits of the slot sequence, written last to detect torn slots
+ * obj:   object address (thread, timer, ipc) or irq number, pointer sized so objects never alias
+ * arg:   event argument (previous thread, timeout, err, mask, name chars)
+ */
+typedef struct MDS_TRACE_Event {
+    uint32_t stamp;
+    uint8_t type;
+    uint8_t ctx;
+    uint16_t seq;
+    uintptr_t obj;
+    uintptr_t arg;
+} MDS_TRACE_Event_t;
+
+typedef struct MDS_TRACE_Buffer {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t eventSize;
+    uint32_t eventNums;
+    uint32_t cycleFreq;
+    volatile uint32_t index;
+    volatile uint32_t enable;
+    MDS_TRACE_Event_t events[MDS_TRACE_EVENT_NUMS];
+} MDS_TRACE_Buffer_t;
+
+/* Function ---------------------------------------------------------------- */
+extern MDS_Err_t MDS_TRACE_Init(uint32_t cycleFreq);
+extern void MDS_TRACE_Start(void);
+extern void MDS_TRACE_Stop(void);
+extern void MDS_TRACE_Record(uint8_t type, uintptr_t obj, uintptr_t arg);
+extern const MDS_TRACE_Buffer_t *MDS_TRACE_GetBuffer(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MDS_TRACE_H__ */
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+# Copyright (c) [2022] [pchom]
+# [MDS] is licensed under Mulan PSL v2.
+# You can use this software according to the terms and conditions of the Mulan PSL v2.
+# You may obtain a copy of Mulan PSL v2 at:
+#          http://license.coscl.org.cn/MulanPSL2
+# THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+# EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+# MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+# See the Mulan PSL v2 for more details.
+"""
+Decode a raw dump of MDS_TRACE_Buffer_t (g_traceBuffer) into Chrome trace JSON,
+which can be opened with chrome://tracing or https://ui.perfetto.dev.
+
+    (gdb) dump binary value trace.bin g_traceBuffer
+    $ python3 mds_trace_json.py trace.bin -o trace.json --elf app.elf
+
+Thread names are recorded at MDS_TRACE_Start() and MDS_TRACE_Stop(). When the dump
+is taken without stopping (e.g. after a fault) and the start names have been
+overwritten, --elf resolves thread objects from the symbol table instead.
+"""
+
+import argparse
+import json
+import struct
+import subprocess
+import sys
+
+TRACE_MAGIC = 0x5453444D
+TRACE_HEADER = "IHHIIII"
+EVENT_FORMAT = {16: "IBBHII", 24: "IBBHQQ"}
+
+TYPE_NAMES = [
+    "NONE",
+    "NAME",
+    "THREAD_SWITCH",
+    "THREAD_INIT",
+    "THREAD_EXIT",
+    "THREAD_RESUME",
+    "THREAD_SUSPEND",
+    "TIMER_ENTER",
+    "TIMER_EXIT",
+    "INTERRUPT_ENTER",
+    "INTERRUPT_EXIT",
+    "SEMAPHORE_TRY_ACQUIRE",
+    "SEMAPHORE_HAS_ACQUIRE",
+    "SEMAPHORE_HAS_RELEASE",
+    "MUTEX_TRY_ACQUIRE",
+    "MUTEX_HAS_ACQUIRE",
+    "MUTEX_HAS_RELEASE",
+    "EVENT_TRY_ACQUIRE",
+    "EVENT_HAS_ACQUIRE",
+    "EVENT_HAS_SET",
+    "EVENT_HAS_CLR",
+    "MSGQUEUE_TRY_RECV",
+    "MSGQUEUE_HAS_RECV",
+    "MSGQUEUE_TRY_SEND",
+    "MSGQUEUE_HAS_SEND",
+]
+TYPE = {name: idx for idx, name in enumerate(TYPE_NAMES)}
+TYPE_USER = 0x80
+
+PID = 1
+TID_ISR = 0
+TID_TIMER = 1
+
+
+def trace_load(data):
+    for endian in ("<", ">"):
+        header = struct.unpack_from(endian + TRACE_HEADER, data, 0)
+        if header[0] == TRACE_MAGIC:
+            break
+    else:
+        raise ValueError("bad magic, not a MDS trace dump")
+
+    _, version, eventSize, eventNums, cycleFreq, index, _ = header
+    # obj and arg are pointer sized: 16 byte events on 32-bit targets, 24 on 64-bit hosts
+    if version != 1 or eventSize not in EVENT_FORMAT:
+        raise ValueError("unsupported trace version %d event size %d" % (version, eventSize))
+
+    offset = struct.calcsize(endian + TRACE_HEADER)
+    if len(data) < offset + eventSize * eventNums:
+        raise ValueError("dump truncated, need %d bytes" % (offset + eventSize * eventNums))
+
+    events = []
+    torn = 0
+    first = max(index - eventNums, 0)
+    for seq in range(first, index):
+        slot = offset + (seq % eventNums) * eventSize
+        stamp, type, ctx, tag, obj, arg = struct.unpack_from(endian + EVENT_FORMAT[eventSize], data, slot)
+        if tag != (seq & 0xFFFF) or type == TYPE["NONE"]:
+            torn += 1
+            continue
+        events.append((stamp, type, ctx, obj, arg))
+
+    return cycleFreq, events, torn, index - first
+
+
+def elf_symbols(elf, nm):
+    symbols = {}
+    output = subprocess.run([nm, "--defined-only", elf], check=True, capture_output=True, text=True).stdout
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[1] in "bBdD":
+            symbols[int(fields[0], 16)] = fields[2]
+    return symbols
+
+
+def trace_json(cycleFreq, events, symbols=None):
+    scale = 1000000.0 / cycleFreq if cycleFreq else 1.0
+    out = []
+    names = dict(symbols or {})
+    running = None
+    stamp64 = 0
+    last = None
+
+    def usec():
+        return stamp64 * scale
+
+    def thread_name(obj):
+        return names.get(obj, "0x%08x" % obj)
+
+    for stamp, type, ctx, obj, arg in events:
+        if last is not None:
+            # signed, so a stamp slightly older than its predecessor does not read as a full counter wrap
+            delta = (stamp - last) & 0xFFFFFFFF
+            stamp64 += delta - 0x100000000 if delta & 0x80000000 else delta
+        last = stamp
+
+        if type == TYPE["NAME"]:
+            text = struct.pack("<I", arg & 0xFFFFFFFF).split(b"\0")[0].decode("ascii", "replace")
+            names[obj] = (names.get(obj, "") if ctx else "") + text
+            continue
+
+        if type == TYPE["THREAD_SWITCH"]:
+            if running is not None:
+                out.append({"ph": "E", "pid": PID, "tid": running, "ts": usec()})
+            running = obj
+            out.append({"ph": "B", "pid": PID, "tid": obj, "ts": usec(), "name": "run"})
+        elif type == TYPE["INTERRUPT_ENTER"]:
+            out.append({"ph": "B", "pid": PID, "tid": TID_ISR, "ts": usec(), "name": "irq %d" % obj})
+        elif type == TYPE["INTERRUPT_EXIT"]:
+            out.append({"ph": "E", "pid": PID, "tid": TID_ISR, "ts": usec()})
+        elif type == TYPE["TIMER_ENTER"]:
+            out.append({"ph": "B", "pid": PID, "tid": TID_TIMER, "ts": usec(), "name": "timer 0x%08x" % obj})
+        elif type == TYPE["TIMER_EXIT"]:
+            out.append({"ph": "E", "pid": PID, "tid": TID_TIMER, "ts": usec()})
+        else:
+            if type >= TYPE_USER:
+                name = "USER_%d" % (type - TYPE_USER)
+            elif type < len(TYPE_NAMES):
+                name = TYPE_NAMES[type]
+            else:
+                name = "TYPE_%d" % type
+            if type in (TYPE["THREAD_INIT"], TYPE["THREAD_EXIT"], TYPE["THREAD_RESUME"], TYPE["THREAD_SUSPEND"]):
+                tid = obj
+            elif ctx or running is None:
+                tid = TID_ISR
+            else:
+                tid = running
+            out.append({"ph": "i", "s": "t", "pid": PID, "tid": tid, "ts": usec(), "name": name,
+                        "args": {"obj": "0x%08x" % obj, "arg": arg}})
+
+    if running is not None:
+        out.append({"ph": "E", "pid": PID, "tid": running, "ts": usec()})
+
+    tids = {TID_ISR, TID_TIMER} | {evt["tid"] for evt in out}
+    meta = [{"ph": "M", "pid": PID, "name": "process_name", "args": {"name": "MDS"}}]
+    for tid in sorted(tids):
+        if tid == TID_ISR:
+            name = "ISR"
+        elif tid == TID_TIMER:
+            name = "Timer"
+        else:
+            name = thread_name(tid)
+        meta.append({"ph": "M", "pid": PID, "tid": tid, "name": "thread_name", "args": {"name": name}})
+
+    return {"traceEvents": meta + out, "displayTimeUnit": "ns"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Convert MDS trace dump to Chrome trace JSON")
+    parser.add_argument("dump", help="raw binary dump of g_traceBuffer")
+    parser.add_argument("-o", "--output", help="output json file, default stdout")
+    parser.add_argument("-f", "--freq", type=int, default=0, help="override cycle frequency in Hz")
+    parser.add_argument("-e", "--elf", help="firmware elf used to name threads by symbol")
+    parser.add_argument("--nm", default="nm", help="nm tool for --elf, e.g. arm-none-eabi-nm")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+
+    cycleFreq, events, torn, total = trace_load(data)
+    if args.freq:
+        cycleFreq = args.freq
+    if cycleFreq == 0:
+        print("warning: cycle frequency unknown, timestamps are raw cycles", file=sys.stderr)
+
+    symbols = elf_symbols(args.elf, args.nm) if args.elf else None
+    result = trace_json(cycleFreq, events, symbols)
+    print("%d events, %d torn or overwritten" % (total, torn), file=sys.stderr)
+
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f)
+    else:
+        json.dump(result, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -39,18 +39,55 @@ struct DEV_STORAGE_Adaptr {
     const MDS_Mutex_t mutex;
 };
 
+/*
+ * Optional per-periph cache, lines and their buffers are provided by the caller.
+ * Reads fill lines, programs smaller than a line are merged into one write-back line
+ * (read-modify-write) which reaches the device on the next unrelated access, DEV_STORAGE_PeriphSync()
+ * or DEV_STORAGE_PeriphClose().
+ * Cached lines take the programmed data as is, so programs are expected to target erased space.
+ */
+typedef struct DEV_STORAGE_CacheLine {
+    MDS_ListNode_t node;
+    size_t block;
+    uintptr_t ofs;
+    size_t size;  // 0 when the line holds nothing
+    uint8_t *buff;
+} DEV_STORAGE_CacheLine_t;
+
+typedef struct DEV_STORAGE_Cache {
+    MDS_ListNode_t list;  // most recently used first
+    DEV_STORAGE_CacheLine_t *dirty;
+    size_t dirtyS;
+    size_t dirtyE;
+    size_t lineSize;
+    bool writeBack;
+
+    size_t hitCount;
+    size_t missCount;
+    size_t flushCount;
+} DEV_STORAGE_Cache_t;
+
 typedef struct DEV_STORAGE_Object {
     MDS_Tick_t timeout;
     size_t blockBase;
     size_t blockNums;
     size_t totalSize;
+    size_t blockSize;  // set along with totalSize, 0 when the block sizes differ
 } DEV_STORAGE_Object_t;
 
+typedef struct DEV_STORAGE_Vector {
+    size_t block;
+    uintptr_t ofs;
+    uint8_t *buff;
+    size_t len;
+} DEV_STORAGE_Vector_t;
+
 struct DEV_STORAGE_Periph {
     const MDS_Device_t device;
     const DEV_STORAGE_Adaptr_t *mount;
 
     DEV_STORAGE_Object_t object;
+    DEV_STORAGE_Cache_t *cache;
 };
 
 /* Function ---------------------------------------------------------------- */
@@ -74,9 +111,20 @@ extern size_t DEV_STORAGE_PeriphBlockSize(DEV_STORAGE_Periph_t *periph, size_t b
 extern size_t DEV_STORAGE_PeriphTotalSize(DEV_STORAGE_Periph_t *periph);
 extern MDS_Err_t DEV_STORAGE_PeriphRead(DEV_STORAGE_Periph_t *periph, size_t block, uintptr_t ofs, uint8_t *buff,
                                         size_t len);
+/* flushes the write-back line and reads the device itself, e.g. to verify a program */
+extern MDS_Err_t DEV_STORAGE_PeriphReadThrough(DEV_STORAGE_Periph_t *periph, size_t block, uintptr_t ofs,
+                                               uint8_t *buff, size_t len);
 extern MDS_Err_t DEV_STORAGE_PeriphProgram(DEV_STORAGE_Periph_t *periph, size_t block, uintptr_t ofs,
                                            const uint8_t *buff, size_t len);
 extern MDS_Err_t DEV_STORAGE_PeriphErase(DEV_STORAGE_Periph_t *periph, size_t block, size_t nums);
+extern MDS_Err_t DEV_STORAGE_PeriphReadv(DEV_STORAGE_Periph_t *periph, const DEV_STORAGE_Vector_t *vec, size_t cnt);
+extern MDS_Err_t DEV_STORAGE_PeriphProgramv(DEV_STORAGE_Periph_t *periph, const DEV_STORAGE_Vector_t *vec, size_t cnt);
+extern MDS_Err_t DEV_STORAGE_PeriphMediaChanged(DEV_STORAGE_Periph_t *periph);
+extern MDS_Err_t DEV_STORAGE_PeriphSync(DEV_STORAGE_Periph_t *periph);
+extern MDS_Err_t DEV_STORAGE_PeriphCache(DEV_STORAGE_Periph_t *periph, DEV_STORAGE_Cache_t *cache);
+
+extern MDS_Err_t DEV_STORAGE_CacheInit(DEV_STORAGE_Cache_t *cache, DEV_STORAGE_CacheLine_t *line, size_t nums,
+                                       uint8_t *buff, size_t lineSize, bool writeBack);
 
 #ifdef __cplusplus
 }
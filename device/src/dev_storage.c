@@ -36,12 +36,323 @@ MDS_Err_t DEV_STORAGE_AdaptrDestroy(DEV_STORAGE_Adaptr_t *storage)
     return (MDS_DevAdaptrDestroy((MDS_DevAdaptr_t *)storage));
 }
 
+/* Storage cache ----------------------------------------------------------- */
+MDS_Err_t DEV_STORAGE_CacheInit(DEV_STORAGE_Cache_t *cache, DEV_STORAGE_CacheLine_t *line, size_t nums,
+                                uint8_t *buff, size_t lineSize, bool writeBack)
+{
+    MDS_ASSERT(cache != NULL);
+    MDS_ASSERT(line != NULL);
+    MDS_ASSERT(buff != NULL);
+
+    if ((nums == 0) || (lineSize == 0)) {
+        return (MDS_EINVAL);
+    }
+
+    MDS_MemBuffSet(cache, 0, sizeof(DEV_STORAGE_Cache_t));
+    MDS_ListInitNode(&(cache->list));
+    cache->lineSize = lineSize;
+    cache->writeBack = writeBack;
+
+    for (size_t idx = 0; idx < nums; idx++) {
+        line[idx].size = 0;
+        line[idx].buff = buff + (idx * lineSize);
+        MDS_ListInsertNodePrev(&(cache->list), &(line[idx].node));
+    }
+
+    return (MDS_EOK);
+}
+
+static void STORAGE_CacheTouch(DEV_STORAGE_Cache_t *cache, DEV_STORAGE_CacheLine_t *line)
+{
+    MDS_ListRemoveNode(&(line->node));
+    MDS_ListInsertNodeNext(&(cache->list), &(line->node));
+}
+
+static void STORAGE_CacheInvalid(DEV_STORAGE_Cache_t *cache, DEV_STORAGE_CacheLine_t *line)
+{
+    // empty lines are kept at the tail so lookups stop at the first one
+    if (cache->dirty == line) {
+        cache->dirty = NULL;
+    }
+    line->size = 0;
+    MDS_ListRemoveNode(&(line->node));
+    MDS_ListInsertNodePrev(&(cache->list), &(line->node));
+}
+
+static void STORAGE_CacheClear(DEV_STORAGE_Cache_t *cache)
+{
+    DEV_STORAGE_CacheLine_t *line = NULL;
+
+    cache->dirty = NULL;
+    MDS_LIST_FOREACH_NEXT (line, node, &(cache->list)) {
+        line->size = 0;
+    }
+}
+
+static DEV_STORAGE_CacheLine_t *STORAGE_CacheFind(DEV_STORAGE_Cache_t *cache, size_t block, uintptr_t ofs)
+{
+    DEV_STORAGE_CacheLine_t *line = NULL;
+
+    MDS_LIST_FOREACH_NEXT (line, node, &(cache->list)) {
+        if (line->size == 0) {
+            break;
+        }
+        if ((line->block == block) && (line->ofs == ofs)) {
+            return (line);
+        }
+    }
+
+    return (NULL);
+}
+
+static size_t STORAGE_CacheLocate(DEV_STORAGE_Periph_t *periph, size_t *block, uintptr_t *ofs)
+{
+    // callers may address past the end of a block, lines are keyed by the block that holds the byte
+    size_t size = (*block < periph->object.blockNums) ? (DEV_STORAGE_PeriphBlockSize(periph, *block)) : (0);
+
+    while ((size > 0) && (*ofs >= size)) {
+        *ofs -= size;
+        *block += 1;
+        size = (*block < periph->object.blockNums) ? (DEV_STORAGE_PeriphBlockSize(periph, *block)) : (0);
+    }
+
+    return (size);
+}
+
+static MDS_Err_t STORAGE_CacheFlush(DEV_STORAGE_Periph_t *periph)
+{
+    DEV_STORAGE_Cache_t *cache = periph->cache;
+    DEV_STORAGE_CacheLine_t *line = cache->dirty;
+
+    if (line == NULL) {
+        return (MDS_EOK);
+    }
+
+    cache->dirty = NULL;
+    cache->flushCount += 1;
+
+    MDS_Err_t err = periph->mount->driver->prog(periph, periph->object.blockBase + line->block,
+                                                line->ofs + cache->dirtyS, line->buff + cache->dirtyS,
+                                                cache->dirtyE - cache->dirtyS);
+    if (err != MDS_EOK) {
+        STORAGE_CacheInvalid(cache, line);
+    }
+
+    return (err);
+}
+
+static MDS_Err_t STORAGE_CacheLoad(DEV_STORAGE_Periph_t *periph, DEV_STORAGE_CacheLine_t **line, size_t block,
+                                   uintptr_t ofs, size_t size)
+{
+    DEV_STORAGE_Cache_t *cache = periph->cache;
+
+    *line = CONTAINER_OF(cache->list.prev, DEV_STORAGE_CacheLine_t, node);
+    if (*line == cache->dirty) {
+        MDS_Err_t err = STORAGE_CacheFlush(periph);
+        if (err != MDS_EOK) {
+            return (err);
+        }
+    }
+
+    MDS_Err_t err = periph->mount->driver->read(periph, periph->object.blockBase + block, ofs, (*line)->buff, size);
+    if (err != MDS_EOK) {
+        STORAGE_CacheInvalid(cache, *line);
+        return (err);
+    }
+
+    (*line)->block = block;
+    (*line)->ofs = ofs;
+    (*line)->size = size;
+    STORAGE_CacheTouch(cache, *line);
+
+    return (MDS_EOK);
+}
+
+static void STORAGE_CacheUpdate(DEV_STORAGE_Cache_t *cache, size_t block, uintptr_t ofs, const uint8_t *buff,
+                                size_t len, bool valid)
+{
+    DEV_STORAGE_CacheLine_t *line = NULL;
+    DEV_STORAGE_CacheLine_t *next = NULL;
+
+    for (line = CONTAINER_OF(cache->list.next, DEV_STORAGE_CacheLine_t, node); &(line->node) != &(cache->list);
+         line = next) {
+        next = CONTAINER_OF(line->node.next, DEV_STORAGE_CacheLine_t, node);
+        if (line->size == 0) {
+            break;
+        }
+        if ((line->block != block) || (line->ofs >= (ofs + len)) || ((line->ofs + line->size) <= ofs)) {
+            continue;
+        }
+        if (!valid) {
+            STORAGE_CacheInvalid(cache, line);
+            continue;
+        }
+
+        uintptr_t start = (line->ofs > ofs) ? (line->ofs) : (ofs);
+        uintptr_t end = ((line->ofs + line->size) < (ofs + len)) ? (line->ofs + line->size) : (ofs + len);
+        MDS_MemBuffCopy(line->buff + (start - line->ofs), end - start, buff + (start - ofs), end - start);
+    }
+}
+
+static size_t STORAGE_CacheRun(const DEV_STORAGE_Cache_t *cache, size_t blkSize, uintptr_t ofs, size_t len)
+{
+    size_t size = ((blkSize - ofs) < len) ? (blkSize - ofs) : (len);
+
+    return ((size < (blkSize - ofs)) ? (size - (size % cache->lineSize)) : (size));
+}
+
+static MDS_Err_t STORAGE_CacheRead(DEV_STORAGE_Periph_t *periph, size_t block, uintptr_t ofs, uint8_t *buff,
+                                   size_t len)
+{
+    DEV_STORAGE_Cache_t *cache = periph->cache;
+    MDS_Err_t err = MDS_EOK;
+
+    for (size_t size; (err == MDS_EOK) && (len > 0); buff += size, ofs += size, len -= size) {
+        size_t blkSize = STORAGE_CacheLocate(periph, &block, &ofs);
+        if (blkSize == 0) {
+            return (MDS_EINVAL);
+        }
+
+        uintptr_t lineOfs = ofs - (ofs % cache->lineSize);
+        size_t lineLen = ((blkSize - lineOfs) < cache->lineSize) ? (blkSize - lineOfs) : (cache->lineSize);
+        size = ((lineOfs + lineLen - ofs) < len) ? (lineOfs + lineLen - ofs) : (len);
+
+        DEV_STORAGE_CacheLine_t *line = STORAGE_CacheFind(cache, block, lineOfs);
+        if (line != NULL) {
+            cache->hitCount += 1;
+            STORAGE_CacheTouch(cache, line);
+        } else if ((ofs == lineOfs) && (len >= lineLen)) {
+            // whole lines stream past the cache, only the write-back line can be newer than the device
+            cache->missCount += 1;
+            size = STORAGE_CacheRun(cache, blkSize, ofs, len);
+            err = periph->mount->driver->read(periph, periph->object.blockBase + block, ofs, buff, size);
+            if ((err == MDS_EOK) && (cache->dirty != NULL) && (cache->dirty->block == block)) {
+                uintptr_t dirtyOfs = cache->dirty->ofs + cache->dirtyS;
+                uintptr_t start = (dirtyOfs > ofs) ? (dirtyOfs) : (ofs);
+                uintptr_t end = ((cache->dirty->ofs + cache->dirtyE) < (ofs + size))
+                                    ? (cache->dirty->ofs + cache->dirtyE)
+                                    : (ofs + size);
+                if (start < end) {
+                    MDS_MemBuffCopy(buff + (start - ofs), end - start, cache->dirty->buff + (start - cache->dirty->ofs),
+                                    end - start);
+                }
+            }
+            continue;
+        } else {
+            cache->missCount += 1;
+            err = STORAGE_CacheLoad(periph, &line, block, lineOfs, lineLen);
+            if (err != MDS_EOK) {
+                break;
+            }
+        }
+
+        MDS_MemBuffCopy(buff, size, line->buff + (ofs - lineOfs), size);
+    }
+
+    return (err);
+}
+
+static MDS_Err_t STORAGE_CacheProgram(DEV_STORAGE_Periph_t *periph, size_t block, uintptr_t ofs, const uint8_t *buff,
+                                      size_t len)
+{
+    DEV_STORAGE_Cache_t *cache = periph->cache;
+    MDS_Err_t err = MDS_EOK;
+
+    for (size_t size; (err == MDS_EOK) && (len > 0); buff += size, ofs += size, len -= size) {
+        size_t blkSize = STORAGE_CacheLocate(periph, &block, &ofs);
+        if (blkSize == 0) {
+            return (MDS_EINVAL);
+        }
+
+        uintptr_t lineOfs = ofs - (ofs % cache->lineSize);
+        size_t lineLen = ((blkSize - lineOfs) < cache->lineSize) ? (blkSize - lineOfs) : (cache->lineSize);
+        size = ((lineOfs + lineLen - ofs) < len) ? (lineOfs + lineLen - ofs) : (len);
+
+        // the pending line goes first so programs reach the device in the order they were issued
+        if ((!cache->writeBack) || ((ofs == lineOfs) && (len >= lineLen))) {
+            if ((ofs == lineOfs) && (len >= lineLen)) {
+                size = STORAGE_CacheRun(cache, blkSize, ofs, len);
+            }
+            err = STORAGE_CacheFlush(periph);
+            if (err == MDS_EOK) {
+                err = periph->mount->driver->prog(periph, periph->object.blockBase + block, ofs, buff, size);
+            }
+            STORAGE_CacheUpdate(cache, block, ofs, buff, size, (err == MDS_EOK));
+            continue;
+        }
+
+        DEV_STORAGE_CacheLine_t *line = STORAGE_CacheFind(cache, block, lineOfs);
+        if (line == NULL) {
+            err = STORAGE_CacheLoad(periph, &line, block, lineOfs, lineLen);
+            if (err != MDS_EOK) {
+                break;
+            }
+        }
+
+        size_t dirtyS = ofs - lineOfs;
+        size_t dirtyE = dirtyS + size;
+        if ((cache->dirty != NULL) &&
+            ((cache->dirty != line) || (dirtyS > cache->dirtyE) || (dirtyE < cache->dirtyS))) {
+            err = STORAGE_CacheFlush(periph);
+            if (err != MDS_EOK) {
+                break;
+            }
+        }
+
+        MDS_MemBuffCopy(line->buff + dirtyS, size, buff, size);
+        if (cache->dirty == NULL) {
+            cache->dirty = line;
+            cache->dirtyS = dirtyS;
+            cache->dirtyE = dirtyE;
+        } else {
+            cache->dirtyS = (dirtyS < cache->dirtyS) ? (dirtyS) : (cache->dirtyS);
+            cache->dirtyE = (dirtyE > cache->dirtyE) ? (dirtyE) : (cache->dirtyE);
+        }
+        STORAGE_CacheTouch(cache, line);
+    }
+
+    return (err);
+}
+
+static MDS_Err_t STORAGE_CacheErase(DEV_STORAGE_Periph_t *periph, size_t block, size_t nums)
+{
+    DEV_STORAGE_Cache_t *cache = periph->cache;
+    DEV_STORAGE_CacheLine_t *line = NULL;
+    DEV_STORAGE_CacheLine_t *next = NULL;
+    MDS_Err_t err = MDS_EOK;
+
+    // a pending program into an erased block is dropped rather than written first
+    if ((cache->dirty != NULL) && (cache->dirty->block >= block) && (cache->dirty->block < (block + nums))) {
+        cache->dirty = NULL;
+    } else {
+        err = STORAGE_CacheFlush(periph);
+    }
+
+    for (line = CONTAINER_OF(cache->list.next, DEV_STORAGE_CacheLine_t, node); &(line->node) != &(cache->list);
+         line = next) {
+        next = CONTAINER_OF(line->node.next, DEV_STORAGE_CacheLine_t, node);
+        if (line->size == 0) {
+            break;
+        }
+        if ((line->block >= block) && (line->block < (block + nums))) {
+            STORAGE_CacheInvalid(cache, line);
+        }
+    }
+
+    if (err == MDS_EOK) {
+        err = periph->mount->driver->erase(periph, periph->object.blockBase + block, nums);
+    }
+
+    return (err);
+}
+
 /* Storage periph ---------------------------------------------------------- */
 MDS_Err_t DEV_STORAGE_PeriphInit(DEV_STORAGE_Periph_t *periph, const char *name, DEV_STORAGE_Adaptr_t *storage)
 {
     MDS_Err_t err = MDS_DevPeriphInit((MDS_DevPeriph_t *)periph, name, (MDS_DevAdaptr_t *)storage);
     if (err == MDS_EOK) {
         periph->object.timeout = MDS_DEVICE_PERIPH_TIMEOUT;
+        periph->cache = NULL;
     }
 
     return (err);
@@ -58,6 +369,7 @@ DEV_STORAGE_Periph_t *DEV_STORAGE_PeriphCreate(const char *name, DEV_STORAGE_Ada
                                                                                (MDS_DevAdaptr_t *)storage);
     if (periph != NULL) {
         periph->object.timeout = MDS_DEVICE_PERIPH_TIMEOUT;
+        periph->cache = NULL;
     }
 
     return (periph);
@@ -70,12 +382,21 @@ MDS_Err_t DEV_STORAGE_PeriphDestroy(DEV_STORAGE_Periph_t *periph)
 
 MDS_Err_t DEV_STORAGE_PeriphOpen(DEV_STORAGE_Periph_t *periph, MDS_Tick_t timeout)
 {
-    return (MDS_DevPeriphOpen((MDS_DevPeriph_t *)periph, timeout));
+    MDS_Err_t err = MDS_DevPeriphOpen((MDS_DevPeriph_t *)periph, timeout);
+    if (err == MDS_EOK) {
+        DEV_STORAGE_PeriphTotalSize(periph);
+    }
+
+    return (err);
 }
 
 MDS_Err_t DEV_STORAGE_PeriphClose(DEV_STORAGE_Periph_t *periph)
 {
-    return (MDS_DevPeriphClose((MDS_DevPeriph_t *)periph));
+    // the write-back line is only flushed while this periph still owns the adaptr
+    MDS_Err_t err = DEV_STORAGE_PeriphSync(periph);
+    MDS_Err_t ret = MDS_DevPeriphClose((MDS_DevPeriph_t *)periph);
+
+    return ((err != MDS_EOK) ? (err) : (ret));
 }
 
 size_t DEV_STORAGE_PeriphBlockNums(DEV_STORAGE_Periph_t *periph)
@@ -94,19 +415,28 @@ size_t DEV_STORAGE_PeriphBlockSize(DEV_STORAGE_Periph_t *periph, size_t block)
 
     const DEV_STORAGE_Adaptr_t *storage = periph->mount;
 
-    if (block > periph->object.blockNums) {
+    if (block >= periph->object.blockNums) {
         return (0);
     }
 
+    if (periph->object.blockSize != 0) {
+        return (periph->object.blockSize);
+    }
+
     return (storage->driver->blksize(storage, periph->object.blockBase + block));
 }
 
 size_t DEV_STORAGE_PeriphTotalSize(DEV_STORAGE_Periph_t *periph)
 {
     if (periph->object.totalSize == 0) {
+        size_t blockSize = 0;
+
         for (size_t cnt = 0; cnt < periph->object.blockNums; cnt++) {
-            periph->object.totalSize += DEV_STORAGE_PeriphBlockSize(periph, cnt);
+            size_t size = DEV_STORAGE_PeriphBlockSize(periph, cnt);
+            blockSize = ((cnt == 0) || (size == blockSize)) ? (size) : (0);
+            periph->object.totalSize += size;
         }
+        periph->object.blockSize = blockSize;
     }
 
     return (periph->object.totalSize);
@@ -121,12 +451,40 @@ MDS_Err_t DEV_STORAGE_PeriphRead(DEV_STORAGE_Periph_t *periph, size_t block, uin
 
     const DEV_STORAGE_Adaptr_t *storage = periph->mount;
 
-    if (block > periph->object.blockNums) {
+    if (block >= periph->object.blockNums) {
         return (MDS_EINVAL);
     }
 
     DEV_STORAGE_PeriphTotalSize(periph);
 
+    if (periph->cache != NULL) {
+        return (STORAGE_CacheRead(periph, block, ofs, buff, len));
+    }
+
+    return (storage->driver->read(periph, periph->object.blockBase + block, ofs, buff, len));
+}
+
+MDS_Err_t DEV_STORAGE_PeriphReadThrough(DEV_STORAGE_Periph_t *periph, size_t block, uintptr_t ofs, uint8_t *buff,
+                                        size_t len)
+{
+    MDS_ASSERT(periph != NULL);
+    MDS_ASSERT(periph->mount != NULL);
+    MDS_ASSERT(periph->mount->driver != NULL);
+    MDS_ASSERT(periph->mount->driver->read != NULL);
+
+    const DEV_STORAGE_Adaptr_t *storage = periph->mount;
+
+    if (block >= periph->object.blockNums) {
+        return (MDS_EINVAL);
+    }
+
+    DEV_STORAGE_PeriphTotalSize(periph);
+
+    MDS_Err_t err = DEV_STORAGE_PeriphSync(periph);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
     return (storage->driver->read(periph, periph->object.blockBase + block, ofs, buff, len));
 }
 
@@ -144,12 +502,16 @@ MDS_Err_t DEV_STORAGE_PeriphProgram(DEV_STORAGE_Periph_t *periph, size_t block,
         return (MDS_EIO);
     }
 
-    if (block > periph->object.blockNums) {
+    if (block >= periph->object.blockNums) {
         return (MDS_EINVAL);
     }
 
     DEV_STORAGE_PeriphTotalSize(periph);
 
+    if (periph->cache != NULL) {
+        return (STORAGE_CacheProgram(periph, block, ofs, buff, len));
+    }
+
     return (storage->driver->prog(periph, periph->object.blockBase + block, ofs, buff, len));
 }
 
@@ -166,11 +528,139 @@ MDS_Err_t DEV_STORAGE_PeriphErase(DEV_STORAGE_Periph_t *periph, size_t block, si
         return (MDS_EIO);
     }
 
-    if (block > periph->object.blockNums) {
+    if ((block >= periph->object.blockNums) || (nums > (periph->object.blockNums - block))) {
         return (MDS_EINVAL);
     }
 
     DEV_STORAGE_PeriphTotalSize(periph);
 
+    if (periph->cache != NULL) {
+        return (STORAGE_CacheErase(periph, block, nums));
+    }
+
     return (storage->driver->erase(periph, periph->object.blockBase + block, nums));
 }
+
+static size_t STORAGE_VectorMerge(const DEV_STORAGE_Vector_t *vec, size_t cnt, size_t *idx)
+{
+    // ranges adjacent both on the device and in memory are issued as one access
+    size_t len = vec[*idx].len;
+
+    while (((*idx + 1) < cnt) && (vec[*idx + 1].block == vec[*idx].block) &&
+           (vec[*idx + 1].ofs == (vec[*idx].ofs + vec[*idx].len)) &&
+           (vec[*idx + 1].buff == (vec[*idx].buff + vec[*idx].len))) {
+        *idx += 1;
+        len += vec[*idx].len;
+    }
+
+    return (len);
+}
+
+MDS_Err_t DEV_STORAGE_PeriphReadv(DEV_STORAGE_Periph_t *periph, const DEV_STORAGE_Vector_t *vec, size_t cnt)
+{
+    MDS_ASSERT(periph != NULL);
+    MDS_ASSERT(periph->mount != NULL);
+    MDS_ASSERT(periph->mount->driver != NULL);
+    MDS_ASSERT(periph->mount->driver->read != NULL);
+    MDS_ASSERT((vec != NULL) || (cnt == 0));
+
+    const DEV_STORAGE_Adaptr_t *storage = periph->mount;
+    MDS_Err_t err = MDS_EOK;
+
+    DEV_STORAGE_PeriphTotalSize(periph);
+
+    for (size_t idx = 0; (err == MDS_EOK) && (idx < cnt); idx++) {
+        const DEV_STORAGE_Vector_t *iter = &(vec[idx]);
+        size_t len = STORAGE_VectorMerge(vec, cnt, &idx);
+
+        if (iter->block >= periph->object.blockNums) {
+            err = MDS_EINVAL;
+        } else if (periph->cache != NULL) {
+            err = STORAGE_CacheRead(periph, iter->block, iter->ofs, iter->buff, len);
+        } else {
+            err = storage->driver->read(periph, periph->object.blockBase + iter->block, iter->ofs, iter->buff, len);
+        }
+    }
+
+    return (err);
+}
+
+MDS_Err_t DEV_STORAGE_PeriphProgramv(DEV_STORAGE_Periph_t *periph, const DEV_STORAGE_Vector_t *vec, size_t cnt)
+{
+    MDS_ASSERT(periph != NULL);
+    MDS_ASSERT(periph->mount != NULL);
+    MDS_ASSERT(periph->mount->driver != NULL);
+    MDS_ASSERT(periph->mount->driver->prog != NULL);
+    MDS_ASSERT((vec != NULL) || (cnt == 0));
+
+    const DEV_STORAGE_Adaptr_t *storage = periph->mount;
+    MDS_Err_t err = MDS_EOK;
+
+    if (!MDS_DevPeriphIsAccessible((MDS_DevPeriph_t *)periph)) {
+        return (MDS_EIO);
+    }
+
+    DEV_STORAGE_PeriphTotalSize(periph);
+
+    for (size_t idx = 0; (err == MDS_EOK) && (idx < cnt); idx++) {
+        const DEV_STORAGE_Vector_t *iter = &(vec[idx]);
+        size_t len = STORAGE_VectorMerge(vec, cnt, &idx);
+
+        if (iter->block >= periph->object.blockNums) {
+            err = MDS_EINVAL;
+        } else if (periph->cache != NULL) {
+            err = STORAGE_CacheProgram(periph, iter->block, iter->ofs, iter->buff, len);
+        } else {
+            err = storage->driver->prog(periph, periph->object.blockBase + iter->block, iter->ofs, iter->buff, len);
+        }
+    }
+
+    return (err);
+}
+
+MDS_Err_t DEV_STORAGE_PeriphMediaChanged(DEV_STORAGE_Periph_t *periph)
+{
+    MDS_ASSERT(periph != NULL);
+
+    // pending data belongs to the previous media and is dropped
+    if (periph->cache != NULL) {
+        STORAGE_CacheClear(periph->cache);
+    }
+
+    periph->object.totalSize = 0;
+    periph->object.blockSize = 0;
+
+    return ((DEV_STORAGE_PeriphTotalSize(periph) != 0) ? (MDS_EOK) : (MDS_ENODEV));
+}
+
+MDS_Err_t DEV_STORAGE_PeriphSync(DEV_STORAGE_Periph_t *periph)
+{
+    MDS_ASSERT(periph != NULL);
+
+    if ((periph->cache == NULL) || (periph->cache->dirty == NULL)) {
+        return (MDS_EOK);
+    }
+
+    if (!MDS_DevPeriphIsAccessible((MDS_DevPeriph_t *)periph)) {
+        return (MDS_EIO);
+    }
+
+    return (STORAGE_CacheFlush(periph));
+}
+
+MDS_Err_t DEV_STORAGE_PeriphCache(DEV_STORAGE_Periph_t *periph, DEV_STORAGE_Cache_t *cache)
+{
+    MDS_ASSERT(periph != NULL);
+
+    MDS_Err_t err = DEV_STORAGE_PeriphSync(periph);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    if (cache != NULL) {
+        STORAGE_CacheClear(cache);
+    }
+    periph->cache = cache;
+
+    return (MDS_EOK);
+}
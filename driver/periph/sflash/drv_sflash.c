@@ -1,13 +1,25 @@
-
-
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
 #include "drv_sflash.h"
 
+/* Define ------------------------------------------------------------------ */
 #define SFLASH_CMD_WRITE_ENABLE     0x06
 #define SFLASH_CMD_WRITE_DISABLE    0x50
 #define SFLASH_CMD_READ_DEVICE_ID   0xAB
 #define SFLASH_CMD_READ_MANUFACTURE 0x90
 #define SFLASH_CMD_READ_JEDEC_ID    0x9F
 #define SFLASH_CMD_READ_UNIQUE_ID   0x4B
+#define SFLASH_CMD_READ_SFDP        0x5A
 #define SFLASH_CMD_READ_DATA        0x03
 #define SFLASH_CMD_FAST_READ_DATA   0x0B
 #define SFLASH_CMD_PAGE_PROGRAM     0x02
@@ -16,31 +28,869 @@
 #define SFLASH_CMD_CHIP_ERASE       0xC7
 #define SFLASH_CMD_WRITE_STATUS     0x01
 #define SFLASH_CMD_READ_STATUS      0x05
+#define SFLASH_CMD_WRITE_STATUS2    0x31
+#define SFLASH_CMD_READ_STATUS2     0x35
+#define SFLASH_CMD_ENTER_4B_ADDRESS 0xB7
 
-MDS_Err_t DRV_SFLASH_WriteEnable(DRV_SFLASH_QSPIHandle_t *hsflash, bool enabled)
+#define SFLASH_STATUS_BUSY     0x01U
+#define SFLASH_STATUS_QE_SR1   0x40U
+#define SFLASH_STATUS_QE_SR2   0x02U
+#define SFLASH_POLLING_CYCLES  0x10U
+#define SFLASH_PAGE_SIZE       256U
+#define SFLASH_SECTOR_SIZE     4096U
+#define SFLASH_BLOCK_SIZE      65536U
+#define SFLASH_3B_ADDRESS_SIZE 0x01000000U
+
+#define SFLASH_SFDP_SIGNATURE   0x50444653U /* "SFDP" */
+#define SFLASH_SFDP_BFPT_ID     0xFF00U
+#define SFLASH_SFDP_HEADER_SIZE 0x08U
+#define SFLASH_SFDP_HEADER_NUMS 0x08U
+#define SFLASH_SFDP_BFPT_DWORDS 0x10U
+#define SFLASH_SFDP_DUMMY       0x08U
+
+/* Typedef ----------------------------------------------------------------- */
+typedef MDS_Err_t (*SFLASH_SfdpRead_t)(void *hsflash, uint32_t addr, uint8_t *buff, size_t len);
+
+/* Function ---------------------------------------------------------------- */
+static uint32_t SFLASH_SfdpDWord(const uint8_t *buff, size_t idx)
+{
+    const uint8_t *dword = &(buff[(idx - 1) * sizeof(uint32_t)]);
+
+    return ((uint32_t)dword[0x00] | ((uint32_t)dword[0x01] << 8) | ((uint32_t)dword[0x02] << 16) |
+            ((uint32_t)dword[0x03] << 24));
+}
+
+static void SFLASH_InfoDefault(DRV_SFLASH_Info_t *info)
+{
+    // most vendors encode the capacity as log2(bytes) in the last JEDEC ID byte
+    uint8_t capacity = info->jedecId[0x02];
+
+    info->totalSize = ((capacity >= 0x10) && (capacity < 0x20)) ? (1UL << capacity) : (0);
+    info->pageSize = SFLASH_PAGE_SIZE;
+    info->sectorSize = SFLASH_SECTOR_SIZE;
+    info->blockSize = SFLASH_BLOCK_SIZE;
+    info->addrSize = (info->totalSize > SFLASH_3B_ADDRESS_SIZE) ? (0x04) : (0x03);
+    info->sectorErase = SFLASH_CMD_SECTOR_ERASE;
+    info->blockErase = SFLASH_CMD_BLOCK_ERASE;
+    info->readCmd = SFLASH_CMD_FAST_READ_DATA;
+    info->readAddrLine = 0x01;
+    info->readDataLine = 0x01;
+    info->readMode = 0;
+    info->readDummy = SFLASH_SFDP_DUMMY;
+    info->progCmd = SFLASH_CMD_PAGE_PROGRAM;
+    info->quadEnable = 0;
+}
+
+static void SFLASH_SfdpReadMode(DRV_SFLASH_Info_t *info, uint8_t cmd, uint8_t addrLine, uint8_t dataLine,
+                                uint32_t param)
+{
+    info->readCmd = cmd;
+    info->readAddrLine = addrLine;
+    info->readDataLine = dataLine;
+    info->readDummy = param & 0x1FU;
+    info->readMode = (param >> 5) & 0x07U;
+}
+
+static MDS_Err_t SFLASH_SfdpParseTable(DRV_SFLASH_Info_t *info, uint8_t lineMax, SFLASH_SfdpRead_t read,
+                                       void *hsflash)
+{
+    uint8_t header[SFLASH_SFDP_HEADER_SIZE];
+
+    MDS_Err_t err = read(hsflash, 0, header, sizeof(header));
+    if ((err != MDS_EOK) || (SFLASH_SfdpDWord(header, 1) != SFLASH_SFDP_SIGNATURE)) {
+        return ((err != MDS_EOK) ? (err) : (MDS_ENODEV));
+    }
+
+    uint32_t bfptAddr = 0;
+    size_t bfptLen = 0;
+    for (size_t idx = 0; (idx <= header[0x06]) && (idx < SFLASH_SFDP_HEADER_NUMS); idx++) {
+        uint8_t param[SFLASH_SFDP_HEADER_SIZE];
+        err = read(hsflash, SFLASH_SFDP_HEADER_SIZE * (idx + 1), param, sizeof(param));
+        if (err != MDS_EOK) {
+            return (err);
+        }
+        if ((param[0x00] | ((uint16_t)param[0x07] << 8)) == SFLASH_SFDP_BFPT_ID) {
+            bfptAddr = (uint32_t)param[0x04] | ((uint32_t)param[0x05] << 8) | ((uint32_t)param[0x06] << 16);
+            bfptLen = param[0x03];
+            break;
+        }
+    }
+    if (bfptLen < 9) {
+        return (MDS_ENODEV);
+    }
+
+    uint8_t bfpt[SFLASH_SFDP_BFPT_DWORDS * sizeof(uint32_t)];
+    MDS_MemBuffSet(bfpt, 0xFF, sizeof(bfpt));
+    bfptLen = (bfptLen > SFLASH_SFDP_BFPT_DWORDS) ? (SFLASH_SFDP_BFPT_DWORDS) : (bfptLen);
+    err = read(hsflash, bfptAddr, bfpt, bfptLen * sizeof(uint32_t));
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    uint32_t dword1 = SFLASH_SfdpDWord(bfpt, 1);
+    uint32_t dword2 = SFLASH_SfdpDWord(bfpt, 2);
+    if ((dword2 & 0x80000000U) == 0U) {
+        info->totalSize = (dword2 + 1) / MDS_BITS_OF_BYTE;
+    } else if (((dword2 & 0x7FFFFFFFU) >= 0x03) && ((dword2 & 0x7FFFFFFFU) < 0x23)) {
+        info->totalSize = 1UL << ((dword2 & 0x7FFFFFFFU) - 0x03);
+    } else {
+        return (MDS_ENODEV);
+    }
+    info->addrSize = ((((dword1 >> 17) & 0x03U) == 0x02U) || (info->totalSize > SFLASH_3B_ADDRESS_SIZE)) ? (0x04)
+                                                                                                        : (0x03);
+
+    // smallest erase type is the sector, largest one erases whole blocks
+    info->sectorSize = 0;
+    info->blockSize = 0;
+    for (size_t idx = 0; idx < 0x04; idx++) {
+        uint32_t erase = SFLASH_SfdpDWord(bfpt, 8 + (idx / 2)) >> ((idx % 2) * 16);
+        uint8_t sizeExp = erase & 0xFFU;
+        if ((sizeExp == 0) || (sizeExp >= 0x20)) {
+            continue;
+        }
+        if ((info->sectorSize == 0) || ((1UL << sizeExp) < info->sectorSize)) {
+            info->sectorSize = 1UL << sizeExp;
+            info->sectorErase = (erase >> 8) & 0xFFU;
+        }
+        if ((1UL << sizeExp) > info->blockSize) {
+            info->blockSize = 1UL << sizeExp;
+            info->blockErase = (erase >> 8) & 0xFFU;
+        }
+    }
+    if (info->sectorSize == 0) {
+        if ((dword1 & 0x03U) != 0x01U) {
+            return (MDS_ENODEV);
+        }
+        info->sectorSize = SFLASH_SECTOR_SIZE;
+        info->sectorErase = (dword1 >> 8) & 0xFFU;
+    }
+
+    if (bfptLen >= 11) {
+        info->pageSize = 1UL << ((SFLASH_SfdpDWord(bfpt, 11) >> 4) & 0x0FU);
+    }
+
+    // quad reads are only used when the table tells how to set the QE bit
+    info->quadEnable = (bfptLen >= 15) ? ((SFLASH_SfdpDWord(bfpt, 15) >> 20) & 0x07U) : (0x07);
+    if ((lineMax >= 0x04) && (info->quadEnable != 0x07) && ((dword1 & (1UL << 21)) != 0U)) {
+        SFLASH_SfdpReadMode(info, SFLASH_SfdpDWord(bfpt, 3) >> 8, 0x04, 0x04, SFLASH_SfdpDWord(bfpt, 3));
+    } else if ((lineMax >= 0x04) && (info->quadEnable != 0x07) && ((dword1 & (1UL << 22)) != 0U)) {
+        SFLASH_SfdpReadMode(info, SFLASH_SfdpDWord(bfpt, 3) >> 24, 0x01, 0x04, SFLASH_SfdpDWord(bfpt, 3) >> 16);
+    } else if ((lineMax >= 0x02) && ((dword1 & (1UL << 20)) != 0U)) {
+        SFLASH_SfdpReadMode(info, SFLASH_SfdpDWord(bfpt, 4) >> 24, 0x02, 0x02, SFLASH_SfdpDWord(bfpt, 4) >> 16);
+    } else if ((lineMax >= 0x02) && ((dword1 & (1UL << 16)) != 0U)) {
+        SFLASH_SfdpReadMode(info, SFLASH_SfdpDWord(bfpt, 4) >> 8, 0x01, 0x02, SFLASH_SfdpDWord(bfpt, 4));
+    }
+
+    return (MDS_EOK);
+}
+
+static MDS_Err_t SFLASH_SfdpParse(DRV_SFLASH_Info_t *info, uint8_t lineMax, SFLASH_SfdpRead_t read, void *hsflash)
+{
+    DRV_SFLASH_Info_t sfdp = *info;
+
+    MDS_Err_t err = SFLASH_SfdpParseTable(&sfdp, lineMax, read, hsflash);
+    if (err == MDS_EOK) {
+        *info = sfdp;
+    }
+
+    return (err);
+}
+
+static bool SFLASH_IsErased(const uint8_t *buff, size_t len)
+{
+    for (size_t idx = 0; idx < len; idx++) {
+        if (buff[idx] != 0xFF) {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+/* QSPI -------------------------------------------------------------------- */
+static DEV_QSPI_CmdLine_t SFLASH_QSPICmdLine(uint8_t line)
+{
+    switch (line) {
+        case 0x01:
+            return (DEV_QSPI_CMDLINE_1);
+        case 0x02:
+            return (DEV_QSPI_CMDLINE_2);
+        case 0x04:
+            return (DEV_QSPI_CMDLINE_4);
+        default:
+            break;
+    }
+
+    return (DEV_QSPI_CMDLINE_0);
+}
+
+static DEV_QSPI_CmdSize_t SFLASH_QSPIAddrSize(const DRV_SFLASH_QSPIHandle_t *hsflash)
+{
+    return ((hsflash->info.addrSize == 0x04) ? (DEV_QSPI_CMDSIZE_4B) : (DEV_QSPI_CMDSIZE_3B));
+}
+
+static MDS_Err_t SFLASH_QSPIWaitBusy(DRV_SFLASH_QSPIHandle_t *hsflash)
+{
+    DEV_QSPI_Command_t cmd = {
+        .instruction = SFLASH_CMD_READ_STATUS,
+        .instructionLine = DEV_QSPI_CMDLINE_1,
+        .dataLine = DEV_QSPI_CMDLINE_1,
+        .dataSize = 1,
+    };
+    DEV_QSPI_Polling_t poll = {
+        .match = 0,
+        .mask = SFLASH_STATUS_BUSY,
+        .interval = SFLASH_POLLING_CYCLES,
+        .statusSize = DEV_QSPI_CMDSIZE_1B,
+        .matchMode = DEV_QSPI_MATCHMODE_AND,
+        .autoStop = DEV_QSPI_AUTOMODE_ENABLE,
+        .timeout = hsflash->timeout,
+    };
+
+    return (DEV_QSPI_PeriphPolling(hsflash->periph, &cmd, &poll));
+}
+
+static MDS_Err_t SFLASH_QSPIWriteEnable(DRV_SFLASH_QSPIHandle_t *hsflash, bool enabled)
 {
     DEV_QSPI_Command_t cmd = {
         .instruction = (enabled) ? (SFLASH_CMD_WRITE_ENABLE) : (SFLASH_CMD_WRITE_DISABLE),
         .instructionLine = DEV_QSPI_CMDLINE_1,
     };
 
+    return (DEV_QSPI_PeriphCommand(hsflash->periph, &cmd));
+}
+
+static MDS_Err_t SFLASH_QSPIRegRead(DRV_SFLASH_QSPIHandle_t *hsflash, uint8_t inst, uint8_t *buff, size_t len)
+{
+    DEV_QSPI_Command_t cmd = {
+        .instruction = inst,
+        .instructionLine = DEV_QSPI_CMDLINE_1,
+        .dataLine = DEV_QSPI_CMDLINE_1,
+        .dataSize = len,
+    };
+
+    MDS_Err_t err = DEV_QSPI_PeriphCommand(hsflash->periph, &cmd);
+    if (err == MDS_EOK) {
+        err = DEV_QSPI_PeriphReceive(hsflash->periph, buff, len);
+    }
+
+    return (err);
+}
+
+static MDS_Err_t SFLASH_QSPIRegWrite(DRV_SFLASH_QSPIHandle_t *hsflash, uint8_t inst, const uint8_t *buff, size_t len)
+{
+    DEV_QSPI_Command_t cmd = {
+        .instruction = inst,
+        .instructionLine = DEV_QSPI_CMDLINE_1,
+        .dataLine = (len > 0) ? (DEV_QSPI_CMDLINE_1) : (DEV_QSPI_CMDLINE_0),
+        .dataSize = len,
+    };
+
+    MDS_Err_t err = SFLASH_QSPIWriteEnable(hsflash, true);
+    if (err == MDS_EOK) {
+        err = DEV_QSPI_PeriphCommand(hsflash->periph, &cmd);
+    }
+    if ((err == MDS_EOK) && (len > 0)) {
+        err = DEV_QSPI_PeriphTransmit(hsflash->periph, buff, len);
+    }
+    if (err == MDS_EOK) {
+        err = SFLASH_QSPIWaitBusy(hsflash);
+    }
+
+    return (err);
+}
+
+static MDS_Err_t SFLASH_QSPISfdpRead(void *hsflash, uint32_t addr, uint8_t *buff, size_t len)
+{
+    DEV_QSPI_Command_t cmd = {
+        .instruction = SFLASH_CMD_READ_SFDP,
+        .instructionLine = DEV_QSPI_CMDLINE_1,
+        .addressLine = DEV_QSPI_CMDLINE_1,
+        .addressSize = DEV_QSPI_CMDSIZE_3B,
+        .address = addr,
+        .dataLine = DEV_QSPI_CMDLINE_1,
+        .dataSize = len,
+        .dummyCycles = SFLASH_SFDP_DUMMY,
+    };
+
+    MDS_Err_t err = DEV_QSPI_PeriphCommand(((DRV_SFLASH_QSPIHandle_t *)hsflash)->periph, &cmd);
+    if (err == MDS_EOK) {
+        err = DEV_QSPI_PeriphReceive(((DRV_SFLASH_QSPIHandle_t *)hsflash)->periph, buff, len);
+    }
+
+    return (err);
+}
+
+static MDS_Err_t SFLASH_QSPIQuadEnable(DRV_SFLASH_QSPIHandle_t *hsflash)
+{
+    uint8_t status[0x02] = {0};
+    MDS_Err_t err = MDS_EOK;
+
+    switch (hsflash->info.quadEnable) {
+        case 0x00:
+            break;
+        case 0x01:
+        case 0x04:
+        case 0x05:
+            // QE is bit 1 of status register 2, written together with status register 1
+            // only QER 1 has no way to read status register 2 back, its other bits are assumed clear
+            err = SFLASH_QSPIRegRead(hsflash, SFLASH_CMD_READ_STATUS, &(status[0x00]), 1);
+            if ((err == MDS_EOK) && (hsflash->info.quadEnable != 0x01)) {
+                err = SFLASH_QSPIRegRead(hsflash, SFLASH_CMD_READ_STATUS2, &(status[0x01]), 1);
+            }
+            if ((err == MDS_EOK) && ((status[0x01] & SFLASH_STATUS_QE_SR2) == 0U)) {
+                status[0x01] |= SFLASH_STATUS_QE_SR2;
+                err = SFLASH_QSPIRegWrite(hsflash, SFLASH_CMD_WRITE_STATUS, status, sizeof(status));
+            }
+            break;
+        case 0x02:
+            err = SFLASH_QSPIRegRead(hsflash, SFLASH_CMD_READ_STATUS, &(status[0x00]), 1);
+            if ((err == MDS_EOK) && ((status[0x00] & SFLASH_STATUS_QE_SR1) == 0U)) {
+                status[0x00] |= SFLASH_STATUS_QE_SR1;
+                err = SFLASH_QSPIRegWrite(hsflash, SFLASH_CMD_WRITE_STATUS, status, 1);
+            }
+            break;
+        case 0x06:
+            err = SFLASH_QSPIRegRead(hsflash, SFLASH_CMD_READ_STATUS2, &(status[0x01]), 1);
+            if ((err == MDS_EOK) && ((status[0x01] & SFLASH_STATUS_QE_SR2) == 0U)) {
+                status[0x01] |= SFLASH_STATUS_QE_SR2;
+                err = SFLASH_QSPIRegWrite(hsflash, SFLASH_CMD_WRITE_STATUS2, &(status[0x01]), 1);
+            }
+            break;
+        default:
+            err = MDS_EPERM;
+            break;
+    }
+
+    return (err);
+}
+
+MDS_Err_t DRV_SFLASH_WriteEnable(DRV_SFLASH_QSPIHandle_t *hsflash, bool enabled)
+{
+    MDS_ASSERT(hsflash != NULL);
+
+    MDS_Err_t err = DEV_QSPI_PeriphOpen(hsflash->periph, hsflash->timeout);
+    if (err == MDS_EOK) {
+        err = SFLASH_QSPIWriteEnable(hsflash, enabled);
+        DEV_QSPI_PeriphClose(hsflash->periph);
+    }
+
+    return (err);
+}
+
+MDS_Err_t DRV_SFLASH_QSPIProbe(DRV_SFLASH_QSPIHandle_t *hsflash, uint8_t lineMax)
+{
+    MDS_ASSERT(hsflash != NULL);
+
+    MDS_Err_t err = DEV_QSPI_PeriphOpen(hsflash->periph, hsflash->timeout);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    DRV_SFLASH_Info_t *info = &(hsflash->info);
+    err = SFLASH_QSPIRegRead(hsflash, SFLASH_CMD_READ_JEDEC_ID, info->jedecId, sizeof(info->jedecId));
+    if (err == MDS_EOK) {
+        SFLASH_InfoDefault(info);
+        // fall back to dual reads when the QE bit cannot be set
+        MDS_Err_t sfdp = SFLASH_SfdpParse(info, lineMax, SFLASH_QSPISfdpRead, hsflash);
+        if ((sfdp == MDS_EOK) && (info->readDataLine == 0x04) && (SFLASH_QSPIQuadEnable(hsflash) != MDS_EOK)) {
+            SFLASH_SfdpParse(info, 0x02, SFLASH_QSPISfdpRead, hsflash);
+        }
+        if (info->addrSize == 0x04) {
+            err = SFLASH_QSPIRegWrite(hsflash, SFLASH_CMD_ENTER_4B_ADDRESS, NULL, 0);
+        }
+    }
+
+    DEV_QSPI_PeriphClose(hsflash->periph);
+
+    if ((err == MDS_EOK) && ((info->totalSize == 0) || (info->sectorSize == 0) || (info->pageSize == 0))) {
+        err = MDS_ENODEV;
+    }
+
+    return (err);
+}
+
+MDS_Err_t DRV_SFLASH_QSPIRead(DRV_SFLASH_QSPIHandle_t *hsflash, uint32_t addr, uint8_t *buff, size_t len)
+{
+    MDS_ASSERT(hsflash != NULL);
+    MDS_ASSERT(buff != NULL);
+
+    const DRV_SFLASH_Info_t *info = &(hsflash->info);
+    DEV_QSPI_Command_t cmd = {
+        .instruction = info->readCmd,
+        .instructionLine = DEV_QSPI_CMDLINE_1,
+        .addressLine = SFLASH_QSPICmdLine(info->readAddrLine),
+        .addressSize = SFLASH_QSPIAddrSize(hsflash),
+        .address = addr,
+        .dataLine = SFLASH_QSPICmdLine(info->readDataLine),
+        .dataSize = len,
+        .dummyCycles = info->readDummy,
+    };
+
+    // mode bits 0xFF keep the device out of continuous read mode
+    if ((info->readMode * info->readAddrLine) == MDS_BITS_OF_BYTE) {
+        cmd.alternateLine = cmd.addressLine;
+        cmd.alternateSize = DEV_QSPI_CMDSIZE_1B;
+        cmd.alternate = 0xFF;
+    } else {
+        cmd.dummyCycles += info->readMode;
+    }
+
+    if ((addr + len) > info->totalSize) {
+        return (MDS_EINVAL);
+    }
+
     MDS_Err_t err = DEV_QSPI_PeriphOpen(hsflash->periph, hsflash->timeout);
     if (err == MDS_EOK) {
         err = DEV_QSPI_PeriphCommand(hsflash->periph, &cmd);
+        if (err == MDS_EOK) {
+            err = DEV_QSPI_PeriphReceive(hsflash->periph, buff, len);
+        }
         DEV_QSPI_PeriphClose(hsflash->periph);
     }
 
     return (err);
 }
 
-const DEV_STORAGE_Driver_t G_DRV_SFLASH_QSPI = {
+MDS_Err_t DRV_SFLASH_QSPIProgram(DRV_SFLASH_QSPIHandle_t *hsflash, uint32_t addr, const uint8_t *buff, size_t len)
+{
+    MDS_ASSERT(hsflash != NULL);
+    MDS_ASSERT(buff != NULL);
+
+    const DRV_SFLASH_Info_t *info = &(hsflash->info);
+    if ((addr + len) > info->totalSize) {
+        return (MDS_EINVAL);
+    }
+
+    MDS_Err_t err = DEV_QSPI_PeriphOpen(hsflash->periph, hsflash->timeout);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    // one page program per page touched, erased runs are skipped since programming 0xFF is a no-op
+    for (size_t ofs = 0, size; (err == MDS_EOK) && (ofs < len); ofs += size) {
+        size = info->pageSize - ((addr + ofs) % info->pageSize);
+        size = (size > (len - ofs)) ? (len - ofs) : (size);
+        if (SFLASH_IsErased(buff + ofs, size)) {
+            continue;
+        }
+
+        DEV_QSPI_Command_t cmd = {
+            .instruction = info->progCmd,
+            .instructionLine = DEV_QSPI_CMDLINE_1,
+            .addressLine = DEV_QSPI_CMDLINE_1,
+            .addressSize = SFLASH_QSPIAddrSize(hsflash),
+            .address = addr + ofs,
+            .dataLine = DEV_QSPI_CMDLINE_1,
+            .dataSize = size,
+        };
+        err = SFLASH_QSPIWriteEnable(hsflash, true);
+        if (err == MDS_EOK) {
+            err = DEV_QSPI_PeriphCommand(hsflash->periph, &cmd);
+        }
+        if (err == MDS_EOK) {
+            err = DEV_QSPI_PeriphTransmit(hsflash->periph, buff + ofs, size);
+        }
+        if (err == MDS_EOK) {
+            err = SFLASH_QSPIWaitBusy(hsflash);
+        }
+    }
+
+    DEV_QSPI_PeriphClose(hsflash->periph);
 
+    return (err);
+}
+
+MDS_Err_t DRV_SFLASH_QSPIErase(DRV_SFLASH_QSPIHandle_t *hsflash, uint32_t addr, size_t size)
+{
+    MDS_ASSERT(hsflash != NULL);
+
+    const DRV_SFLASH_Info_t *info = &(hsflash->info);
+    if (((addr % info->sectorSize) != 0) || ((size % info->sectorSize) != 0) || ((addr + size) > info->totalSize)) {
+        return (MDS_EINVAL);
+    }
+
+    MDS_Err_t err = DEV_QSPI_PeriphOpen(hsflash->periph, hsflash->timeout);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    // aligned whole blocks go with the larger erase
+    for (size_t step; (err == MDS_EOK) && (size > 0); addr += step, size -= step) {
+        DEV_QSPI_Command_t cmd = {
+            .instruction = info->sectorErase,
+            .instructionLine = DEV_QSPI_CMDLINE_1,
+            .addressLine = DEV_QSPI_CMDLINE_1,
+            .addressSize = SFLASH_QSPIAddrSize(hsflash),
+            .address = addr,
+        };
+        step = info->sectorSize;
+        if ((info->blockSize > info->sectorSize) && ((addr % info->blockSize) == 0) && (size >= info->blockSize)) {
+            cmd.instruction = info->blockErase;
+            step = info->blockSize;
+        }
+
+        err = SFLASH_QSPIWriteEnable(hsflash, true);
+        if (err == MDS_EOK) {
+            err = DEV_QSPI_PeriphCommand(hsflash->periph, &cmd);
+        }
+        if (err == MDS_EOK) {
+            err = SFLASH_QSPIWaitBusy(hsflash);
+        }
+    }
+
+    DEV_QSPI_PeriphClose(hsflash->periph);
+
+    return (err);
+}
+
+/* SPI --------------------------------------------------------------------- */
+static size_t SFLASH_SPIHeader(uint8_t *header, uint8_t inst, size_t addrSize, uint32_t addr, size_t dummy)
+{
+    size_t len = 0;
+
+    header[len++] = inst;
+    for (size_t idx = addrSize; idx > 0; idx--) {
+        header[len++] = (uint8_t)(addr >> ((idx - 1) * MDS_BITS_OF_BYTE));
+    }
+    for (size_t idx = 0; idx < dummy; idx++) {
+        header[len++] = 0xFF;
+    }
+
+    return (len);
+}
+
+static MDS_Err_t SFLASH_SPICommand(DRV_SFLASH_SPIHandle_t *hsflash, const uint8_t *header, size_t hlen,
+                                   const uint8_t *tx, uint8_t *rx, size_t len)
+{
+    DEV_SPI_Msg_t data = {
+        .tx = tx,
+        .rx = rx,
+        .size = len,
+        .next = NULL,
+    };
+    DEV_SPI_Msg_t msg = {
+        .tx = header,
+        .rx = NULL,
+        .size = hlen,
+        .next = (len > 0) ? (&data) : (NULL),
+    };
+
+    return (DEV_SPI_PeriphTransferMsg(hsflash->periph, &msg));
+}
+
+static MDS_Err_t SFLASH_SPIWaitBusy(DRV_SFLASH_SPIHandle_t *hsflash)
+{
+    uint8_t inst = SFLASH_CMD_READ_STATUS;
+    uint8_t status = 0;
+
+    MDS_Tick_t tickstart = MDS_SysTickGetCount();
+    do {
+        MDS_Err_t err = SFLASH_SPICommand(hsflash, &inst, sizeof(inst), NULL, &status, sizeof(status));
+        if ((err != MDS_EOK) || ((status & SFLASH_STATUS_BUSY) == 0U)) {
+            return (err);
+        }
+    } while ((MDS_SysTickGetCount() - tickstart) <= hsflash->timeout);
+
+    return (MDS_ETIME);
+}
+
+static MDS_Err_t SFLASH_SPIRegWrite(DRV_SFLASH_SPIHandle_t *hsflash, const uint8_t *header, size_t hlen)
+{
+    uint8_t inst = SFLASH_CMD_WRITE_ENABLE;
+
+    MDS_Err_t err = SFLASH_SPICommand(hsflash, &inst, sizeof(inst), NULL, NULL, 0);
+    if (err == MDS_EOK) {
+        err = SFLASH_SPICommand(hsflash, header, hlen, NULL, NULL, 0);
+    }
+    if (err == MDS_EOK) {
+        err = SFLASH_SPIWaitBusy(hsflash);
+    }
+
+    return (err);
+}
+
+static MDS_Err_t SFLASH_SPISfdpRead(void *hsflash, uint32_t addr, uint8_t *buff, size_t len)
+{
+    uint8_t header[0x05];
+    size_t hlen = SFLASH_SPIHeader(header, SFLASH_CMD_READ_SFDP, 0x03, addr, SFLASH_SFDP_DUMMY / MDS_BITS_OF_BYTE);
+
+    return (SFLASH_SPICommand((DRV_SFLASH_SPIHandle_t *)hsflash, header, hlen, NULL, buff, len));
+}
+
+MDS_Err_t DRV_SFLASH_SPIProbe(DRV_SFLASH_SPIHandle_t *hsflash)
+{
+    MDS_ASSERT(hsflash != NULL);
+
+    MDS_Err_t err = DEV_SPI_PeriphOpen(hsflash->periph, hsflash->timeout);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    DRV_SFLASH_Info_t *info = &(hsflash->info);
+    uint8_t inst = SFLASH_CMD_READ_JEDEC_ID;
+    err = SFLASH_SPICommand(hsflash, &inst, sizeof(inst), NULL, info->jedecId, sizeof(info->jedecId));
+    if (err == MDS_EOK) {
+        SFLASH_InfoDefault(info);
+        SFLASH_SfdpParse(info, 0x01, SFLASH_SPISfdpRead, hsflash);
+        if (info->addrSize == 0x04) {
+            inst = SFLASH_CMD_ENTER_4B_ADDRESS;
+            err = SFLASH_SPIRegWrite(hsflash, &inst, sizeof(inst));
+        }
+    }
+
+    DEV_SPI_PeriphClose(hsflash->periph);
+
+    if ((err == MDS_EOK) && ((info->totalSize == 0) || (info->sectorSize == 0) || (info->pageSize == 0))) {
+        err = MDS_ENODEV;
+    }
+
+    return (err);
+}
+
+MDS_Err_t DRV_SFLASH_SPIRead(DRV_SFLASH_SPIHandle_t *hsflash, uint32_t addr, uint8_t *buff, size_t len)
+{
+    MDS_ASSERT(hsflash != NULL);
+    MDS_ASSERT(buff != NULL);
+
+    const DRV_SFLASH_Info_t *info = &(hsflash->info);
+    if ((addr + len) > info->totalSize) {
+        return (MDS_EINVAL);
+    }
+
+    uint8_t header[0x06];
+    size_t hlen = SFLASH_SPIHeader(header, SFLASH_CMD_FAST_READ_DATA, info->addrSize, addr,
+                                   SFLASH_SFDP_DUMMY / MDS_BITS_OF_BYTE);
+
+    MDS_Err_t err = DEV_SPI_PeriphOpen(hsflash->periph, hsflash->timeout);
+    if (err == MDS_EOK) {
+        err = SFLASH_SPICommand(hsflash, header, hlen, NULL, buff, len);
+        DEV_SPI_PeriphClose(hsflash->periph);
+    }
+
+    return (err);
+}
+
+MDS_Err_t DRV_SFLASH_SPIProgram(DRV_SFLASH_SPIHandle_t *hsflash, uint32_t addr, const uint8_t *buff, size_t len)
+{
+    MDS_ASSERT(hsflash != NULL);
+    MDS_ASSERT(buff != NULL);
+
+    const DRV_SFLASH_Info_t *info = &(hsflash->info);
+    if ((addr + len) > info->totalSize) {
+        return (MDS_EINVAL);
+    }
+
+    MDS_Err_t err = DEV_SPI_PeriphOpen(hsflash->periph, hsflash->timeout);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    uint8_t inst = SFLASH_CMD_WRITE_ENABLE;
+    for (size_t ofs = 0, size; (err == MDS_EOK) && (ofs < len); ofs += size) {
+        size = info->pageSize - ((addr + ofs) % info->pageSize);
+        size = (size > (len - ofs)) ? (len - ofs) : (size);
+        if (SFLASH_IsErased(buff + ofs, size)) {
+            continue;
+        }
+
+        uint8_t header[0x05];
+        size_t hlen = SFLASH_SPIHeader(header, info->progCmd, info->addrSize, addr + ofs, 0);
+        err = SFLASH_SPICommand(hsflash, &inst, sizeof(inst), NULL, NULL, 0);
+        if (err == MDS_EOK) {
+            err = SFLASH_SPICommand(hsflash, header, hlen, buff + ofs, NULL, size);
+        }
+        if (err == MDS_EOK) {
+            err = SFLASH_SPIWaitBusy(hsflash);
+        }
+    }
+
+    DEV_SPI_PeriphClose(hsflash->periph);
+
+    return (err);
+}
+
+MDS_Err_t DRV_SFLASH_SPIErase(DRV_SFLASH_SPIHandle_t *hsflash, uint32_t addr, size_t size)
+{
+    MDS_ASSERT(hsflash != NULL);
+
+    const DRV_SFLASH_Info_t *info = &(hsflash->info);
+    if (((addr % info->sectorSize) != 0) || ((size % info->sectorSize) != 0) || ((addr + size) > info->totalSize)) {
+        return (MDS_EINVAL);
+    }
+
+    MDS_Err_t err = DEV_SPI_PeriphOpen(hsflash->periph, hsflash->timeout);
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    for (size_t step; (err == MDS_EOK) && (size > 0); addr += step, size -= step) {
+        uint8_t inst = info->sectorErase;
+        step = info->sectorSize;
+        if ((info->blockSize > info->sectorSize) && ((addr % info->blockSize) == 0) && (size >= info->blockSize)) {
+            inst = info->blockErase;
+            step = info->blockSize;
+        }
+
+        uint8_t header[0x05];
+        size_t hlen = SFLASH_SPIHeader(header, inst, info->addrSize, addr, 0);
+        err = SFLASH_SPIRegWrite(hsflash, header, hlen);
+    }
+
+    DEV_SPI_PeriphClose(hsflash->periph);
+
+    return (err);
+}
+
+/* Driver ------------------------------------------------------------------ */
+static MDS_Err_t DDRV_SFLASH_PeriphOpen(DEV_STORAGE_Periph_t *periph, const DRV_SFLASH_Info_t *info)
+{
+    size_t blockNums = info->totalSize / info->sectorSize;
+
+    // the partition is fixed by whoever set up the periph, the driver only checks it fits the flash
+    if ((periph == NULL) || (periph->object.blockNums == 0) || (periph->object.blockBase >= blockNums) ||
+        (periph->object.blockNums > (blockNums - periph->object.blockBase))) {
+        return (MDS_EINVAL);
+    }
+
+    return (MDS_EOK);
+}
+
+static MDS_Err_t DDRV_SFLASH_QSPIControl(const DEV_STORAGE_Adaptr_t *storage, MDS_Item_t cmd, MDS_Arg_t *arg)
+{
+    DRV_SFLASH_QSPIHandle_t *hsflash = (DRV_SFLASH_QSPIHandle_t *)(storage->handle);
+
+    switch (cmd) {
+        case MDS_DEVICE_CMD_INIT:
+            return (DRV_SFLASH_QSPIProbe(hsflash, 0x04));
+        case MDS_DEVICE_CMD_DEINIT:
+            return (MDS_EOK);
+        case MDS_DEVICE_CMD_HANDLESZ:
+            MDS_DEVICE_ARG_HANDLE_SIZE(arg, DRV_SFLASH_QSPIHandle_t);
+            return (MDS_EOK);
+        case MDS_DEVICE_CMD_OPEN:
+            return (DDRV_SFLASH_PeriphOpen((DEV_STORAGE_Periph_t *)arg, &(hsflash->info)));
+        case MDS_DEVICE_CMD_CLOSE:
+            return (MDS_EOK);
+        default:
+            break;
+    }
+
+    return (MDS_EPERM);
+}
+
+static MDS_Err_t DDRV_SFLASH_DSPIControl(const DEV_STORAGE_Adaptr_t *storage, MDS_Item_t cmd, MDS_Arg_t *arg)
+{
+    if (cmd == MDS_DEVICE_CMD_INIT) {
+        return (DRV_SFLASH_QSPIProbe((DRV_SFLASH_QSPIHandle_t *)(storage->handle), 0x02));
+    }
+
+    return (DDRV_SFLASH_QSPIControl(storage, cmd, arg));
+}
+
+static size_t DDRV_SFLASH_QSPIBlockSize(const DEV_STORAGE_Adaptr_t *storage, size_t blk)
+{
+    const DRV_SFLASH_QSPIHandle_t *hsflash = (const DRV_SFLASH_QSPIHandle_t *)(storage->handle);
+
+    return ((blk < (hsflash->info.totalSize / hsflash->info.sectorSize)) ? (hsflash->info.sectorSize) : (0));
+}
+
+static MDS_Err_t DDRV_SFLASH_QSPIRead(const DEV_STORAGE_Periph_t *periph, size_t blk, uintptr_t ofs, uint8_t *buff,
+                                      size_t len)
+{
+    DRV_SFLASH_QSPIHandle_t *hsflash = (DRV_SFLASH_QSPIHandle_t *)(periph->mount->handle);
+
+    return (DRV_SFLASH_QSPIRead(hsflash, (blk * hsflash->info.sectorSize) + ofs, buff, len));
+}
+
+static MDS_Err_t DDRV_SFLASH_QSPIProgram(const DEV_STORAGE_Periph_t *periph, size_t blk, uintptr_t ofs,
+                                         const uint8_t *buff, size_t len)
+{
+    DRV_SFLASH_QSPIHandle_t *hsflash = (DRV_SFLASH_QSPIHandle_t *)(periph->mount->handle);
+
+    return (DRV_SFLASH_QSPIProgram(hsflash, (blk * hsflash->info.sectorSize) + ofs, buff, len));
+}
+
+static MDS_Err_t DDRV_SFLASH_QSPIErase(const DEV_STORAGE_Periph_t *periph, size_t blk, size_t nums)
+{
+    DRV_SFLASH_QSPIHandle_t *hsflash = (DRV_SFLASH_QSPIHandle_t *)(periph->mount->handle);
+
+    return (DRV_SFLASH_QSPIErase(hsflash, blk * hsflash->info.sectorSize, nums * hsflash->info.sectorSize));
+}
+
+static MDS_Err_t DDRV_SFLASH_SPIControl(const DEV_STORAGE_Adaptr_t *storage, MDS_Item_t cmd, MDS_Arg_t *arg)
+{
+    DRV_SFLASH_SPIHandle_t *hsflash = (DRV_SFLASH_SPIHandle_t *)(storage->handle);
+
+    switch (cmd) {
+        case MDS_DEVICE_CMD_INIT:
+            return (DRV_SFLASH_SPIProbe(hsflash));
+        case MDS_DEVICE_CMD_DEINIT:
+            return (MDS_EOK);
+        case MDS_DEVICE_CMD_HANDLESZ:
+            MDS_DEVICE_ARG_HANDLE_SIZE(arg, DRV_SFLASH_SPIHandle_t);
+            return (MDS_EOK);
+        case MDS_DEVICE_CMD_OPEN:
+            return (DDRV_SFLASH_PeriphOpen((DEV_STORAGE_Periph_t *)arg, &(hsflash->info)));
+        case MDS_DEVICE_CMD_CLOSE:
+            return (MDS_EOK);
+        default:
+            break;
+    }
+
+    return (MDS_EPERM);
+}
+
+static size_t DDRV_SFLASH_SPIBlockSize(const DEV_STORAGE_Adaptr_t *storage, size_t blk)
+{
+    const DRV_SFLASH_SPIHandle_t *hsflash = (const DRV_SFLASH_SPIHandle_t *)(storage->handle);
+
+    return ((blk < (hsflash->info.totalSize / hsflash->info.sectorSize)) ? (hsflash->info.sectorSize) : (0));
+}
+
+static MDS_Err_t DDRV_SFLASH_SPIRead(const DEV_STORAGE_Periph_t *periph, size_t blk, uintptr_t ofs, uint8_t *buff,
+                                     size_t len)
+{
+    DRV_SFLASH_SPIHandle_t *hsflash = (DRV_SFLASH_SPIHandle_t *)(periph->mount->handle);
+
+    return (DRV_SFLASH_SPIRead(hsflash, (blk * hsflash->info.sectorSize) + ofs, buff, len));
+}
+
+static MDS_Err_t DDRV_SFLASH_SPIProgram(const DEV_STORAGE_Periph_t *periph, size_t blk, uintptr_t ofs,
+                                        const uint8_t *buff, size_t len)
+{
+    DRV_SFLASH_SPIHandle_t *hsflash = (DRV_SFLASH_SPIHandle_t *)(periph->mount->handle);
+
+    return (DRV_SFLASH_SPIProgram(hsflash, (blk * hsflash->info.sectorSize) + ofs, buff, len));
+}
+
+static MDS_Err_t DDRV_SFLASH_SPIErase(const DEV_STORAGE_Periph_t *periph, size_t blk, size_t nums)
+{
+    DRV_SFLASH_SPIHandle_t *hsflash = (DRV_SFLASH_SPIHandle_t *)(periph->mount->handle);
+
+    return (DRV_SFLASH_SPIErase(hsflash, blk * hsflash->info.sectorSize, nums * hsflash->info.sectorSize));
+}
+
+const DEV_STORAGE_Driver_t G_DRV_SFLASH_QSPI = {
+    .control = DDRV_SFLASH_QSPIControl,
+    .blksize = DDRV_SFLASH_QSPIBlockSize,
+    .read = DDRV_SFLASH_QSPIRead,
+    .prog = DDRV_SFLASH_QSPIProgram,
+    .erase = DDRV_SFLASH_QSPIErase,
 };
 
 const DEV_STORAGE_Driver_t G_DRV_SFLASH_DSPI = {
-
+    .control = DDRV_SFLASH_DSPIControl,
+    .blksize = DDRV_SFLASH_QSPIBlockSize,
+    .read = DDRV_SFLASH_QSPIRead,
+    .prog = DDRV_SFLASH_QSPIProgram,
+    .erase = DDRV_SFLASH_QSPIErase,
 };
 
 const DEV_STORAGE_Driver_t G_DRV_SFLASH_SPI = {
-
+    .control = DDRV_SFLASH_SPIControl,
+    .blksize = DDRV_SFLASH_SPIBlockSize,
+    .read = DDRV_SFLASH_SPIRead,
+    .prog = DDRV_SFLASH_SPIProgram,
+    .erase = DDRV_SFLASH_SPIErase,
 };
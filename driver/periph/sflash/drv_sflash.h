@@ -1,15 +1,84 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
 #ifndef __DRV_SFLASH_H__
 #define __DRV_SFLASH_H__
 
+/* Include ----------------------------------------------------------------- */
 #include "dev_storage.h"
 #include "dev_qspi.h"
 #include "dev_spi.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Typedef ----------------------------------------------------------------- */
+/*
+ * Geometry and command set, filled from the JEDEC SFDP tables on init (falls back to the JEDEC ID).
+ * blockSize/blockErase is the largest uniform erase, used when a whole aligned block is erased.
+ */
+typedef struct DRV_SFLASH_Info {
+    uint32_t totalSize;
+    uint32_t pageSize;
+    uint32_t sectorSize;
+    uint32_t blockSize;
+    uint8_t jedecId[0x03];
+    uint8_t addrSize;     // address bytes, 3 or 4
+    uint8_t sectorErase;
+    uint8_t blockErase;
+    uint8_t readCmd;
+    uint8_t readAddrLine; // 1, 2 or 4
+    uint8_t readDataLine; // 1, 2 or 4
+    uint8_t readMode;     // mode clocks sent as alternate bytes
+    uint8_t readDummy;    // dummy clocks
+    uint8_t progCmd;
+    uint8_t quadEnable;   // JESD216 QER
+} DRV_SFLASH_Info_t;
+
 typedef struct DRV_SFLASH_QSPIHandle {
     DEV_QSPI_Periph_t *periph;
     MDS_Tick_t timeout;
 
-    int8_t addrWord;
+    DRV_SFLASH_Info_t info;
 } DRV_SFLASH_QSPIHandle_t;
 
+typedef struct DRV_SFLASH_SPIHandle {
+    DEV_SPI_Periph_t *periph;
+    MDS_Tick_t timeout;
+
+    DRV_SFLASH_Info_t info;
+} DRV_SFLASH_SPIHandle_t;
+
+/* Funtcion ---------------------------------------------------------------- */
+extern MDS_Err_t DRV_SFLASH_WriteEnable(DRV_SFLASH_QSPIHandle_t *hsflash, bool enabled);
+extern MDS_Err_t DRV_SFLASH_QSPIProbe(DRV_SFLASH_QSPIHandle_t *hsflash, uint8_t lineMax);
+extern MDS_Err_t DRV_SFLASH_QSPIRead(DRV_SFLASH_QSPIHandle_t *hsflash, uint32_t addr, uint8_t *buff, size_t len);
+extern MDS_Err_t DRV_SFLASH_QSPIProgram(DRV_SFLASH_QSPIHandle_t *hsflash, uint32_t addr, const uint8_t *buff,
+                                        size_t len);
+extern MDS_Err_t DRV_SFLASH_QSPIErase(DRV_SFLASH_QSPIHandle_t *hsflash, uint32_t addr, size_t size);
+
+extern MDS_Err_t DRV_SFLASH_SPIProbe(DRV_SFLASH_SPIHandle_t *hsflash);
+extern MDS_Err_t DRV_SFLASH_SPIRead(DRV_SFLASH_SPIHandle_t *hsflash, uint32_t addr, uint8_t *buff, size_t len);
+extern MDS_Err_t DRV_SFLASH_SPIProgram(DRV_SFLASH_SPIHandle_t *hsflash, uint32_t addr, const uint8_t *buff,
+                                       size_t len);
+extern MDS_Err_t DRV_SFLASH_SPIErase(DRV_SFLASH_SPIHandle_t *hsflash, uint32_t addr, size_t size);
+
+/* Driver ------------------------------------------------------------------ */
+extern const DEV_STORAGE_Driver_t G_DRV_SFLASH_QSPI;
+extern const DEV_STORAGE_Driver_t G_DRV_SFLASH_DSPI;
+extern const DEV_STORAGE_Driver_t G_DRV_SFLASH_SPI;
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __DRV_SFLASH_H__ */
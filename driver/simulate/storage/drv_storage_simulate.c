@@ -0,0 +1,341 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "drv_storage_simulate.h"
+#include <stdio.h>
+
+/* Define ------------------------------------------------------------------ */
+#define STORAGE_SIMULATE_CHUNK_SIZE 256
+
+/* Function ---------------------------------------------------------------- */
+__attribute__((weak)) void DRV_STORAGE_SimulateDelay(const DRV_STORAGE_SimulateHandle_t *hsim, uint32_t ns)
+{
+    UNUSED(hsim);
+    UNUSED(ns);
+}
+
+static uint32_t STORAGE_SimulateRandom(DRV_STORAGE_SimulateHandle_t *hsim)
+{
+    uint32_t value = (hsim->faultSeed != 0) ? (hsim->faultSeed) : (0x9E3779B9U);
+
+    value ^= value << 13;
+    value ^= value >> 17;
+    value ^= value << 5;
+    hsim->faultSeed = value;
+
+    return (value);
+}
+
+static bool STORAGE_SimulateFault(DRV_STORAGE_SimulateHandle_t *hsim)
+{
+    if (hsim->faultCount == 0) {
+        return (false);
+    }
+
+    hsim->faultCount -= 1;
+    if (hsim->faultCount == 0) {
+        hsim->powerLost = true;
+    }
+
+    return (hsim->powerLost);
+}
+
+static void STORAGE_SimulateBusy(DRV_STORAGE_SimulateHandle_t *hsim, uint32_t ns)
+{
+    hsim->stats.busyNs += ns;
+
+    if (ns > 0) {
+        DRV_STORAGE_SimulateDelay(hsim, ns);
+    }
+}
+
+static MDS_Err_t STORAGE_SimulateImageRead(DRV_STORAGE_SimulateHandle_t *hsim, size_t addr, uint8_t *buff, size_t len)
+{
+    FILE *fp = (FILE *)(hsim->fp);
+
+    if (fp == NULL) {
+        MDS_MemBuffCopy(buff, len, hsim->buff + addr, len);
+        return (MDS_EOK);
+    }
+
+    if ((fseek(fp, (long)addr, SEEK_SET) != 0) || (fread(buff, 1, len, fp) != len)) {
+        return (MDS_EIO);
+    }
+
+    return (MDS_EOK);
+}
+
+static MDS_Err_t STORAGE_SimulateImageWrite(DRV_STORAGE_SimulateHandle_t *hsim, size_t addr, const uint8_t *buff,
+                                            size_t len)
+{
+    FILE *fp = (FILE *)(hsim->fp);
+
+    if (fp == NULL) {
+        MDS_MemBuffCopy(hsim->buff + addr, len, buff, len);
+        return (MDS_EOK);
+    }
+
+    if ((fseek(fp, (long)addr, SEEK_SET) != 0) || (fwrite(buff, 1, len, fp) != len) || (fflush(fp) != 0)) {
+        return (MDS_EIO);
+    }
+
+    return (MDS_EOK);
+}
+
+MDS_Err_t DRV_STORAGE_SimulateInit(DRV_STORAGE_SimulateHandle_t *hsim)
+{
+    MDS_ASSERT(hsim != NULL);
+
+    size_t totalSize = hsim->blockSize * hsim->blockNums;
+    if ((totalSize == 0) || ((hsim->file == NULL) && (hsim->buff == NULL))) {
+        return (MDS_EINVAL);
+    }
+
+    hsim->fp = NULL;
+    hsim->powerLost = false;
+    MDS_MemBuffSet(&(hsim->stats), 0, sizeof(hsim->stats));
+
+    if (hsim->file == NULL) {
+        return (MDS_EOK);
+    }
+
+    FILE *fp = fopen(hsim->file, "r+b");
+    if (fp == NULL) {
+        fp = fopen(hsim->file, "w+b");
+    }
+    if ((fp == NULL) || (fseek(fp, 0, SEEK_END) != 0)) {
+        return (MDS_EIO);
+    }
+
+    // grow a new or short image with erased blocks
+    uint8_t erased[STORAGE_SIMULATE_CHUNK_SIZE];
+    MDS_MemBuffSet(erased, 0xFF, sizeof(erased));
+    for (long size = ftell(fp); (size >= 0) && ((size_t)size < totalSize); size = ftell(fp)) {
+        size_t len = ((totalSize - size) > sizeof(erased)) ? (sizeof(erased)) : (totalSize - size);
+        if (fwrite(erased, 1, len, fp) != len) {
+            fclose(fp);
+            return (MDS_EIO);
+        }
+    }
+    fflush(fp);
+
+    hsim->fp = fp;
+
+    return (MDS_EOK);
+}
+
+MDS_Err_t DRV_STORAGE_SimulateDeInit(DRV_STORAGE_SimulateHandle_t *hsim)
+{
+    MDS_ASSERT(hsim != NULL);
+
+    if (hsim->fp != NULL) {
+        fclose((FILE *)(hsim->fp));
+        hsim->fp = NULL;
+    }
+
+    return (MDS_EOK);
+}
+
+MDS_Err_t DRV_STORAGE_SimulateRead(DRV_STORAGE_SimulateHandle_t *hsim, size_t addr, uint8_t *buff, size_t len)
+{
+    MDS_ASSERT(hsim != NULL);
+    MDS_ASSERT(buff != NULL);
+
+    if ((addr + len) > (hsim->blockSize * hsim->blockNums)) {
+        return (MDS_EINVAL);
+    }
+
+    MDS_Err_t err = STORAGE_SimulateImageRead(hsim, addr, buff, len);
+
+    hsim->stats.readCount += 1;
+    hsim->stats.readBytes += len;
+    STORAGE_SimulateBusy(hsim, hsim->readNs + (hsim->readByteNs * len));
+
+    return (err);
+}
+
+MDS_Err_t DRV_STORAGE_SimulateProgram(DRV_STORAGE_SimulateHandle_t *hsim, size_t addr, const uint8_t *buff,
+                                      size_t len)
+{
+    MDS_ASSERT(hsim != NULL);
+    MDS_ASSERT(buff != NULL);
+
+    if ((addr + len) > (hsim->blockSize * hsim->blockNums)) {
+        return (MDS_EINVAL);
+    }
+
+    if (hsim->powerLost) {
+        return (MDS_EIO);
+    }
+
+    // a torn program lands a random prefix and leaves the next byte half programmed
+    bool torn = STORAGE_SimulateFault(hsim);
+    size_t cnt = (torn) ? (STORAGE_SimulateRandom(hsim) % (len + 1)) : (len);
+
+    MDS_Err_t err = MDS_EOK;
+    uint8_t chunk[STORAGE_SIMULATE_CHUNK_SIZE];
+    for (size_t ofs = 0; (err == MDS_EOK) && (ofs < len) && (ofs <= cnt); ofs += sizeof(chunk)) {
+        size_t size = ((len - ofs) > sizeof(chunk)) ? (sizeof(chunk)) : (len - ofs);
+        err = STORAGE_SimulateImageRead(hsim, addr + ofs, chunk, size);
+        for (size_t idx = 0; (err == MDS_EOK) && (idx < size); idx++) {
+            if ((ofs + idx) < cnt) {
+                chunk[idx] &= buff[ofs + idx];
+            } else if ((ofs + idx) == cnt) {
+                chunk[idx] &= buff[ofs + idx] | (uint8_t)STORAGE_SimulateRandom(hsim);
+            }
+        }
+        if (err == MDS_EOK) {
+            err = STORAGE_SimulateImageWrite(hsim, addr + ofs, chunk, size);
+        }
+    }
+
+    hsim->stats.progCount += 1;
+    hsim->stats.progBytes += len;
+    STORAGE_SimulateBusy(hsim, hsim->progNs + (hsim->progByteNs * len));
+
+    return ((torn) ? (MDS_EIO) : (err));
+}
+
+MDS_Err_t DRV_STORAGE_SimulateErase(DRV_STORAGE_SimulateHandle_t *hsim, size_t blk, size_t nums)
+{
+    MDS_ASSERT(hsim != NULL);
+
+    if ((blk + nums) > hsim->blockNums) {
+        return (MDS_EINVAL);
+    }
+
+    if (hsim->powerLost) {
+        return (MDS_EIO);
+    }
+
+    // a torn erase clears a random prefix and leaves the rest with random bits set
+    bool torn = STORAGE_SimulateFault(hsim);
+    size_t cnt = (torn) ? (STORAGE_SimulateRandom(hsim) % (nums * hsim->blockSize + 1)) : (nums * hsim->blockSize);
+
+    MDS_Err_t err = MDS_EOK;
+    uint8_t chunk[STORAGE_SIMULATE_CHUNK_SIZE];
+    for (size_t idx = 0; (err == MDS_EOK) && (idx < nums); idx++) {
+        if (hsim->wear != NULL) {
+            if ((hsim->wearLimit != 0) && (hsim->wear[blk + idx] >= hsim->wearLimit)) {
+                err = MDS_EIO;
+                break;
+            }
+            hsim->wear[blk + idx] += 1;
+        }
+
+        for (size_t ofs = 0; (err == MDS_EOK) && (ofs < hsim->blockSize); ofs += sizeof(chunk)) {
+            size_t pos = (idx * hsim->blockSize) + ofs;
+            size_t size = ((hsim->blockSize - ofs) > sizeof(chunk)) ? (sizeof(chunk)) : (hsim->blockSize - ofs);
+            if ((pos + size) <= cnt) {
+                MDS_MemBuffSet(chunk, 0xFF, size);
+            } else {
+                err = STORAGE_SimulateImageRead(hsim, (blk * hsim->blockSize) + pos, chunk, size);
+                for (size_t cur = 0; cur < size; cur++) {
+                    chunk[cur] |= ((pos + cur) < cnt) ? (0xFF) : ((uint8_t)STORAGE_SimulateRandom(hsim));
+                }
+            }
+            if (err == MDS_EOK) {
+                err = STORAGE_SimulateImageWrite(hsim, (blk * hsim->blockSize) + pos, chunk, size);
+            }
+        }
+    }
+
+    hsim->stats.eraseCount += nums;
+    STORAGE_SimulateBusy(hsim, hsim->eraseNs * nums);
+
+    return ((torn) ? (MDS_EIO) : (err));
+}
+
+void DRV_STORAGE_SimulatePowerFail(DRV_STORAGE_SimulateHandle_t *hsim, size_t count, uint32_t seed)
+{
+    MDS_ASSERT(hsim != NULL);
+
+    hsim->faultCount = count;
+    hsim->faultSeed = seed;
+}
+
+void DRV_STORAGE_SimulatePowerOn(DRV_STORAGE_SimulateHandle_t *hsim)
+{
+    MDS_ASSERT(hsim != NULL);
+
+    hsim->faultCount = 0;
+    hsim->powerLost = false;
+}
+
+/* Driver ------------------------------------------------------------------ */
+static MDS_Err_t DDRV_STORAGE_Control(const DEV_STORAGE_Adaptr_t *storage, MDS_Item_t cmd, MDS_Arg_t *arg)
+{
+    DRV_STORAGE_SimulateHandle_t *hsim = (DRV_STORAGE_SimulateHandle_t *)(storage->handle);
+
+    switch (cmd) {
+        case MDS_DEVICE_CMD_INIT:
+            return (DRV_STORAGE_SimulateInit(hsim));
+        case MDS_DEVICE_CMD_DEINIT:
+            return (DRV_STORAGE_SimulateDeInit(hsim));
+        case MDS_DEVICE_CMD_HANDLESZ:
+            MDS_DEVICE_ARG_HANDLE_SIZE(arg, DRV_STORAGE_SimulateHandle_t);
+            return (MDS_EOK);
+        case MDS_DEVICE_CMD_OPEN: {
+            // the partition is fixed by whoever set up the periph, the driver only checks it fits the device
+            DEV_STORAGE_Periph_t *periph = (DEV_STORAGE_Periph_t *)arg;
+            if ((periph == NULL) || (periph->object.blockNums == 0) || (periph->object.blockBase >= hsim->blockNums) ||
+                (periph->object.blockNums > (hsim->blockNums - periph->object.blockBase))) {
+                return (MDS_EINVAL);
+            }
+            return (MDS_EOK);
+        }
+        case MDS_DEVICE_CMD_CLOSE:
+            return (MDS_EOK);
+        default:
+            break;
+    }
+
+    return (MDS_EPERM);
+}
+
+static size_t DDRV_STORAGE_BlockSize(const DEV_STORAGE_Adaptr_t *storage, size_t blk)
+{
+    const DRV_STORAGE_SimulateHandle_t *hsim = (const DRV_STORAGE_SimulateHandle_t *)(storage->handle);
+
+    return ((blk < hsim->blockNums) ? (hsim->blockSize) : (0));
+}
+
+static MDS_Err_t DDRV_STORAGE_Read(const DEV_STORAGE_Periph_t *periph, size_t blk, uintptr_t ofs, uint8_t *buff,
+                                   size_t len)
+{
+    DRV_STORAGE_SimulateHandle_t *hsim = (DRV_STORAGE_SimulateHandle_t *)(periph->mount->handle);
+
+    return (DRV_STORAGE_SimulateRead(hsim, (blk * hsim->blockSize) + ofs, buff, len));
+}
+
+static MDS_Err_t DDRV_STORAGE_Program(const DEV_STORAGE_Periph_t *periph, size_t blk, uintptr_t ofs,
+                                      const uint8_t *buff, size_t len)
+{
+    DRV_STORAGE_SimulateHandle_t *hsim = (DRV_STORAGE_SimulateHandle_t *)(periph->mount->handle);
+
+    return (DRV_STORAGE_SimulateProgram(hsim, (blk * hsim->blockSize) + ofs, buff, len));
+}
+
+static MDS_Err_t DDRV_STORAGE_Erase(const DEV_STORAGE_Periph_t *periph, size_t blk, size_t nums)
+{
+    DRV_STORAGE_SimulateHandle_t *hsim = (DRV_STORAGE_SimulateHandle_t *)(periph->mount->handle);
+
+    return (DRV_STORAGE_SimulateErase(hsim, blk, nums));
+}
+
+const DEV_STORAGE_Driver_t G_DRV_STORAGE_SIMULATE = {
+    .control = DDRV_STORAGE_Control,
+    .blksize = DDRV_STORAGE_BlockSize,
+    .read = DDRV_STORAGE_Read,
+    .prog = DDRV_STORAGE_Program,
+    .erase = DDRV_STORAGE_Erase,
+};
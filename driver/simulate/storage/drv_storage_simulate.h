@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+#ifndef __DRV_STORAGE_SIMULATE_H__
+#define __DRV_STORAGE_SIMULATE_H__
+
+/* Include ----------------------------------------------------------------- */
+#include "dev_storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Typedef ----------------------------------------------------------------- */
+typedef struct DRV_STORAGE_SimulateStats {
+    size_t readCount;
+    size_t readBytes;
+    size_t progCount;
+    size_t progBytes;
+    size_t eraseCount;
+    uint64_t busyNs;  // modelled device time of all operations
+} DRV_STORAGE_SimulateStats_t;
+
+/*
+ * NOR flash model: program only clears bits, erase sets a whole block to 0xFF.
+ * The image lives in buff, or in a host file when file is set (created erased when missing).
+ */
+typedef struct DRV_STORAGE_SimulateHandle {
+    uint8_t *buff;
+    const char *file;
+    size_t blockSize;
+    size_t blockNums;
+
+    uint32_t readNs;       // per read command
+    uint32_t readByteNs;   // per byte read
+    uint32_t progNs;       // per program command
+    uint32_t progByteNs;   // per byte programmed
+    uint32_t eraseNs;      // per block erased
+    uint32_t *wear;        // optional erase counter per block
+    uint32_t wearLimit;    // erase fails with MDS_EIO once a block reached it, 0 is unlimited
+
+    size_t faultCount;     // program/erase operations left before the power loss, 0 is disarmed
+    uint32_t faultSeed;
+    bool powerLost;        // set by the torn operation, program/erase fail until power on
+
+    void *fp;
+    DRV_STORAGE_SimulateStats_t stats;
+} DRV_STORAGE_SimulateHandle_t;
+
+/* Funtcion ---------------------------------------------------------------- */
+extern MDS_Err_t DRV_STORAGE_SimulateInit(DRV_STORAGE_SimulateHandle_t *hsim);
+extern MDS_Err_t DRV_STORAGE_SimulateDeInit(DRV_STORAGE_SimulateHandle_t *hsim);
+extern MDS_Err_t DRV_STORAGE_SimulateRead(DRV_STORAGE_SimulateHandle_t *hsim, size_t addr, uint8_t *buff, size_t len);
+extern MDS_Err_t DRV_STORAGE_SimulateProgram(DRV_STORAGE_SimulateHandle_t *hsim, size_t addr, const uint8_t *buff,
+                                             size_t len);
+extern MDS_Err_t DRV_STORAGE_SimulateErase(DRV_STORAGE_SimulateHandle_t *hsim, size_t blk, size_t nums);
+extern void DRV_STORAGE_SimulatePowerFail(DRV_STORAGE_SimulateHandle_t *hsim, size_t count, uint32_t seed);
+extern void DRV_STORAGE_SimulatePowerOn(DRV_STORAGE_SimulateHandle_t *hsim);
+
+/* weak, latency is only accounted in stats.busyNs unless a real delay is provided */
+extern void DRV_STORAGE_SimulateDelay(const DRV_STORAGE_SimulateHandle_t *hsim, uint32_t ns);
+
+/* Driver ------------------------------------------------------------------ */
+extern const DEV_STORAGE_Driver_t G_DRV_STORAGE_SIMULATE;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DRV_STORAGE_SIMULATE_H__ */
@@ -179,7 +179,9 @@ static inline void MDS_PutU32LE(uint8_t *array, uint32_t value)
 extern bool MDS_MemAddrIsAligned(const void *address, uintptr_t align);
 extern void *MDS_MemBuffSet(void *dst, int c, size_t len);
 extern size_t MDS_MemBuffCopy(void *dst, size_t size, const void *src, size_t len);
+extern void *MDS_MemBuffCpy(void *dst, const void *src, size_t size);
 extern void *MDS_MemBuffCcpy(void *dst, const void *src, int c, size_t size);
+extern int MDS_MemBuffCmp(const void *buf1, const void *buf2, size_t size);
 
 /* Message ----------------------------------------------------------------- */
 typedef struct MDS_MsgList {
@@ -19,6 +19,11 @@
 extern "C" {
 #endif
 
+/* Define ------------------------------------------------------------------ */
+#ifndef MDS_DEVICE_HOOK_SIZE
+#define MDS_DEVICE_HOOK_SIZE 1
+#endif
+
 /* Typedef ----------------------------------------------------------------- */
 typedef enum MDS_DeviceCmd {
     MDS_DEVICE_CMD_INIT,
@@ -47,7 +52,7 @@ typedef struct MDS_DevDriver {
 
 struct MDS_Device {
     MDS_Object_t object;
-    void (*hook)(const MDS_Device_t *device, MDS_DeviceCmd_t cmd);
+    void (*hook[MDS_DEVICE_HOOK_SIZE])(const MDS_Device_t *device, MDS_DeviceCmd_t cmd);
 };
 
 struct MDS_DevModule {
@@ -90,8 +95,11 @@ typedef struct MDS_DevDumpData {
 
 /* Function ---------------------------------------------------------------- */
 extern MDS_Device_t *MDS_DeviceFind(const char *name);
-extern void MDS_DeviceRegisterHook(const MDS_Device_t *device,
-                                   void (*hook)(const MDS_Device_t *device, MDS_DeviceCmd_t cmd));
+/* same concurrency rule as MDS_HOOK_INIT: unregister shifts later hooks down, the chain ends at the first NULL */
+extern MDS_Err_t MDS_DeviceRegisterHook(const MDS_Device_t *device,
+                                        void (*hook)(const MDS_Device_t *device, MDS_DeviceCmd_t cmd));
+extern MDS_Err_t MDS_DeviceUnregisterHook(const MDS_Device_t *device,
+                                          void (*hook)(const MDS_Device_t *device, MDS_DeviceCmd_t cmd));
 
 extern MDS_Err_t MDS_DevModuleInit(MDS_DevModule_t *module, const char *name, const MDS_DevDriver_t *driver,
                                    MDS_DevHandle_t *handle, const MDS_Arg_t *init);
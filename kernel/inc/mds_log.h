@@ -64,6 +64,12 @@ extern size_t MDS_LOG_CompressSturctPrint(MDS_LOG_Compress_t *log, size_t level,
 extern void MDS_LOG_VaPrintf(size_t level, const char *fmt, size_t cnt, va_list ap);
 extern void MDS_LOG_Printf(size_t level, const char *fmt, size_t cnt, ...);
 
+#if (defined(MDS_LOG_DEFERRED) && (MDS_LOG_DEFERRED > 0))
+extern void MDS_LOG_DeferredInit(void (*sink)(const MDS_LOG_Compress_t *log, size_t len));
+extern size_t MDS_LOG_DeferredFlush(void);
+extern size_t MDS_LOG_DeferredDrops(void);
+#endif
+
 #if (MDS_LOG_BUILD_LEVEL >= MDS_LOG_LEVEL_THROUGH)
 #define MDS_LOG_T(fmt, ...)                                                                                            \
     do {                                                                                                               \
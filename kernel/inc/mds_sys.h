@@ -28,6 +28,16 @@ extern "C" {
 #define MDS_SYSMEM_ALIGN_SIZE sizeof(uintptr_t)
 #endif
 
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+#ifndef MDS_MEMHEAP_TLSF_SL_LOG2
+#define MDS_MEMHEAP_TLSF_SL_LOG2 3
+#endif
+
+#ifndef MDS_MEMHEAP_TLSF_FL_COUNT
+#define MDS_MEMHEAP_TLSF_FL_COUNT 16
+#endif
+#endif
+
 extern void MDS_SysMemInit(void);
 extern void MDS_SysMemFree(void *ptr);
 extern void *MDS_SysMemAlloc(size_t size);
@@ -70,6 +80,8 @@ static inline void MDS_SysCountDelay(MDS_Tick_t delay)
 
 /* Core -------------------------------------------------------------------- */
 extern void MDS_CoreIdleSleep(void);
+extern MDS_Tick_t MDS_CoreIdleTickless(MDS_Tick_t sleepTick);
+extern size_t MDS_CoreCycleCount(void);
 
 typedef void (*MDS_IsrHandler_t)(MDS_Arg_t *);
 extern MDS_Err_t MDS_CoreInterruptRequestRegister(MDS_Item_t irq, MDS_IsrHandler_t handler, MDS_Arg_t *arg);
@@ -153,6 +165,9 @@ typedef struct MDS_Object {
     MDS_ListNode_t node;
     MDS_ObjectType_t type;
     uint16_t flags;
+#if (defined(MDS_OBJECT_HASH_SIZE) && (MDS_OBJECT_HASH_SIZE > 0))
+    struct MDS_Object *hash;
+#endif
     char name[MDS_OBJECT_NAME_SIZE];
 } MDS_Object_t;
 
@@ -178,10 +193,15 @@ extern void MDS_KernelExitCritical(void);
 extern size_t MDS_KernelGetCritical(void);
 extern MDS_Tick_t MDS_KernelGetSleepTick(void);
 extern void MDS_KernelCompensateTick(MDS_Tick_t tickcount);
+extern void MDS_KernelIdleSleep(void);
 
 extern MDS_Thread_t *MDS_KernelGetIdleThread(void);
 extern MDS_Err_t MDS_KernelAddIdleHook(void (*hook)(void));
 extern MDS_Err_t MDS_KernelDelIdleHook(void (*hook)(void));
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+extern uint64_t MDS_KernelGetIdleTime(void);
+extern size_t MDS_KernelGetCpuLoad(void);
+#endif
 
 /* Timer ------------------------------------------------------------------- */
 #ifndef MDS_TIMER_SKIPLIST_LEVEL
@@ -227,6 +247,12 @@ extern bool MDS_TimerIsActived(const MDS_Timer_t *timer);
 #define MDS_THREAD_PRIORITY_MAX 32
 #endif
 
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+#ifndef MDS_THREAD_EDF_PRIORITY
+#define MDS_THREAD_EDF_PRIORITY (MDS_THREAD_PRIORITY_MAX / 2)
+#endif
+#endif
+
 typedef void (*MDS_ThreadEntry_t)(MDS_Arg_t *arg);
 
 typedef uint8_t MDS_ThreadPriority_t;
@@ -260,9 +286,29 @@ struct MDS_Thread {
 
     MDS_ThreadPriority_t initPrio;
     MDS_ThreadPriority_t currPrio;
+    MDS_ListNode_t mutexList;
+    MDS_Mutex_t *pendMutex;
     uint8_t state;
     uint8_t eventOpt;
     MDS_Mask_t eventMask;
+
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+    uint64_t runTime;
+#endif
+
+#if (defined(MDS_THREAD_STACK_WATERMARK) && (MDS_THREAD_STACK_WATERMARK > 0))
+    size_t stackFree;
+#endif
+
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+    MDS_Tick_t edfPeriod;
+    MDS_Tick_t edfBudget;
+    MDS_Tick_t edfRelative;
+    MDS_Tick_t edfRelease;
+    MDS_Tick_t edfDeadline;
+    MDS_Tick_t edfRemain;
+    size_t edfMiss;
+#endif
 };
 
 extern MDS_Err_t MDS_ThreadInit(MDS_Thread_t *thread, const char *name, MDS_ThreadEntry_t entry, MDS_Arg_t *arg,
@@ -278,6 +324,18 @@ extern MDS_Err_t MDS_ThreadYield(void);
 extern MDS_Err_t MDS_ThreadDelay(MDS_Tick_t delay);
 extern MDS_Err_t MDS_ThreadChangePriority(MDS_Thread_t *thread, MDS_ThreadPriority_t priority);
 extern MDS_ThreadState_t MDS_ThreadGetState(const MDS_Thread_t *thread);
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+extern uint64_t MDS_ThreadGetRunTime(const MDS_Thread_t *thread);
+#endif
+#if (defined(MDS_THREAD_STACK_WATERMARK) && (MDS_THREAD_STACK_WATERMARK > 0))
+extern size_t MDS_ThreadGetStackMaxUsed(const MDS_Thread_t *thread);
+#endif
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+extern MDS_Err_t MDS_ThreadSetDeadline(MDS_Thread_t *thread, MDS_Tick_t period, MDS_Tick_t budget,
+                                       MDS_Tick_t deadline);
+extern MDS_Err_t MDS_ThreadWaitPeriod(void);
+extern size_t MDS_ThreadGetDeadlineMiss(const MDS_Thread_t *thread);
+#endif
 
 /* Semaphore --------------------------------------------------------------- */
 struct MDS_Semaphore {
@@ -309,6 +367,7 @@ extern MDS_Err_t MDS_ConditionWait(MDS_Condition_t *condition, MDS_Mutex_t *mute
 struct MDS_Mutex {
     MDS_Object_t object;
     MDS_ListNode_t list;
+    MDS_ListNode_t node;
 
     MDS_Thread_t *owner;
     MDS_ThreadPriority_t priority;
@@ -371,6 +430,7 @@ struct MDS_MsgQueue {
 
     void *queBuff;
     size_t msgSize;
+    size_t msgNums;
 
     void *lfree;
     void *lhead;
@@ -390,6 +450,14 @@ extern MDS_Err_t MDS_MsgQueueSendMsg(MDS_MsgQueue_t *msgQueue, const MDS_MsgList
 extern MDS_Err_t MDS_MsgQueueSend(MDS_MsgQueue_t *msgQueue, const void *buff, size_t len, MDS_Tick_t timeout);
 extern MDS_Err_t MDS_MsgQueueUrgentMsg(MDS_MsgQueue_t *msgQueue, const MDS_MsgList_t *msgList);
 extern MDS_Err_t MDS_MsgQueueUrgent(MDS_MsgQueue_t *msgQueue, const void *buff, size_t len);
+extern MDS_Err_t MDS_MsgQueueSendAcquire(MDS_MsgQueue_t *msgQueue, void *send, MDS_Tick_t timeout);
+extern MDS_Err_t MDS_MsgQueueSendCommit(MDS_MsgQueue_t *msgQueue, void *send, size_t len, bool urgent);
+/* batches use a fixed stride: message idx lives at buff + idx * len (send) or buff + idx * size (recv) */
+extern MDS_Err_t MDS_MsgQueueSendBatch(MDS_MsgQueue_t *msgQueue, const void *buff, size_t len, size_t nums,
+                                       size_t *cnt, MDS_Tick_t timeout);
+/* lens (may be NULL) holds nums entries and receives the copied length of every message */
+extern MDS_Err_t MDS_MsgQueueRecvBatch(MDS_MsgQueue_t *msgQueue, void *buff, size_t size, size_t nums, size_t *lens,
+                                       size_t *cnt, MDS_Tick_t timeout);
 extern size_t MDS_MsgQueueGetMsgSize(const MDS_MsgQueue_t *msgQueue);
 extern size_t MDS_MsgQueueGetMsgCount(const MDS_MsgQueue_t *msgQueue);
 extern size_t MDS_MsgQueueGetMsgFree(const MDS_MsgQueue_t *msgQueue);
@@ -403,6 +471,7 @@ struct MDS_MemPool {
     size_t blkSize;
 
     void *lfree;
+    size_t blkFree;
 };
 
 extern MDS_Err_t MDS_MemPoolInit(MDS_MemPool_t *memPool, const char *name, void *memBuff, size_t bufSize,
@@ -420,7 +489,14 @@ struct MDS_MemHeap {
     MDS_Object_t object;
 
     MDS_Semaphore_t sem;
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+    uintptr_t limit;
+    uint32_t flBitmap;
+    uint32_t slBitmap[MDS_MEMHEAP_TLSF_FL_COUNT];
+    void *blocks[MDS_MEMHEAP_TLSF_FL_COUNT][1U << MDS_MEMHEAP_TLSF_SL_LOG2];
+#else
     uintptr_t lfree, limit;
+#endif
 #if (defined(MDS_MEMHEAP_STATS) && (MDS_MEMHEAP_STATS > 0))
     size_t cur, max;
 #endif
@@ -432,72 +508,122 @@ extern void MDS_MemHeapFree(void *ptr);
 extern void *MDS_MemHeapAlloc(MDS_MemHeap_t *memheap, size_t size);
 extern void *MDS_MemHeapCalloc(MDS_MemHeap_t *memheap, size_t nmemb, size_t size);
 extern void *MDS_MemHeapRealloc(MDS_MemHeap_t *memheap, void *ptr, size_t size);
+extern void *MDS_MemHeapAlignedAlloc(MDS_MemHeap_t *memheap, size_t align, size_t size);
 
 /* Hook -------------------------------------------------------------------- */
 #if (defined(MDS_HOOK_ENABLE) && (MDS_HOOK_ENABLE > 0))
-extern void MDS_HOOK_SCHEDULER_SWITCH_Register(void (*hook)(MDS_Thread_t *toThread, MDS_Thread_t *fromThread));
+#ifndef MDS_HOOK_CHAIN_SIZE
+#define MDS_HOOK_CHAIN_SIZE 2
+#endif
 
-extern void MDS_HOOK_TIMER_ENTER_Register(void (*hook)(MDS_Timer_t *timer));
-extern void MDS_HOOK_TIMER_EXIT_Register(void (*hook)(MDS_Timer_t *timer));
-extern void MDS_HOOK_TIMER_START_Register(void (*hook)(MDS_Timer_t *timer));
-extern void MDS_HOOK_TIMER_STOP_Register(void (*hook)(MDS_Timer_t *timer));
+#define MDS_HOOK_DECLARE(type, ...)                                                                                    \
+    extern MDS_Err_t MDS_HOOK_##type##_Register(void (*hook)(__VA_ARGS__));                                            \
+    extern MDS_Err_t MDS_HOOK_##type##_Unregister(void (*hook)(__VA_ARGS__))
 
-extern void MDS_HOOK_THREAD_INIT_Register(void (*hook)(MDS_Thread_t *thread));
-extern void MDS_HOOK_THREAD_EXIT_Register(void (*hook)(MDS_Thread_t *thread));
-extern void MDS_HOOK_THREAD_RESUME_Register(void (*hook)(MDS_Thread_t *thread));
-extern void MDS_HOOK_THREAD_SUSPEND_Register(void (*hook)(MDS_Thread_t *thread));
+MDS_HOOK_DECLARE(SCHEDULER_SWITCH, MDS_Thread_t *toThread, MDS_Thread_t *fromThread);
 
-extern void MDS_HOOK_SEMAPHORE_TRY_ACQUIRE_Register(void (*hook)(MDS_Semaphore_t *semaphore, MDS_Tick_t timeout));
-extern void MDS_HOOK_SEMAPHORE_HAS_ACQUIRE_Register(void (*hook)(MDS_Semaphore_t *semaphore, MDS_Err_t err));
-extern void MDS_HOOK_SEMAPHORE_HAS_RELEASE_Register(void (*hook)(MDS_Semaphore_t *semaphore));
+MDS_HOOK_DECLARE(TIMER_ENTER, MDS_Timer_t *timer);
+MDS_HOOK_DECLARE(TIMER_EXIT, MDS_Timer_t *timer);
+MDS_HOOK_DECLARE(TIMER_START, MDS_Timer_t *timer);
+MDS_HOOK_DECLARE(TIMER_STOP, MDS_Timer_t *timer);
 
-extern void MDS_HOOK_MUTEX_TRY_ACQUIRE_Register(void (*hook)(MDS_Mutex_t *mutex, MDS_Tick_t timeout));
-extern void MDS_HOOK_MUTEX_HAS_ACQUIRE_Register(void (*hook)(MDS_Mutex_t *mutex, MDS_Err_t err));
-extern void MDS_HOOK_MUTEX_HAS_RELEASE_Register(void (*hook)(MDS_Mutex_t *mutex));
+MDS_HOOK_DECLARE(THREAD_INIT, MDS_Thread_t *thread);
+MDS_HOOK_DECLARE(THREAD_EXIT, MDS_Thread_t *thread);
+MDS_HOOK_DECLARE(THREAD_RESUME, MDS_Thread_t *thread);
+MDS_HOOK_DECLARE(THREAD_SUSPEND, MDS_Thread_t *thread);
 
-extern void MDS_HOOK_EVENT_TRY_ACQUIRE_Register(void (*hook)(MDS_Event_t *event, MDS_Tick_t timeout));
-extern void MDS_HOOK_EVENT_HAS_ACQUIRE_Register(void (*hook)(MDS_Event_t *event, MDS_Err_t err));
-extern void MDS_HOOK_EVENT_HAS_SET_Register(void (*hook)(MDS_Event_t *event, MDS_Mask_t mask));
-extern void MDS_HOOK_EVENT_HAS_CLR_Register(void (*hook)(MDS_Event_t *event, MDS_Mask_t mask));
+MDS_HOOK_DECLARE(SEMAPHORE_TRY_ACQUIRE, MDS_Semaphore_t *semaphore, MDS_Tick_t timeout);
+MDS_HOOK_DECLARE(SEMAPHORE_HAS_ACQUIRE, MDS_Semaphore_t *semaphore, MDS_Err_t err);
+MDS_HOOK_DECLARE(SEMAPHORE_HAS_RELEASE, MDS_Semaphore_t *semaphore);
 
-extern void MDS_HOOK_MSGQUEUE_TRY_RECV_Register(void (*hook)(MDS_MsgQueue_t *msgQueue, MDS_Tick_t timeout));
-extern void MDS_HOOK_MSGQUEUE_HAS_RECV_Register(void (*hook)(MDS_MsgQueue_t *msgQueue, MDS_Err_t err));
-extern void MDS_HOOK_MSGQUEUE_TRY_SEND_Register(void (*hook)(MDS_MsgQueue_t *msgQueue, MDS_Tick_t timeout));
-extern void MDS_HOOK_MSGQUEUE_HAS_SEND_Register(void (*hook)(MDS_MsgQueue_t *msgQueue, MDS_Err_t err));
+MDS_HOOK_DECLARE(MUTEX_TRY_ACQUIRE, MDS_Mutex_t *mutex, MDS_Tick_t timeout);
+MDS_HOOK_DECLARE(MUTEX_HAS_ACQUIRE, MDS_Mutex_t *mutex, MDS_Err_t err);
+MDS_HOOK_DECLARE(MUTEX_HAS_RELEASE, MDS_Mutex_t *mutex);
 
-extern void MDS_HOOK_MEMPOOL_TRY_ALLOC_Register(void (*hook)(MDS_MemPool_t *memPool, MDS_Tick_t timeout));
-extern void MDS_HOOK_MEMPOOL_HAS_ALLOC_Register(void (*hook)(MDS_MemPool_t *memPool, void *ptr));
-extern void MDS_HOOK_MEMPOOL_HAS_FREE_Register(void (*hook)(MDS_MemPool_t *memPool, void *ptr));
+MDS_HOOK_DECLARE(EVENT_TRY_ACQUIRE, MDS_Event_t *event, MDS_Tick_t timeout);
+MDS_HOOK_DECLARE(EVENT_HAS_ACQUIRE, MDS_Event_t *event, MDS_Err_t err);
+MDS_HOOK_DECLARE(EVENT_HAS_SET, MDS_Event_t *event, MDS_Mask_t mask);
+MDS_HOOK_DECLARE(EVENT_HAS_CLR, MDS_Event_t *event, MDS_Mask_t mask);
 
-extern void MDS_HOOK_MEMHEAP_INIT_Register(void (*hook)(MDS_MemHeap_t *memheap, void *heapBegin, void *heapLimit,
-                                                        size_t metaSize));
-extern void MDS_HOOK_MEMHEAP_ALLOC_Register(void (*hook)(MDS_MemHeap_t *memheap, void *ptr, size_t size));
-extern void MDS_HOOK_MEMHEAP_FREE_Register(void (*hook)(MDS_MemHeap_t *memheap, void *ptr));
-extern void MDS_HOOK_MEMHEAP_REALLOC_Register(void (*hook)(MDS_MemHeap_t *memheap, void *old, void *new, size_t size));
+MDS_HOOK_DECLARE(MSGQUEUE_TRY_RECV, MDS_MsgQueue_t *msgQueue, MDS_Tick_t timeout);
+MDS_HOOK_DECLARE(MSGQUEUE_HAS_RECV, MDS_MsgQueue_t *msgQueue, MDS_Err_t err);
+MDS_HOOK_DECLARE(MSGQUEUE_TRY_SEND, MDS_MsgQueue_t *msgQueue, MDS_Tick_t timeout);
+MDS_HOOK_DECLARE(MSGQUEUE_HAS_SEND, MDS_MsgQueue_t *msgQueue, MDS_Err_t err);
 
-extern void MDS_HOOK_INTERRUPT_ENTER_Register(void (*hook)(MDS_Item_t irq));
-extern void MDS_HOOK_INTERRUPT_EXIT_Register(void (*hook)(MDS_Item_t irq));
+MDS_HOOK_DECLARE(MEMPOOL_TRY_ALLOC, MDS_MemPool_t *memPool, MDS_Tick_t timeout);
+MDS_HOOK_DECLARE(MEMPOOL_HAS_ALLOC, MDS_MemPool_t *memPool, void *ptr);
+MDS_HOOK_DECLARE(MEMPOOL_HAS_FREE, MDS_MemPool_t *memPool, void *ptr);
 
+MDS_HOOK_DECLARE(MEMHEAP_INIT, MDS_MemHeap_t *memheap, void *heapBegin, void *heapLimit, size_t metaSize);
+MDS_HOOK_DECLARE(MEMHEAP_ALLOC, MDS_MemHeap_t *memheap, void *ptr, size_t size);
+MDS_HOOK_DECLARE(MEMHEAP_FREE, MDS_MemHeap_t *memheap, void *ptr);
+MDS_HOOK_DECLARE(MEMHEAP_REALLOC, MDS_MemHeap_t *memheap, void *old, void *new, size_t size);
+
+MDS_HOOK_DECLARE(INTERRUPT_ENTER, MDS_Item_t irq);
+MDS_HOOK_DECLARE(INTERRUPT_EXIT, MDS_Item_t irq);
+
+/* register/unregister may preempt a running call: removal shifts later hooks down and drops the count last, so the call
+ * may skip one hook or still run the removed one once; keep a hook callable until every call started before is done */
 #define MDS_HOOK_INIT(type, ...)                                                                                       \
-    static void (*g_hook_##type)(__VA_ARGS__) = NULL;                                                                  \
-    void MDS_HOOK_##type##_Register(void (*hook)(__VA_ARGS__))                                                         \
+    static size_t g_hookNums_##type = 0;                                                                               \
+    static void (*g_hook_##type[MDS_HOOK_CHAIN_SIZE])(__VA_ARGS__) = {NULL};                                           \
+    MDS_Err_t MDS_HOOK_##type##_Register(void (*hook)(__VA_ARGS__))                                                    \
     {                                                                                                                  \
-        g_hook_##type = hook;                                                                                          \
+        if (hook == NULL) {                                                                                            \
+            return (MDS_EINVAL);                                                                                       \
+        }                                                                                                              \
+                                                                                                                       \
+        MDS_Err_t err = MDS_ENOMEM;                                                                                    \
+        register MDS_Item_t lock = MDS_CoreInterruptLock();                                                            \
+        for (size_t idx = 0; idx < g_hookNums_##type; idx++) {                                                         \
+            if (g_hook_##type[idx] == hook) {                                                                          \
+                err = MDS_EEXIST;                                                                                      \
+                break;                                                                                                 \
+            }                                                                                                          \
+        }                                                                                                              \
+        if ((err != MDS_EEXIST) && (g_hookNums_##type < MDS_HOOK_CHAIN_SIZE)) {                                        \
+            g_hook_##type[g_hookNums_##type] = hook;                                                                   \
+            g_hookNums_##type += 1;                                                                                    \
+            err = MDS_EOK;                                                                                             \
+        }                                                                                                              \
+        MDS_CoreInterruptRestore(lock);                                                                                \
+                                                                                                                       \
+        return (err);                                                                                                  \
+    }                                                                                                                  \
+    MDS_Err_t MDS_HOOK_##type##_Unregister(void (*hook)(__VA_ARGS__))                                                  \
+    {                                                                                                                  \
+        MDS_Err_t err = MDS_ENOENT;                                                                                    \
+        register MDS_Item_t lock = MDS_CoreInterruptLock();                                                            \
+        for (size_t idx = 0; idx < g_hookNums_##type; idx++) {                                                         \
+            if (g_hook_##type[idx] == hook) {                                                                          \
+                for (; (idx + 1) < g_hookNums_##type; idx++) {                                                         \
+                    g_hook_##type[idx] = g_hook_##type[idx + 1];                                                       \
+                }                                                                                                      \
+                g_hookNums_##type -= 1;                                                                                \
+                err = MDS_EOK;                                                                                         \
+                break;                                                                                                 \
+            }                                                                                                          \
+        }                                                                                                              \
+        MDS_CoreInterruptRestore(lock);                                                                                \
+                                                                                                                       \
+        return (err);                                                                                                  \
     }
 
 #define MDS_HOOK_CALL(type, ...)                                                                                       \
     do {                                                                                                               \
-        if (g_hook_##type != NULL) {                                                                                   \
-            g_hook_##type(__VA_ARGS__);                                                                                \
+        for (size_t hookIdx = 0; hookIdx < g_hookNums_##type; hookIdx++) {                                             \
+            g_hook_##type[hookIdx](__VA_ARGS__);                                                                       \
         }                                                                                                              \
     } while (0)
 
-#define MDS_HOOK_REGISTER(type, ...) MDS_HOOK_##type##_Register(__VA_ARGS__)
+#define MDS_HOOK_REGISTER(type, ...)   MDS_HOOK_##type##_Register(__VA_ARGS__)
+#define MDS_HOOK_UNREGISTER(type, ...) MDS_HOOK_##type##_Unregister(__VA_ARGS__)
 
 #else
 #define MDS_HOOK_INIT(type, ...)
 #define MDS_HOOK_CALL(type, ...)
 #define MDS_HOOK_REGISTER(type, ...)
+#define MDS_HOOK_UNREGISTER(type, ...)
 #endif
 
 #ifdef __cplusplus
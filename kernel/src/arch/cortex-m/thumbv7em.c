@@ -44,6 +44,30 @@ struct SCB_Typedef {
 
 #define SCB ((struct SCB_Typedef *)0xE000ED00)
 
+struct SysTick_Typedef {
+    volatile uint32_t CTRL;
+    volatile uint32_t LOAD;
+    volatile uint32_t VAL;
+    volatile uint32_t CALIB;
+};
+
+#define SysTick ((struct SysTick_Typedef *)0xE000E010)
+
+struct DWT_Typedef {
+    volatile uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+};
+
+#define DWT   ((struct DWT_Typedef *)0xE0001000)
+#define DEMCR (*(volatile uint32_t *)0xE000EDFC)
+
+#define SYSTICK_CTRL_ENABLE    0x00000001U
+#define SYSTICK_CTRL_COUNTFLAG 0x00010000U
+#define SYSTICK_LOAD_MAX       0x00FFFFFFU
+#define SCB_ICSR_PENDSTSET     0x04000000U
+#define DEMCR_TRCENA           0x01000000U
+#define DWT_CTRL_CYCCNTENA     0x00000001U
+
 /* Exception ---------------------------------------------------------------
  * MSP                                !< 0 Stack
  * Reset_Handler                      !< 1 Reset
@@ -167,6 +191,71 @@ inline void MDS_CoreIdleSleep(void)
     __asm volatile("wfi");
 }
 
+size_t MDS_CoreCycleCount(void)
+{
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA) == 0U) {
+        DEMCR |= DEMCR_TRCENA;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA;
+    }
+
+    return (DWT->CYCCNT);
+}
+
+#if (defined(MDS_KERNEL_TICKLESS) && (MDS_KERNEL_TICKLESS > 0))
+MDS_Tick_t MDS_CoreIdleTickless(MDS_Tick_t sleepTick)
+{
+    uint32_t reload = SysTick->LOAD + 1U;
+    MDS_Tick_t maxTick = SYSTICK_LOAD_MAX / reload;
+
+    if (sleepTick > maxTick) {
+        sleepTick = maxTick;
+    }
+    if (sleepTick <= 1) {
+        MDS_CoreIdleSleep();
+        return (0);
+    }
+
+    SysTick->CTRL &= ~SYSTICK_CTRL_ENABLE;
+    uint32_t remain = SysTick->VAL;
+    if (((SCB->ICSR & SCB_ICSR_PENDSTSET) != 0U) || (remain == 0U)) {
+        SysTick->CTRL |= SYSTICK_CTRL_ENABLE;
+        return (0);
+    }
+
+    uint32_t sleepLoad = remain + (reload * (sleepTick - 1)) - 1U;
+    SysTick->LOAD = sleepLoad;
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SYSTICK_CTRL_ENABLE;
+
+    __asm volatile("dsb");
+    __asm volatile("wfi");
+    __asm volatile("isb");
+
+    uint32_t ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SYSTICK_CTRL_ENABLE;
+
+    MDS_Tick_t tickDelta;
+    uint32_t nextLoad;
+    if ((ctrl & SYSTICK_CTRL_COUNTFLAG) != 0U) {
+        uint32_t passed = sleepLoad - SysTick->VAL;
+        tickDelta = sleepTick - 1;
+        nextLoad = (passed < reload) ? (reload - passed) : (reload);
+    } else {
+        uint32_t passed = (reload - remain) + (sleepLoad - SysTick->VAL);
+        tickDelta = passed / reload;
+        nextLoad = reload - (passed % reload);
+    }
+
+    SysTick->LOAD = nextLoad - 1U;
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SYSTICK_CTRL_ENABLE;
+    SysTick->LOAD = reload - 1U;
+
+    return (tickDelta);
+}
+#endif
+
 /* CoreInterrupt ----------------------------------------------------------- */
 #if (defined(MDS_INTERRUPT_IRQ_NUMS) && (MDS_INTERRUPT_IRQ_NUMS > 0))
 static __attribute__((section(".mds.isr"))) struct {
@@ -0,0 +1,365 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "mds_sys.h"
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+
+/* Hook -------------------------------------------------------------------- */
+MDS_HOOK_INIT(INTERRUPT_ENTER, MDS_Item_t irq);
+MDS_HOOK_INIT(INTERRUPT_EXIT, MDS_Item_t irq);
+
+/* Define ------------------------------------------------------------------ */
+#ifndef MDS_CORE_POSIX_HEAP_SIZE
+#define MDS_CORE_POSIX_HEAP_SIZE (1024 * 1024)
+#endif
+
+#ifndef MDS_SYSTICK_FREQ_HZ
+#define MDS_SYSTICK_FREQ_HZ 1000
+#endif
+
+#ifndef MDS_CORE_POSIX_STACK_MIN
+#define MDS_CORE_POSIX_STACK_MIN 0x4000
+#endif
+
+#define CORE_SYSTICK_SIGNAL SIGALRM
+#define CORE_SYSTICK_IRQ    0x0F
+#define CORE_WAKEUP_SIGNAL  SIGUSR1
+
+#define CORE_STRINGIFY(x) #x
+#define CORE_TOSTRING(x)  CORE_STRINGIFY(x)
+
+/* Variable ---------------------------------------------------------------- */
+static sigset_t g_coreSysTickSigset;
+static volatile size_t g_coreSysTickPending = 0;
+static volatile sig_atomic_t g_coreInterruptNest = 0;
+static volatile MDS_Item_t g_coreInterruptCurrent = 0;
+
+/* Heap -------------------------------------------------------------------- */
+__asm(".pushsection .bss.mds.heap, \"aw\", @nobits    \n"
+      ".balign      16                                \n"
+      ".globl       __HeapBase                        \n"
+      "__HeapBase:                                    \n"
+      ".skip        " CORE_TOSTRING(MDS_CORE_POSIX_HEAP_SIZE) "\n"
+      ".globl       __HeapLimit                       \n"
+      "__HeapLimit:                                   \n"
+      ".popsection                                    \n");
+
+/* CoreFunction ------------------------------------------------------------ */
+void MDS_CoreIdleSleep(void)
+{
+    sigset_t mask;
+
+    pthread_sigmask(SIG_SETMASK, NULL, &mask);
+    sigdelset(&mask, CORE_SYSTICK_SIGNAL);
+    sigsuspend(&mask);
+}
+
+size_t MDS_CoreCycleCount(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((size_t)(ts.tv_sec) * 1000000000U + (size_t)(ts.tv_nsec));
+}
+
+/* CoreInterrupt ----------------------------------------------------------- */
+size_t MDS_CoreInterruptNest(void)
+{
+    return (g_coreInterruptNest);
+}
+
+MDS_Item_t MDS_CoreInterruptCurrent(void)
+{
+    return ((g_coreInterruptNest > 0) ? (g_coreInterruptCurrent) : (0));
+}
+
+MDS_Item_t MDS_CoreInterruptLock(void)
+{
+    sigset_t oldset;
+
+    pthread_sigmask(SIG_BLOCK, &g_coreSysTickSigset, &oldset);
+
+    return (sigismember(&oldset, CORE_SYSTICK_SIGNAL));
+}
+
+void MDS_CoreInterruptRestore(MDS_Item_t lock)
+{
+    if (lock == 0) {
+        pthread_sigmask(SIG_UNBLOCK, &g_coreSysTickSigset, NULL);
+    }
+}
+
+/* CoreThread -------------------------------------------------------------- */
+struct StackFrame {
+    ucontext_t context;
+    void *entry;
+    void *arg;
+    void *exit;
+};
+
+static void CORE_ThreadEntry(uint32_t high, uint32_t low)
+{
+    struct StackFrame *stack = (struct StackFrame *)((((uintptr_t)(high) << 16) << 16) | (uintptr_t)(low));
+
+    ((void (*)(void *))(stack->entry))(stack->arg);
+    ((void (*)(void))(stack->exit))();
+
+    for (;;) {
+        MDS_CoreIdleSleep();
+    }
+}
+
+void *MDS_CoreThreadStackInit(void *stackBase, size_t stackSize, void *entry, void *arg, void *exit)
+{
+    uintptr_t sp = VALUE_ALIGN((uintptr_t)(stackBase) + stackSize, sizeof(uint64_t) + sizeof(uint64_t));
+    struct StackFrame *stack = (struct StackFrame *)(VALUE_ALIGN(sp - sizeof(struct StackFrame), sizeof(uint64_t)));
+
+    MDS_ASSERT((uintptr_t)(stack) > ((uintptr_t)(stackBase) + MDS_CORE_POSIX_STACK_MIN));
+
+    MDS_MemBuffSet(stackBase, '@', stackSize);
+
+    getcontext(&(stack->context));
+    sigemptyset(&(stack->context.uc_sigmask));
+#if (defined(MDS_KERNEL_TICKLESS) && (MDS_KERNEL_TICKLESS > 0))
+    sigaddset(&(stack->context.uc_sigmask), CORE_WAKEUP_SIGNAL);
+#endif
+    stack->context.uc_link = NULL;
+    stack->context.uc_stack.ss_sp = stackBase;
+    stack->context.uc_stack.ss_size = (uintptr_t)(stack) - (uintptr_t)(stackBase);
+    stack->context.uc_stack.ss_flags = 0;
+    stack->entry = entry;
+    stack->arg = arg;
+    stack->exit = exit;
+
+    makecontext(&(stack->context), (void (*)(void))CORE_ThreadEntry, 0x02, (uint32_t)(((uintptr_t)(stack) >> 16) >> 16),
+                (uint32_t)((uintptr_t)(stack)));
+
+    return (stack);
+}
+
+bool MDS_CoreThreadStackCheck(MDS_Thread_t *thread)
+{
+    MDS_ASSERT(thread != NULL);
+
+    if (((*(uint8_t *)(thread->stackBase)) != '@') ||
+        ((uintptr_t)(thread->stackPoint) <= (uintptr_t)(thread->stackBase)) ||
+        ((uintptr_t)(thread->stackPoint) > ((uintptr_t)(thread->stackBase) + (uintptr_t)(thread->stackSize)))) {
+        MDS_LOG_F("[CORE] thread(%p) entry:%p stackpoint:%p stackbase:%p stacksize:%u overflow", thread, thread->entry,
+                  thread->stackPoint, thread->stackBase, thread->stackSize);
+        return (false);
+    }
+
+    return (true);
+}
+
+/* CoreScheduler ----------------------------------------------------------- */
+#if (defined(MDS_THREAD_PRIORITY_MAX) && (MDS_THREAD_PRIORITY_MAX > 0))
+static struct CoreScheduler {
+    uintptr_t swflag;
+    uintptr_t *fromSP;
+    uintptr_t *toSP;
+    pthread_t mainThread;
+    pthread_t tickThread;
+} g_coreScheduler;
+
+#if (defined(MDS_KERNEL_TICKLESS) && (MDS_KERNEL_TICKLESS > 0))
+static struct CoreTickless {
+    pthread_mutex_t mutex;
+    MDS_Tick_t sleepTick;
+    MDS_Tick_t elapsed;
+} g_coreTickless = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+static void CORE_WakeupHandler(int sig)
+{
+    UNUSED(sig);
+}
+
+/* raised under the mutex, so a tick is either pending before the idle sleep starts or counted as elapsed */
+static void CORE_SysTickRaise(void)
+{
+    int sig = CORE_SYSTICK_SIGNAL;
+
+    pthread_mutex_lock(&(g_coreTickless.mutex));
+    if (g_coreTickless.sleepTick != 0) {
+        g_coreTickless.elapsed += 1;
+        if (g_coreTickless.elapsed < g_coreTickless.sleepTick) {
+            sig = 0;
+        } else {
+            g_coreTickless.sleepTick = 0;
+            sig = CORE_WAKEUP_SIGNAL;
+        }
+    } else {
+        __atomic_add_fetch(&g_coreSysTickPending, 1, __ATOMIC_ACQ_REL);
+    }
+    if (sig != 0) {
+        pthread_kill(g_coreScheduler.mainThread, sig);
+    }
+    pthread_mutex_unlock(&(g_coreTickless.mutex));
+}
+
+MDS_Tick_t MDS_CoreIdleTickless(MDS_Tick_t sleepTick)
+{
+    sigset_t mask;
+
+    pthread_mutex_lock(&(g_coreTickless.mutex));
+    if (__atomic_load_n(&g_coreSysTickPending, __ATOMIC_ACQUIRE) != 0) {
+        pthread_mutex_unlock(&(g_coreTickless.mutex));
+        return (0);
+    }
+    g_coreTickless.elapsed = 0;
+    g_coreTickless.sleepTick = sleepTick;
+    pthread_mutex_unlock(&(g_coreTickless.mutex));
+
+    pthread_sigmask(SIG_SETMASK, NULL, &mask);
+    sigdelset(&mask, CORE_WAKEUP_SIGNAL);
+    sigsuspend(&mask);
+
+    pthread_mutex_lock(&(g_coreTickless.mutex));
+    g_coreTickless.sleepTick = 0;
+    MDS_Tick_t elapsed = g_coreTickless.elapsed;
+    pthread_mutex_unlock(&(g_coreTickless.mutex));
+
+    return (elapsed);
+}
+#endif
+
+static void CORE_SchedulerSwitchProcess(void)
+{
+    if (g_coreScheduler.swflag != false) {
+        g_coreScheduler.swflag = false;
+
+        swapcontext((ucontext_t *)(*(g_coreScheduler.fromSP)), (ucontext_t *)(*(g_coreScheduler.toSP)));
+    }
+}
+
+static void CORE_SysTickHandler(int sig)
+{
+    UNUSED(sig);
+
+    MDS_Item_t irq = g_coreInterruptCurrent;
+    g_coreInterruptCurrent = CORE_SYSTICK_IRQ;
+    g_coreInterruptNest += 1;
+
+    // a signal raised while the previous one is still pending merges into it, the counter keeps every tick
+    MDS_HOOK_CALL(INTERRUPT_ENTER, CORE_SYSTICK_IRQ);
+    for (size_t ticks = __atomic_exchange_n(&g_coreSysTickPending, 0, __ATOMIC_ACQ_REL); ticks > 0; ticks--) {
+        MDS_SysTickIncCount();
+    }
+    MDS_HOOK_CALL(INTERRUPT_EXIT, CORE_SYSTICK_IRQ);
+
+    g_coreInterruptNest -= 1;
+    g_coreInterruptCurrent = irq;
+
+    if (g_coreInterruptNest == 0) {
+        CORE_SchedulerSwitchProcess();
+    }
+}
+
+static void *CORE_SysTickThread(void *arg)
+{
+    UNUSED(arg);
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    for (;;) {
+        ts.tv_nsec += 1000000000L / MDS_SYSTICK_FREQ_HZ;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_nsec -= 1000000000L;
+            ts.tv_sec += 1;
+        }
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+        }
+
+#if (defined(MDS_KERNEL_TICKLESS) && (MDS_KERNEL_TICKLESS > 0))
+        CORE_SysTickRaise();
+#else
+        __atomic_add_fetch(&g_coreSysTickPending, 1, __ATOMIC_ACQ_REL);
+        pthread_kill(g_coreScheduler.mainThread, CORE_SYSTICK_SIGNAL);
+#endif
+    }
+
+    return (NULL);
+}
+
+void MDS_CoreSchedulerStartup(void *toSP)
+{
+    struct sigaction sa;
+
+    sigemptyset(&g_coreSysTickSigset);
+    sigaddset(&g_coreSysTickSigset, CORE_SYSTICK_SIGNAL);
+    pthread_sigmask(SIG_BLOCK, &g_coreSysTickSigset, NULL);
+
+    MDS_MemBuffSet(&sa, 0, sizeof(sa));
+    sa.sa_handler = CORE_SysTickHandler;
+    sa.sa_flags = SA_RESTART;
+    sigfillset(&(sa.sa_mask));
+    sigaction(CORE_SYSTICK_SIGNAL, &sa, NULL);
+
+#if (defined(MDS_KERNEL_TICKLESS) && (MDS_KERNEL_TICKLESS > 0))
+    // keep the wakeup pending until sigsuspend in MDS_CoreIdleTickless, a thread context must not unblock it
+    sigset_t wakeup;
+    sigemptyset(&wakeup);
+    sigaddset(&wakeup, CORE_WAKEUP_SIGNAL);
+    pthread_sigmask(SIG_BLOCK, &wakeup, NULL);
+
+    sa.sa_handler = CORE_WakeupHandler;
+    sigaction(CORE_WAKEUP_SIGNAL, &sa, NULL);
+#endif
+
+    g_coreScheduler.swflag = false;
+    g_coreScheduler.fromSP = NULL;
+    g_coreScheduler.toSP = toSP;
+    g_coreScheduler.mainThread = pthread_self();
+    if (pthread_create(&(g_coreScheduler.tickThread), NULL, CORE_SysTickThread, NULL) != 0) {
+        MDS_PANIC("posix create systick thread failed");
+    }
+
+    setcontext((ucontext_t *)(*(uintptr_t *)toSP));
+
+    MDS_PANIC("posix scheduler startup failed");
+}
+
+void MDS_CoreSchedulerSwitch(void *fromSP, void *toSP)
+{
+    if (g_coreScheduler.swflag == false) {
+        g_coreScheduler.swflag = true;
+        g_coreScheduler.fromSP = fromSP;
+    }
+
+    g_coreScheduler.toSP = toSP;
+
+    if (g_coreInterruptNest == 0) {
+        CORE_SchedulerSwitchProcess();
+    }
+}
+#endif
+
+/* Exception --------------------------------------------------------------- */
+__attribute__((weak)) void MDS_CoreExceptionCallback(void)
+{
+}
+
+#if (defined(MDS_CORE_BACKTRACE) && (MDS_CORE_BACKTRACE > 0))
+__attribute__((weak)) void MDS_CoreBackTrace(uintptr_t stackPoint, uintptr_t stackLimit)
+{
+    UNUSED(stackPoint);
+    UNUSED(stackLimit);
+}
+#endif
@@ -346,6 +346,15 @@ inline void MDS_CoreIdleSleep(void)
     __asm volatile("wfi");
 }
 
+size_t MDS_CoreCycleCount(void)
+{
+    size_t cycle;
+
+    __asm volatile("csrr        %0, mcycle" : "=r"(cycle));
+
+    return (cycle);
+}
+
 /* CoreThread -------------------------------------------------------------- */
 void *MDS_CoreThreadStackInit(void *stackBase, size_t stackSize, void *entry, void *arg, void *exit)
 {
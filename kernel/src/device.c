@@ -34,11 +34,71 @@ MDS_Device_t *MDS_DeviceFind(const char *name)
     return (CONTAINER_OF(MDS_ObjectFind(MDS_OBJECT_TYPE_DEVICE, name), MDS_Device_t, object));
 }
 
-void MDS_DeviceRegisterHook(const MDS_Device_t *device, void (*hook)(const MDS_Device_t *device, MDS_DeviceCmd_t cmd))
+MDS_Err_t MDS_DeviceRegisterHook(const MDS_Device_t *device,
+                                 void (*hook)(const MDS_Device_t *device, MDS_DeviceCmd_t cmd))
 {
     MDS_ASSERT(device != NULL);
 
-    ((MDS_Device_t *)device)->hook = hook;
+    MDS_Device_t *dev = (MDS_Device_t *)device;
+    MDS_Err_t err = MDS_ENOMEM;
+
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    if (hook == NULL) {
+        for (size_t idx = 0; idx < ARRAY_SIZE(dev->hook); idx++) {
+            dev->hook[idx] = NULL;
+        }
+        err = MDS_EOK;
+    } else {
+        for (size_t idx = 0; idx < ARRAY_SIZE(dev->hook); idx++) {
+            if (dev->hook[idx] == hook) {
+                err = MDS_EEXIST;
+                break;
+            }
+            if (dev->hook[idx] == NULL) {
+                dev->hook[idx] = hook;
+                err = MDS_EOK;
+                break;
+            }
+        }
+    }
+    MDS_CoreInterruptRestore(lock);
+
+    return (err);
+}
+
+MDS_Err_t MDS_DeviceUnregisterHook(const MDS_Device_t *device,
+                                   void (*hook)(const MDS_Device_t *device, MDS_DeviceCmd_t cmd))
+{
+    MDS_ASSERT(device != NULL);
+
+    MDS_Device_t *dev = (MDS_Device_t *)device;
+    MDS_Err_t err = MDS_ENOENT;
+
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    for (size_t idx = 0; (idx < ARRAY_SIZE(dev->hook)) && (dev->hook[idx] != NULL); idx++) {
+        if (dev->hook[idx] == hook) {
+            for (; (idx + 1) < ARRAY_SIZE(dev->hook); idx++) {
+                dev->hook[idx] = dev->hook[idx + 1];
+            }
+            dev->hook[idx] = NULL;
+            err = MDS_EOK;
+            break;
+        }
+    }
+    MDS_CoreInterruptRestore(lock);
+
+    return (err);
+}
+
+static void MDS_DeviceHookCall(const MDS_Device_t *device, MDS_DeviceCmd_t cmd)
+{
+    for (size_t idx = 0; idx < ARRAY_SIZE(device->hook); idx++) {
+        void (*hook)(const MDS_Device_t *device, MDS_DeviceCmd_t cmd) = device->hook[idx];
+        if (hook == NULL) {
+            break;
+        }
+        hook(device, cmd);
+    }
 }
 
 static bool MDS_DeviceIsBusy(MDS_Device_t *device)
@@ -363,14 +423,10 @@ MDS_Err_t MDS_DevPeriphOpen(MDS_DevPeriph_t *periph, MDS_Tick_t timeout)
         return (err);
     }
 
-    if (periph->device.hook != NULL) {
-        periph->device.hook(&(periph->device), MDS_DEVICE_CMD_OPEN);
-    }
+    MDS_DeviceHookCall(&(periph->device), MDS_DEVICE_CMD_OPEN);
 
     if ((adaptr->driver != NULL) && (adaptr->driver->control != NULL)) {
-        if (adaptr->device.hook != NULL) {
-            adaptr->device.hook(&(adaptr->device), MDS_DEVICE_CMD_OPEN);
-        }
+        MDS_DeviceHookCall(&(adaptr->device), MDS_DEVICE_CMD_OPEN);
         err = adaptr->driver->control(&(adaptr->device), MDS_DEVICE_CMD_OPEN, (MDS_Arg_t *)periph);
         if (err != MDS_EOK) {
             MDS_MutexRelease(&(adaptr->mutex));
@@ -400,13 +456,9 @@ MDS_Err_t MDS_DevPeriphClose(MDS_DevPeriph_t *periph)
             if (err != MDS_EOK) {
                 MDS_DEVICE_PRINT("periph(%p) close adaptr(%p) failed err:%d", periph, adaptr);
             }
-            if (adaptr->device.hook != NULL) {
-                adaptr->device.hook(&(adaptr->device), MDS_DEVICE_CMD_CLOSE);
-            }
-        }
-        if (periph->device.hook != NULL) {
-            periph->device.hook(&(periph->device), MDS_DEVICE_CMD_CLOSE);
+            MDS_DeviceHookCall(&(adaptr->device), MDS_DEVICE_CMD_CLOSE);
         }
+        MDS_DeviceHookCall(&(periph->device), MDS_DEVICE_CMD_CLOSE);
         periph->device.object.flags &= ~MDS_DEVICE_FLAG_OPEN;
         adaptr->device.object.flags &= ~MDS_DEVICE_FLAG_OPEN;
 
@@ -464,9 +516,7 @@ const MDS_DevProbeId_t *MDS_DeviceGetId(const MDS_Device_t *device)
 
     const MDS_DevProbeId_t *id = NULL;
 
-    if (device->hook != NULL) {
-        device->hook(device, MDS_DEVICE_CMD_GETID);
-    }
+    MDS_DeviceHookCall(device, MDS_DEVICE_CMD_GETID);
 
     if ((device->object.flags & (MDS_DEVICE_FLAG_MODULE | MDS_DEVICE_FLAG_ADAPTR)) != 0U) {
         MDS_DevModule_t *module = CONTAINER_OF(device, MDS_DevModule_t, device);
@@ -483,9 +533,7 @@ MDS_Device_t *MDS_DeviceProbeDrivers(const MDS_DevDriver_t **driver, const MDS_D
 {
     MDS_ASSERT(device != NULL);
 
-    if (device->hook != NULL) {
-        device->hook(device, MDS_DEVICE_CMD_PROBE);
-    }
+    MDS_DeviceHookCall(device, MDS_DEVICE_CMD_PROBE);
 
     for (size_t idx = 0; idx < drvSize; idx++) {
         if ((drvList[idx].driver == NULL) || (drvList[idx].driver->control == NULL)) {
@@ -511,9 +559,7 @@ MDS_Err_t MDS_DevModuleDump(const MDS_Device_t *device, MDS_DevDumpData_t *dump)
     MDS_ASSERT(device != NULL);
     MDS_ASSERT(dump != NULL);
 
-    if (device->hook != NULL) {
-        device->hook(device, MDS_DEVICE_CMD_DUMP);
-    }
+    MDS_DeviceHookCall(device, MDS_DEVICE_CMD_DUMP);
 
     MDS_DevModule_t *module = CONTAINER_OF(device, MDS_DevModule_t, device);
     MDS_Err_t err = MDS_EIO;
@@ -22,30 +22,83 @@ bool MDS_MemAddrIsAligned(const void *addr, uintptr_t align)
     return (false);
 }
 
+#if (!defined(MDS_LIB_MINIABLE) || (MDS_LIB_MINIABLE == 0))
+#define LIB_WORD_SIZE sizeof(size_t)
+#define LIB_WORD_MASK (sizeof(size_t) - 1U)
+
+#if (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__))
+#define LIB_WORD_MERGE(lo, hi, shift) (((lo) << (shift)) | ((hi) >> ((LIB_WORD_SIZE * MDS_BITS_OF_BYTE) - (shift))))
+#else
+#define LIB_WORD_MERGE(lo, hi, shift) (((lo) >> (shift)) | ((hi) << ((LIB_WORD_SIZE * MDS_BITS_OF_BYTE) - (shift))))
+#endif
+
+static inline void LIB_WordSet(size_t *dst, size_t word, size_t cnt)
+{
+    while (cnt >= 4U) {
+        dst[0] = word;
+        dst[1] = word;
+        dst[2] = word;
+        dst[3] = word;
+        dst += 4U;
+        cnt -= 4U;
+    }
+    while (cnt > 0U) {
+        *dst++ = word;
+        cnt -= 1U;
+    }
+}
+
+static inline void LIB_WordCopy(size_t *dst, const size_t *src, size_t cnt)
+{
+#if (defined(MDS_LIB_BURST) && (MDS_LIB_BURST > 0)) && defined(__ARM_ARCH_7EM__)
+    while (cnt >= 4U) {
+        __asm volatile("ldmia       %1!, {r4, r5, r6, r8}  \n"
+                       "stmia       %0!, {r4, r5, r6, r8}  \n"
+                       : "+r"(dst), "+r"(src)
+                       :
+                       : "r4", "r5", "r6", "r8", "memory");
+        cnt -= 4U;
+    }
+#else
+    while (cnt >= 4U) {
+        size_t w0 = src[0], w1 = src[1], w2 = src[2], w3 = src[3];
+        dst[0] = w0;
+        dst[1] = w1;
+        dst[2] = w2;
+        dst[3] = w3;
+        dst += 4U;
+        src += 4U;
+        cnt -= 4U;
+    }
+#endif
+    while (cnt > 0U) {
+        *dst++ = *src++;
+        cnt -= 1U;
+    }
+}
+#endif
+
 void *MDS_MemBuffSet(void *dst, int c, size_t size)
 {
     register uint8_t *ptr = dst;
     register uint8_t *end = ptr + size;
 
-#if (defined(MDS_LIB_MINIABLE) && (MDS_LIB_MINIABLE > 0))
-    while (ptr < end) {
-        *ptr++ = c;
-    }
-#else
-    while (ptr < end) {
-        if ((((uintptr_t)end - (uintptr_t)ptr) >= sizeof(size_t)) &&
-            (((uintptr_t)ptr - (uintptr_t)dst) >= sizeof(size_t)) && MDS_MemAddrIsAligned(ptr, sizeof(size_t))) {
-            uint8_t *align = ptr - sizeof(size_t);
-            while (((uintptr_t)end - (uintptr_t)ptr) >= sizeof(size_t)) {
-                *((size_t *)ptr) = *((size_t *)align);
-                ptr += sizeof(size_t);
-            }
-        } else {
+#if (!defined(MDS_LIB_MINIABLE) || (MDS_LIB_MINIABLE == 0))
+    if (size >= (LIB_WORD_SIZE << 1)) {
+        while (((uintptr_t)ptr & LIB_WORD_MASK) != 0U) {
             *ptr++ = c;
         }
+
+        size_t cnt = ((uintptr_t)end - (uintptr_t)ptr) / LIB_WORD_SIZE;
+        LIB_WordSet((size_t *)ptr, (size_t)((uint8_t)c) * ((size_t)(-1) / 0xFFU), cnt);
+        ptr += cnt * LIB_WORD_SIZE;
     }
 #endif
 
+    while (ptr < end) {
+        *ptr++ = c;
+    }
+
     return (dst);
 }
 
@@ -55,25 +108,38 @@ size_t MDS_MemBuffCopy(void *dst, size_t size, const void *src, size_t len)
     register const uint8_t *s = src;
     register const uint8_t *e = s + ((len < size) ? (len) : (size));
 
-#if (defined(MDS_LIB_MINIABLE) && (MDS_LIB_MINIABLE > 0))
-    while (s < e) {
-        *d++ = *s++;
-    }
-#else
-    while (s < e) {
-        if (MDS_MemAddrIsAligned(d, sizeof(size_t)) && MDS_MemAddrIsAligned(s, sizeof(size_t)) &&
-            (((uintptr_t)(e - s)) >= sizeof(size_t))) {
-            while (((uintptr_t)(e - s)) >= sizeof(size_t)) {
-                *((size_t *)d) = *((size_t *)s);
-                d += sizeof(size_t);
-                s += sizeof(size_t);
-            }
-        } else {
+#if (!defined(MDS_LIB_MINIABLE) || (MDS_LIB_MINIABLE == 0))
+    if (((uintptr_t)(e - s)) >= (LIB_WORD_SIZE << 1)) {
+        while (((uintptr_t)d & LIB_WORD_MASK) != 0U) {
             *d++ = *s++;
         }
+
+        size_t offset = (uintptr_t)s & LIB_WORD_MASK;
+        if (offset == 0U) {
+            size_t cnt = ((uintptr_t)(e - s)) / LIB_WORD_SIZE;
+            LIB_WordCopy((size_t *)d, (const size_t *)s, cnt);
+            d += cnt * LIB_WORD_SIZE;
+            s += cnt * LIB_WORD_SIZE;
+        } else {
+            /* aligned loads never leave a word holding at least one source byte */
+            const size_t *ws = (const size_t *)(s - offset);
+            size_t shift = offset * MDS_BITS_OF_BYTE;
+            size_t lo = *ws++;
+            while (((uintptr_t)(e - s)) >= (LIB_WORD_SIZE << 1)) {
+                size_t hi = *ws++;
+                *((size_t *)d) = LIB_WORD_MERGE(lo, hi, shift);
+                lo = hi;
+                d += LIB_WORD_SIZE;
+                s += LIB_WORD_SIZE;
+            }
+        }
     }
 #endif
 
+    while (s < e) {
+        *d++ = *s++;
+    }
+
     return ((uintptr_t)d - (uintptr_t)dst);
 }
 
@@ -105,6 +171,42 @@ int MDS_MemBuffCmp(const void *buf1, const void *buf2, size_t size)
     register const uint8_t *p1 = buf1;
     register const uint8_t *p2 = buf2;
 
+#if (!defined(MDS_LIB_MINIABLE) || (MDS_LIB_MINIABLE == 0))
+    if (size >= (LIB_WORD_SIZE << 1)) {
+        while (((uintptr_t)p1 & LIB_WORD_MASK) != 0U) {
+            if (*p1 != *p2) {
+                return (*p1 - *p2);
+            }
+            p1 += 1U;
+            p2 += 1U;
+            size -= 1U;
+        }
+
+        size_t offset = (uintptr_t)p2 & LIB_WORD_MASK;
+        if (offset == 0U) {
+            while ((size >= LIB_WORD_SIZE) && (*((const size_t *)p1) == *((const size_t *)p2))) {
+                p1 += LIB_WORD_SIZE;
+                p2 += LIB_WORD_SIZE;
+                size -= LIB_WORD_SIZE;
+            }
+        } else {
+            const size_t *ws = (const size_t *)(p2 - offset);
+            size_t shift = offset * MDS_BITS_OF_BYTE;
+            size_t lo = *ws++;
+            while (size >= (LIB_WORD_SIZE << 1)) {
+                size_t hi = *ws++;
+                if (*((const size_t *)p1) != LIB_WORD_MERGE(lo, hi, shift)) {
+                    break;
+                }
+                lo = hi;
+                p1 += LIB_WORD_SIZE;
+                p2 += LIB_WORD_SIZE;
+                size -= LIB_WORD_SIZE;
+            }
+        }
+    }
+#endif
+
     while ((size > 0) && (cmp == 0)) {
         cmp = *p1++ - *p2++;
         size -= sizeof(uint8_t);
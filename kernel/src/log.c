@@ -23,22 +23,50 @@
 #define MDS_LOG_COMPRESS_ARG_FIX(x) ((x == 0xFFFFFFFF) ? (0xBDC5CA39) : (x))
 #endif
 
-/* Function ---------------------------------------------------------------- */
-size_t MDS_LOG_CompressStructVa(MDS_LOG_Compress_t *log, size_t level, const char *fmt, size_t cnt, va_list ap)
-{
-    MDS_ASSERT(log != NULL);
+#if (defined(MDS_LOG_DEFERRED) && (MDS_LOG_DEFERRED > 0))
+#ifndef MDS_LOG_DEFERRED_NUMS
+#define MDS_LOG_DEFERRED_NUMS 32
+#endif
 
-    static size_t psn = 0;
+#if ((MDS_LOG_DEFERRED_NUMS & (MDS_LOG_DEFERRED_NUMS - 1)) != 0)
+#error "MDS_LOG_DEFERRED_NUMS must be a power of 2"
+#endif
 
-    register MDS_Item_t lock = MDS_CoreInterruptLock();
-    psn++;
-    MDS_CoreInterruptRestore(lock);
+#ifndef MDS_LOG_DEFERRED_STACKSIZE
+#define MDS_LOG_DEFERRED_STACKSIZE 512
+#endif
+
+#ifndef MDS_LOG_DEFERRED_PRIORITY
+#define MDS_LOG_DEFERRED_PRIORITY (MDS_THREAD_PRIORITY_MAX - 2)
+#endif
+
+#ifndef MDS_LOG_DEFERRED_TICKS
+#define MDS_LOG_DEFERRED_TICKS 10
+#endif
 
+/* Variable ---------------------------------------------------------------- */
+static struct LogDeferred {
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t drops;
+    void (*sink)(const MDS_LOG_Compress_t *log, size_t len);
+    MDS_LOG_Compress_t slot[MDS_LOG_DEFERRED_NUMS];
+} g_logDeferred;
+
+#if (MDS_THREAD_PRIORITY_MAX > 0)
+static MDS_Thread_t g_logDeferredThread;
+static uint8_t g_logDeferredStack[MDS_LOG_DEFERRED_STACKSIZE];
+#endif
+#endif
+
+/* Function ---------------------------------------------------------------- */
+static size_t LOG_CompressFill(MDS_LOG_Compress_t *log, size_t level, const char *fmt, size_t psn, size_t cnt,
+                               va_list ap)
+{
     if (cnt > MDS_LOG_COMPRESS_ARGS_MAX) {
         cnt = MDS_LOG_COMPRESS_ARGS_MAX;
     }
 
-    log->magic = MDS_LOG_COMPRESS_MAGIC;
     log->address = (uintptr_t)fmt & 0x00FFFFFF;
     log->level = level;
     log->count = cnt;
@@ -50,7 +78,22 @@ size_t MDS_LOG_CompressStructVa(MDS_LOG_Compress_t *log, size_t level, const cha
         log->args[idx] = MDS_LOG_COMPRESS_ARG_FIX(val);
     }
 
-    return (sizeof(MDS_LOG_Compress_t) - (sizeof(uint32_t) * (MDS_LOG_COMPRESS_ARGS_MAX + cnt)));
+    return (offsetof(MDS_LOG_Compress_t, args) + (sizeof(uint32_t) * cnt));
+}
+
+size_t MDS_LOG_CompressStructVa(MDS_LOG_Compress_t *log, size_t level, const char *fmt, size_t cnt, va_list ap)
+{
+    MDS_ASSERT(log != NULL);
+
+    static size_t psn = 0;
+
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    psn++;
+    MDS_CoreInterruptRestore(lock);
+
+    log->magic = MDS_LOG_COMPRESS_MAGIC;
+
+    return (LOG_CompressFill(log, level, fmt, psn, cnt, ap));
 }
 
 size_t MDS_LOG_CompressSturctPrint(MDS_LOG_Compress_t *log, size_t level, const char *fmt, size_t cnt, ...)
@@ -64,6 +107,107 @@ size_t MDS_LOG_CompressSturctPrint(MDS_LOG_Compress_t *log, size_t level, const
     return (len);
 }
 
+#if (defined(MDS_LOG_DEFERRED) && (MDS_LOG_DEFERRED > 0))
+static bool LOG_DeferredReserve(uint32_t *seq)
+{
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && (__GCC_ATOMIC_INT_LOCK_FREE == 2)
+    uint32_t head = __atomic_load_n(&(g_logDeferred.head), __ATOMIC_RELAXED);
+
+    do {
+        if ((head - __atomic_load_n(&(g_logDeferred.tail), __ATOMIC_ACQUIRE)) >= MDS_LOG_DEFERRED_NUMS) {
+            __atomic_fetch_add(&(g_logDeferred.drops), 1U, __ATOMIC_RELAXED);
+            return (false);
+        }
+    } while (!__atomic_compare_exchange_n(&(g_logDeferred.head), &head, head + 1U, true, __ATOMIC_ACQUIRE,
+                                          __ATOMIC_RELAXED));
+    *seq = head;
+
+    return (true);
+#else
+    bool reserved = false;
+
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    if ((g_logDeferred.head - g_logDeferred.tail) < MDS_LOG_DEFERRED_NUMS) {
+        *seq = g_logDeferred.head++;
+        reserved = true;
+    } else {
+        g_logDeferred.drops += 1U;
+    }
+    MDS_CoreInterruptRestore(lock);
+
+    return (reserved);
+#endif
+}
+
+size_t MDS_LOG_DeferredFlush(void)
+{
+    size_t cnt = 0;
+    uint32_t tail = g_logDeferred.tail;
+
+    while (tail != __atomic_load_n(&(g_logDeferred.head), __ATOMIC_ACQUIRE)) {
+        MDS_LOG_Compress_t *log = &(g_logDeferred.slot[tail & (MDS_LOG_DEFERRED_NUMS - 1U)]);
+        if (__atomic_load_n(&(log->magic), __ATOMIC_ACQUIRE) != MDS_LOG_COMPRESS_MAGIC) {
+            break;
+        }
+        if (g_logDeferred.sink != NULL) {
+            g_logDeferred.sink(log, offsetof(MDS_LOG_Compress_t, args) + (sizeof(uint32_t) * log->count));
+        }
+        log->magic = 0;
+        tail += 1U;
+        __atomic_store_n(&(g_logDeferred.tail), tail, __ATOMIC_RELEASE);
+        cnt += 1U;
+    }
+
+    return (cnt);
+}
+
+size_t MDS_LOG_DeferredDrops(void)
+{
+    return (g_logDeferred.drops);
+}
+
+#if (MDS_THREAD_PRIORITY_MAX > 0)
+static void LOG_DeferredThreadEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_LOOP {
+        if (MDS_LOG_DeferredFlush() == 0U) {
+            MDS_ThreadDelay(MDS_LOG_DEFERRED_TICKS);
+        }
+    }
+}
+#endif
+
+void MDS_LOG_DeferredInit(void (*sink)(const MDS_LOG_Compress_t *log, size_t len))
+{
+    g_logDeferred.sink = sink;
+
+#if (MDS_THREAD_PRIORITY_MAX > 0)
+    if (g_logDeferredThread.entry == NULL) {
+        MDS_Err_t err = MDS_ThreadInit(&g_logDeferredThread, "log", LOG_DeferredThreadEntry, NULL,
+                                       &g_logDeferredStack, sizeof(g_logDeferredStack), MDS_LOG_DEFERRED_PRIORITY,
+                                       MDS_LOG_DEFERRED_TICKS);
+        if (err == MDS_EOK) {
+            MDS_ThreadStartup(&g_logDeferredThread);
+        }
+    }
+#endif
+}
+
+__attribute__((weak)) void MDS_LOG_VaPrintf(size_t level, const char *fmt, size_t cnt, va_list ap)
+{
+    uint32_t seq;
+
+    if (!LOG_DeferredReserve(&seq)) {
+        return;
+    }
+
+    MDS_LOG_Compress_t *log = &(g_logDeferred.slot[seq & (MDS_LOG_DEFERRED_NUMS - 1U)]);
+    LOG_CompressFill(log, level, fmt, seq, cnt, ap);
+    __atomic_store_n(&(log->magic), MDS_LOG_COMPRESS_MAGIC, __ATOMIC_RELEASE);
+}
+#else
 __attribute__((weak)) void MDS_LOG_VaPrintf(size_t level, const char *fmt, size_t cnt, va_list ap)
 {
     UNUSED(level);
@@ -71,6 +215,7 @@ __attribute__((weak)) void MDS_LOG_VaPrintf(size_t level, const char *fmt, size_
     UNUSED(cnt);
     UNUSED(ap);
 }
+#endif
 
 void MDS_LOG_Printf(size_t level, const char *fmt, size_t cnt, ...)
 {
@@ -91,6 +236,10 @@ __attribute__((noreturn)) void MDS_PanicPrintf(const char *fmt, ...)
 
     MDS_CoreInterruptLock();
 
+#if (defined(MDS_LOG_DEFERRED) && (MDS_LOG_DEFERRED > 0))
+    MDS_LOG_DeferredFlush();
+#endif
+
     // TODO: add core backtrace
 
     MDS_LOOP {
@@ -24,6 +24,13 @@ typedef struct MemHeapNode {
     struct MemHeapNode *prev, *next;
 } MemHeapNode_t;
 
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+typedef struct MemHeapFree {
+    MemHeapNode_t node;
+    struct MemHeapFree *prevFree, *nextFree;
+} MemHeapFree_t;
+#endif
+
 /* Define ------------------------------------------------------------------ */
 #if (defined(MDS_DEBUG_MEMORY) && (MDS_DEBUG_MEMORY > 0))
 #define MDS_MEMORY_PRINT(fmt, ...) MDS_LOG_D("[MEMORY]" fmt, ##__VA_ARGS__)
@@ -31,11 +38,25 @@ typedef struct MemHeapNode {
 #define MDS_MEMORY_PRINT(fmt, ...)
 #endif
 
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+#if ((MDS_MEMHEAP_TLSF_SL_LOG2 > 5) || (MDS_MEMHEAP_TLSF_FL_COUNT > 31))
+#error "memheap tlsf supported max sl log2:5 and max fl count:31"
+#endif
+
+#define MDS_MEMHEAP_TLSF_SL_COUNT   (1U << MDS_MEMHEAP_TLSF_SL_LOG2)
+#define MDS_MEMHEAP_TLSF_SMALL_SIZE (MDS_MEMHEAP_TLSF_SL_COUNT * MDS_SYSMEM_ALIGN_SIZE)
+#endif
+
 /* Variable ---------------------------------------------------------------- */
 static const uintptr_t MDS_SYS_MEMHEAP_BASE = (UINTPTR_MAX ^ 1U);
 static const uintptr_t MDS_SYS_MEMHEAP_USED = (1U);
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+static const size_t MDS_MEMHEAP_NODE_MINSIZE = VALUE_ALIGN(sizeof(MemHeapFree_t) + MDS_SYSMEM_ALIGN_SIZE - 1,
+                                                           MDS_SYSMEM_ALIGN_SIZE);
+#else
 static const size_t MDS_MEMHEAP_NODE_MINSIZE = VALUE_ALIGN(sizeof(MemHeapNode_t) + MDS_SYSMEM_ALIGN_SIZE - 1,
                                                            MDS_SYSMEM_ALIGN_SIZE);
+#endif
 
 /* Function ---------------------------------------------------------------- */
 static bool MemHeapNodeIsUsed(MemHeapNode_t *node)
@@ -72,6 +93,146 @@ static bool MemHeapIsPtrInside(MDS_MemHeap_t *memheap, void *ptr)
     return (((uintptr_t)(limit->next) < (uintptr_t)(ptr)) && ((uintptr_t)(ptr) < memheap->limit));
 }
 
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+static size_t MemHeapFLS(size_t value)
+{
+    return ((sizeof(unsigned long) * 8U) - 1U - __builtin_clzl((unsigned long)value));
+}
+
+static size_t MemHeapFFS(uint32_t value)
+{
+    return (__builtin_ctz(value));
+}
+
+static size_t MemHeapNodeSize(MemHeapNode_t *node)
+{
+    return ((uintptr_t)(node->next) - (uintptr_t)(node));
+}
+
+static size_t MemHeapHopeSize(size_t alignSize)
+{
+    size_t hopeSize = sizeof(MemHeapNode_t) + alignSize;
+
+    return ((hopeSize < MDS_MEMHEAP_NODE_MINSIZE) ? (MDS_MEMHEAP_NODE_MINSIZE) : (hopeSize));
+}
+
+static void MemHeapMapping(size_t size, size_t *fl, size_t *sl)
+{
+    if (size < MDS_MEMHEAP_TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = size / MDS_SYSMEM_ALIGN_SIZE;
+    } else {
+        size_t msb = MemHeapFLS(size);
+        *fl = msb - MemHeapFLS(MDS_MEMHEAP_TLSF_SMALL_SIZE) + 1;
+        *sl = (size >> (msb - MDS_MEMHEAP_TLSF_SL_LOG2)) ^ MDS_MEMHEAP_TLSF_SL_COUNT;
+    }
+
+    if (*fl >= MDS_MEMHEAP_TLSF_FL_COUNT) {
+        *fl = MDS_MEMHEAP_TLSF_FL_COUNT - 1;
+        *sl = MDS_MEMHEAP_TLSF_SL_COUNT - 1;
+    }
+}
+
+static void MemHeapBlockInsert(MDS_MemHeap_t *memheap, MemHeapFree_t *block)
+{
+    size_t fl, sl;
+
+    MemHeapMapping(MemHeapNodeSize(&(block->node)), &fl, &sl);
+
+    block->prevFree = NULL;
+    block->nextFree = memheap->blocks[fl][sl];
+    if (block->nextFree != NULL) {
+        block->nextFree->prevFree = block;
+    }
+
+    memheap->blocks[fl][sl] = block;
+    memheap->flBitmap |= 1U << fl;
+    memheap->slBitmap[fl] |= 1U << sl;
+}
+
+static void MemHeapBlockRemove(MDS_MemHeap_t *memheap, MemHeapFree_t *block)
+{
+    size_t fl, sl;
+
+    MemHeapMapping(MemHeapNodeSize(&(block->node)), &fl, &sl);
+
+    if (block->nextFree != NULL) {
+        block->nextFree->prevFree = block->prevFree;
+    }
+    if (block->prevFree != NULL) {
+        block->prevFree->nextFree = block->nextFree;
+    } else {
+        memheap->blocks[fl][sl] = block->nextFree;
+        if (block->nextFree == NULL) {
+            memheap->slBitmap[fl] &= ~(1U << sl);
+            if (memheap->slBitmap[fl] == 0U) {
+                memheap->flBitmap &= ~(1U << fl);
+            }
+        }
+    }
+}
+
+static MemHeapFree_t *MemHeapBlockSearch(MDS_MemHeap_t *memheap, size_t hopeSize)
+{
+    size_t fl, sl, roundSize = hopeSize;
+
+    if (roundSize >= MDS_MEMHEAP_TLSF_SMALL_SIZE) {
+        roundSize += (1U << (MemHeapFLS(roundSize) - MDS_MEMHEAP_TLSF_SL_LOG2)) - 1U;
+    }
+    MemHeapMapping(roundSize, &fl, &sl);
+
+    uint32_t slMap = memheap->slBitmap[fl] & (UINT32_MAX << sl);
+    if (slMap == 0U) {
+        uint32_t flMap = memheap->flBitmap & (UINT32_MAX << (fl + 1));
+        if (flMap != 0U) {
+            fl = MemHeapFFS(flMap);
+            slMap = memheap->slBitmap[fl];
+        } else {
+            MemHeapMapping(hopeSize, &fl, &sl);
+            slMap = memheap->slBitmap[fl] & (1U << sl);
+            if (slMap == 0U) {
+                return (NULL);
+            }
+        }
+    }
+    sl = MemHeapFFS(slMap);
+
+    // only the unrounded or clamped last list may hold blocks smaller than the request
+    MemHeapFree_t *block = memheap->blocks[fl][sl];
+    while ((block != NULL) && (MemHeapNodeSize(&(block->node)) < hopeSize)) {
+        block = block->nextFree;
+    }
+
+    return (block);
+}
+
+static void MemHeapNodeRelease(MDS_MemHeap_t *memheap, MemHeapNode_t *node)
+{
+    node->baseptr &= ~MDS_SYS_MEMHEAP_USED;
+    if (!MemHeapNodeIsUsed(node->next)) {
+        MemHeapBlockRemove(memheap, (MemHeapFree_t *)(node->next));
+        MemHeapNodeCombine(node);
+    }
+    if (!MemHeapNodeIsUsed(node->prev)) {
+        MemHeapBlockRemove(memheap, (MemHeapFree_t *)(node->prev));
+        MemHeapNodeCombine(node->prev);
+        node = node->prev;
+    }
+
+    MemHeapBlockInsert(memheap, (MemHeapFree_t *)node);
+}
+
+static void MemHeapNodeTrim(MDS_MemHeap_t *memheap, MemHeapNode_t *node, size_t hopeSize)
+{
+    MemHeapNode_t *next = (MemHeapNode_t *)((uintptr_t)(node) + hopeSize);
+
+    if (((uintptr_t)(node->next) - (uintptr_t)(next)) >= MDS_MEMHEAP_NODE_MINSIZE) {
+        next->baseptr = ((uintptr_t)memheap) | MDS_SYS_MEMHEAP_USED;
+        MemHeapNodeSplit(node, next);
+        MemHeapNodeRelease(memheap, next);
+    }
+}
+#else
 static void MemHeapRelistFree(MDS_MemHeap_t *memheap, MemHeapNode_t *node)
 {
     MemHeapNode_t *lfree = node;
@@ -82,6 +243,7 @@ static void MemHeapRelistFree(MDS_MemHeap_t *memheap, MemHeapNode_t *node)
 
     memheap->lfree = (uintptr_t)lfree;
 }
+#endif
 
 MDS_Err_t MDS_MemHeapInit(MDS_MemHeap_t *memheap, const char *name, void *heapBegin, void *heapLimit)
 {
@@ -89,7 +251,7 @@ MDS_Err_t MDS_MemHeapInit(MDS_MemHeap_t *memheap, const char *name, void *heapBe
 
     uintptr_t alignBegin = VALUE_ALIGN((uintptr_t)heapBegin + MDS_SYSMEM_ALIGN_SIZE - 1, MDS_SYSMEM_ALIGN_SIZE);
     uintptr_t alignLimit = VALUE_ALIGN((uintptr_t)heapLimit, MDS_SYSMEM_ALIGN_SIZE);
-    if ((alignLimit - alignBegin) < (sizeof(MemHeapNode_t) + sizeof(MemHeapNode_t))) {
+    if ((alignLimit - alignBegin) < (sizeof(MemHeapNode_t) + MDS_MEMHEAP_NODE_MINSIZE)) {
         return (MDS_ENOMEM);
     }
 
@@ -98,10 +260,19 @@ MDS_Err_t MDS_MemHeapInit(MDS_MemHeap_t *memheap, const char *name, void *heapBe
         return (err);
     }
 
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+    memheap->limit = alignLimit - sizeof(MemHeapNode_t);
+    memheap->flBitmap = 0U;
+    MDS_MemBuffSet(memheap->slBitmap, 0, sizeof(memheap->slBitmap));
+    MDS_MemBuffSet(memheap->blocks, 0, sizeof(memheap->blocks));
+
+    MemHeapNode_t *lfree = (MemHeapNode_t *)(alignBegin);
+#else
     memheap->lfree = alignBegin;
     memheap->limit = alignLimit - sizeof(MemHeapNode_t);
 
     MemHeapNode_t *lfree = (MemHeapNode_t *)(memheap->lfree);
+#endif
     MemHeapNode_t *limit = (MemHeapNode_t *)(memheap->limit);
 
     lfree->baseptr = ((uintptr_t)memheap) & MDS_SYS_MEMHEAP_BASE;
@@ -112,6 +283,10 @@ MDS_Err_t MDS_MemHeapInit(MDS_MemHeap_t *memheap, const char *name, void *heapBe
     limit->prev = lfree;
     limit->next = lfree;
 
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+    MemHeapBlockInsert(memheap, (MemHeapFree_t *)lfree);
+#endif
+
 #if (defined(MDS_MEMHEAP_STATS) && (MDS_MEMHEAP_STATS > 0))
     memheap->max = 0;
     memheap->cur = 0;
@@ -136,6 +311,142 @@ MDS_Err_t MDS_MemHeapDeInit(MDS_MemHeap_t *memheap)
     return (MDS_EOK);
 }
 
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+static MemHeapNode_t *MDS_MemHeapNodeAlloc(MDS_MemHeap_t *memheap, size_t alignSize)
+{
+    size_t hopeSize = MemHeapHopeSize(alignSize);
+    MemHeapFree_t *block = MemHeapBlockSearch(memheap, hopeSize);
+    if (block == NULL) {
+        MDS_MEMORY_PRINT("memheap(%p) flmap:%x alloc size:%u no memory", memheap, memheap->flBitmap, alignSize);
+        return (NULL);
+    }
+
+    MemHeapBlockRemove(memheap, block);
+
+    MemHeapNode_t *node = &(block->node);
+    node->baseptr = ((uintptr_t)memheap) | MDS_SYS_MEMHEAP_USED;
+    MemHeapNodeTrim(memheap, node, hopeSize);
+
+#if (defined(MDS_MEMHEAP_STATS) && (MDS_MEMHEAP_STATS > 0))
+    memheap->cur += MemHeapNodeSize(node);
+    if (memheap->cur > memheap->max) {
+        memheap->max = memheap->cur;
+    }
+#endif
+
+    MDS_HOOK_CALL(MEMHEAP_ALLOC, memheap, (uint8_t *)node + sizeof(MemHeapNode_t), alignSize);
+
+    MDS_MEMORY_PRINT("memheap(%p) alloc node:%p size:%u", memheap, node, alignSize);
+
+    return (node);
+}
+
+static void MemHeapNodeFree(MDS_MemHeap_t *memheap, MemHeapNode_t *node)
+{
+#if (defined(MDS_MEMHEAP_STATS) && (MDS_MEMHEAP_STATS > 0))
+    memheap->cur -= MemHeapNodeSize(node);
+#endif
+
+    MDS_HOOK_CALL(MEMHEAP_FREE, memheap, (uint8_t *)node + sizeof(MemHeapNode_t));
+
+    MDS_MEMORY_PRINT("memheap(%p) free node:%p size:%u", memheap, node,
+                     MemHeapNodeSize(node) - sizeof(MemHeapNode_t));
+
+    MemHeapNodeRelease(memheap, node);
+}
+
+static MemHeapNode_t *MDS_MemHeapNodeRealloc(MDS_MemHeap_t *memheap, MemHeapNode_t *node, size_t alignSize)
+{
+    MemHeapNode_t *next = NULL;
+
+    if (MDS_SemaphoreAcquire(&(memheap->sem), MDS_TICK_FOREVER) != MDS_EOK) {
+        return (NULL);
+    }
+
+    size_t hopeSize = MemHeapHopeSize(alignSize);
+    size_t nodeSize = MemHeapNodeSize(node);
+    if (hopeSize > nodeSize) {
+        if (MemHeapNodeIsUsed(node->next) || (hopeSize > ((uintptr_t)(node->next->next) - (uintptr_t)(node)))) {
+            next = MDS_MemHeapNodeAlloc(memheap, alignSize);
+            if (next != NULL) {
+                MDS_MemBuffCopy((uint8_t *)next + sizeof(MemHeapNode_t), alignSize,
+                                (uint8_t *)node + sizeof(MemHeapNode_t), nodeSize - sizeof(MemHeapNode_t));
+                MemHeapNodeFree(memheap, node);
+            }
+
+            MDS_HOOK_CALL(MEMHEAP_REALLOC, memheap, (uint8_t *)node + sizeof(MemHeapNode_t),
+                          (uint8_t *)next + sizeof(MemHeapNode_t), alignSize);
+
+            MDS_SemaphoreRelease(&(memheap->sem));
+
+            return (next);
+        }
+
+        MemHeapBlockRemove(memheap, (MemHeapFree_t *)(node->next));
+        MemHeapNodeCombine(node);
+
+        MDS_MEMORY_PRINT("memheap(%p) realloc node:%p extend size:%u->%u", memheap, node, nodeSize, hopeSize);
+    } else {
+        MDS_MEMORY_PRINT("memheap(%p) realloc node:%p reduce size:%u->%u", memheap, node, nodeSize, hopeSize);
+    }
+
+    MDS_HOOK_CALL(MEMHEAP_REALLOC, memheap, (uint8_t *)node + sizeof(MemHeapNode_t),
+                  (uint8_t *)node + sizeof(MemHeapNode_t), alignSize);
+
+    MemHeapNodeTrim(memheap, node, hopeSize);
+
+#if (defined(MDS_MEMHEAP_STATS) && (MDS_MEMHEAP_STATS > 0))
+    memheap->cur += MemHeapNodeSize(node) - nodeSize;
+    if (memheap->cur > memheap->max) {
+        memheap->max = memheap->cur;
+    }
+#endif
+
+    MDS_SemaphoreRelease(&(memheap->sem));
+
+    return (node);
+}
+
+static MemHeapNode_t *MDS_MemHeapNodeAlignedAlloc(MDS_MemHeap_t *memheap, size_t align, size_t needSize)
+{
+    MemHeapFree_t *block = MemHeapBlockSearch(memheap, MemHeapHopeSize(needSize + align + MDS_MEMHEAP_NODE_MINSIZE));
+    if (block == NULL) {
+        MDS_MEMORY_PRINT("memheap(%p) flmap:%x aligned alloc size:%u no memory", memheap, memheap->flBitmap,
+                         needSize);
+        return (NULL);
+    }
+
+    MemHeapBlockRemove(memheap, block);
+
+    MemHeapNode_t *node = &(block->node);
+    node->baseptr = ((uintptr_t)memheap) | MDS_SYS_MEMHEAP_USED;
+
+    uintptr_t alignPtr = (uintptr_t)(node) + sizeof(MemHeapNode_t);
+    if ((alignPtr % align) != 0) {
+        alignPtr = ((alignPtr + MDS_MEMHEAP_NODE_MINSIZE + align - 1) / align) * align;
+
+        MemHeapNode_t *next = (MemHeapNode_t *)(alignPtr - sizeof(MemHeapNode_t));
+        next->baseptr = ((uintptr_t)memheap) | MDS_SYS_MEMHEAP_USED;
+        MemHeapNodeSplit(node, next);
+        MemHeapNodeRelease(memheap, node);
+        node = next;
+    }
+    MemHeapNodeTrim(memheap, node, MemHeapHopeSize(needSize));
+
+#if (defined(MDS_MEMHEAP_STATS) && (MDS_MEMHEAP_STATS > 0))
+    memheap->cur += MemHeapNodeSize(node);
+    if (memheap->cur > memheap->max) {
+        memheap->max = memheap->cur;
+    }
+#endif
+
+    MDS_HOOK_CALL(MEMHEAP_ALLOC, memheap, (uint8_t *)node + sizeof(MemHeapNode_t), needSize);
+
+    MDS_MEMORY_PRINT("memheap(%p) aligned alloc node:%p align:%u size:%u", memheap, node, align, needSize);
+
+    return (node);
+}
+#else
 static MemHeapNode_t *MDS_MemHeapNodeAlloc(MDS_MemHeap_t *memheap, size_t alignSize)
 {
     size_t hopeSize = sizeof(MemHeapNode_t) + alignSize;
@@ -265,6 +576,25 @@ static MemHeapNode_t *MDS_MemHeapNodeRealloc(MDS_MemHeap_t *memheap, MemHeapNode
     return (node);
 }
 
+static MemHeapNode_t *MDS_MemHeapNodeAlignedAlloc(MDS_MemHeap_t *memheap, size_t align, size_t needSize)
+{
+    MemHeapNode_t *next = NULL;
+    size_t nodeSize = VALUE_ALIGN(sizeof(MemHeapNode_t) + align - 1, MDS_SYSMEM_ALIGN_SIZE);
+
+    MemHeapNode_t *node = MDS_MemHeapNodeAlloc(memheap, MDS_MEMHEAP_NODE_MINSIZE + nodeSize + needSize);
+    if (node != NULL) {
+        next = (MemHeapNode_t *)((uintptr_t)(node->next) - sizeof(MemHeapNode_t) - needSize);
+        if (next != node) {
+            next->baseptr = ((uintptr_t)memheap) | MDS_SYS_MEMHEAP_USED;
+            MemHeapNodeSplit(node, next);
+            MemHeapNodeFree(memheap, node);
+        }
+    }
+
+    return (next);
+}
+#endif
+
 void MDS_MemHeapFree(void *ptr)
 {
     if (ptr == NULL) {
@@ -379,7 +709,6 @@ void *MDS_MemHeapAlignedAlloc(MDS_MemHeap_t *memheap, size_t align, size_t size)
         return (NULL);
     }
 
-    MemHeapNode_t *next = NULL;
     size_t needSize = VALUE_ALIGN(size + MDS_SYSMEM_ALIGN_SIZE - 1, MDS_SYSMEM_ALIGN_SIZE);
     size_t nodeSize = VALUE_ALIGN(sizeof(MemHeapNode_t) + align - 1, MDS_SYSMEM_ALIGN_SIZE);
     size_t alignSize = MDS_MEMHEAP_NODE_MINSIZE + nodeSize + needSize;
@@ -393,19 +722,11 @@ void *MDS_MemHeapAlignedAlloc(MDS_MemHeap_t *memheap, size_t align, size_t size)
         return (NULL);
     }
 
-    MemHeapNode_t *node = MDS_MemHeapNodeAlloc(memheap, alignSize);
-    if (node != NULL) {
-        next = (MemHeapNode_t *)((uintptr_t)(node->next) - sizeof(MemHeapNode_t) - needSize);
-        if (next != node) {
-            next->baseptr = ((uintptr_t)memheap) | MDS_SYS_MEMHEAP_USED;
-            MemHeapNodeSplit(node, next);
-            MemHeapNodeFree(memheap, node);
-        }
-    }
+    MemHeapNode_t *node = MDS_MemHeapNodeAlignedAlloc(memheap, align, needSize);
 
     MDS_SemaphoreRelease(&(memheap->sem));
 
-    return ((next != NULL) ? ((uint8_t *)next + sizeof(MemHeapNode_t)) : (NULL));
+    return ((node != NULL) ? ((uint8_t *)node + sizeof(MemHeapNode_t)) : (NULL));
 }
 
 /* SysMem ------------------------------------------------------------------ */
@@ -29,7 +29,54 @@ static MDS_ListNode_t g_objectList[] = {
     OBJECT_LIST_INIT(MDS_OBJECT_TYPE_MEMHEAP),    //
 };
 
+#if (defined(MDS_OBJECT_HASH_SIZE) && (MDS_OBJECT_HASH_SIZE > 0))
+#if ((MDS_OBJECT_HASH_SIZE & (MDS_OBJECT_HASH_SIZE - 1)) != 0)
+#error "kernel object hash size must be power of 2"
+#endif
+
+static MDS_Object_t *g_objectHash[MDS_OBJECT_HASH_SIZE];
+#endif
+
 /* Function ---------------------------------------------------------------- */
+#if (defined(MDS_OBJECT_HASH_SIZE) && (MDS_OBJECT_HASH_SIZE > 0))
+static MDS_Object_t **OBJECT_HashBucket(MDS_ObjectType_t type, const char *name)
+{
+    uint32_t hash = 0x811C9DC5U ^ (uint32_t)type;
+
+    for (size_t idx = 0; (idx < MDS_OBJECT_NAME_SIZE) && (name[idx] != '\0'); idx++) {
+        hash = (hash ^ (uint8_t)name[idx]) * 0x01000193U;
+    }
+    hash ^= hash >> 16;
+
+    return (&(g_objectHash[hash & (MDS_OBJECT_HASH_SIZE - 1)]));
+}
+
+static void OBJECT_HashInsert(MDS_Object_t *object)
+{
+    MDS_Object_t **iter = OBJECT_HashBucket(object->type, object->name);
+
+    while (*iter != NULL) {
+        iter = &((*iter)->hash);
+    }
+    object->hash = NULL;
+    *iter = object;
+}
+
+static void OBJECT_HashRemove(MDS_Object_t *object)
+{
+    MDS_Object_t **iter = OBJECT_HashBucket(object->type, object->name);
+
+    while (*iter != NULL) {
+        if (*iter == object) {
+            *iter = object->hash;
+            break;
+        }
+        iter = &((*iter)->hash);
+    }
+    object->hash = NULL;
+}
+#endif
+
 MDS_Err_t MDS_ObjectInit(MDS_Object_t *object, MDS_ObjectType_t type, const char *name)
 {
     MDS_ASSERT(object != NULL);
@@ -47,6 +94,9 @@ MDS_Err_t MDS_ObjectInit(MDS_Object_t *object, MDS_ObjectType_t type, const char
 
     register MDS_Item_t lock = MDS_CoreInterruptLock();
     MDS_ListInsertNodePrev(&(g_objectList[object->type]), &(object->node));
+#if (defined(MDS_OBJECT_HASH_SIZE) && (MDS_OBJECT_HASH_SIZE > 0))
+    OBJECT_HashInsert(object);
+#endif
     MDS_CoreInterruptRestore(lock);
 
     return (MDS_EOK);
@@ -57,6 +107,11 @@ MDS_Err_t MDS_ObjectDeInit(MDS_Object_t *object)
     MDS_ASSERT(object != NULL);
 
     register MDS_Item_t lock = MDS_CoreInterruptLock();
+#if (defined(MDS_OBJECT_HASH_SIZE) && (MDS_OBJECT_HASH_SIZE > 0))
+    if (!MDS_ListIsEmpty(&(object->node))) {
+        OBJECT_HashRemove(object);
+    }
+#endif
     MDS_ListRemoveNode(&(object->node));
     object->type = MDS_OBJECT_TYPE_NONE;
     MDS_CoreInterruptRestore(lock);
@@ -97,6 +152,17 @@ MDS_Object_t *MDS_ObjectFind(const MDS_ObjectType_t type, const char *name)
 
     MDS_Object_t *iter = NULL;
 
+#if (defined(MDS_OBJECT_HASH_SIZE) && (MDS_OBJECT_HASH_SIZE > 0))
+    if ((name != NULL) && (name[0] != '\0')) {
+        for (iter = *OBJECT_HashBucket(type, name); iter != NULL; iter = iter->hash) {
+            if ((iter->type == type) && (strncmp(iter->name, name, sizeof(iter->name)) == 0)) {
+                break;
+            }
+        }
+    }
+
+    return (iter);
+#else
     if ((name != NULL) && (name[0] != '\0')) {
         MDS_LIST_FOREACH_NEXT (iter, node, &(g_objectList[type])) {
             if (strncmp(iter->name, name, sizeof(iter->name)) == 0) {
@@ -106,6 +172,7 @@ MDS_Object_t *MDS_ObjectFind(const MDS_ObjectType_t type, const char *name)
     }
 
     return (NULL);
+#endif
 }
 
 MDS_Object_t *MDS_ObjectPrev(const MDS_Object_t *object)
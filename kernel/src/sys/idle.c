@@ -25,14 +25,64 @@
 #define MDS_THREAD_IDLE_TICKS 32
 #endif
 
+#ifndef MDS_KERNEL_TICKLESS_THRESHOLD
+#define MDS_KERNEL_TICKLESS_THRESHOLD 2
+#endif
+
+#ifndef MDS_THREAD_STACK_SCAN_WORDS
+#define MDS_THREAD_STACK_SCAN_WORDS 32
+#endif
+
+#define IDLE_STACK_PAINT 0x40404040U
+
 /* Variable ---------------------------------------------------------------- */
 static MDS_Thread_t g_idleThread;
 static uint8_t g_idleStack[MDS_THREAD_IDLE_STACKSIZE];
 
+#if (defined(MDS_THREAD_STACK_WATERMARK) && (MDS_THREAD_STACK_WATERMARK > 0))
+static MDS_Thread_t *g_idleScanThread = NULL;
+static size_t g_idleScanOffset = 0;
+#endif
+
 /* Function ---------------------------------------------------------------- */
-__attribute__((weak)) void MDS_KernelIdleLowPowerControl(void)
+#if (defined(MDS_KERNEL_TICKLESS) && (MDS_KERNEL_TICKLESS > 0))
+__attribute__((weak)) MDS_Tick_t MDS_CoreIdleTickless(MDS_Tick_t sleepTick)
 {
+    UNUSED(sleepTick);
+
     MDS_CoreIdleSleep();
+
+    return (0);
+}
+
+void MDS_KernelIdleSleep(void)
+{
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+
+    MDS_Tick_t sleepTick = MDS_KernelGetSleepTick();
+    if (sleepTick < MDS_KERNEL_TICKLESS_THRESHOLD) {
+        MDS_CoreInterruptRestore(lock);
+        MDS_CoreIdleSleep();
+        return;
+    }
+
+    MDS_Tick_t tickDelta = MDS_CoreIdleTickless(sleepTick);
+    if (tickDelta > 0) {
+        MDS_KernelCompensateTick(tickDelta);
+    }
+
+    MDS_CoreInterruptRestore(lock);
+}
+#else
+void MDS_KernelIdleSleep(void)
+{
+    MDS_CoreIdleSleep();
+}
+#endif
+
+__attribute__((weak)) void MDS_KernelIdleLowPowerControl(void)
+{
+    MDS_KernelIdleSleep();
 }
 
 MDS_Thread_t *MDS_KernelGetIdleThread(void)
@@ -46,7 +96,7 @@ static void (*g_idleHook[MDS_THREAD_IDLE_HOOK_SIZE])(void);
 MDS_Err_t MDS_KernelAddIdleHook(void (*hook)(void))
 {
     size_t idx;
-    MDS_Err_t err = MDS_ERROR;
+    MDS_Err_t err = MDS_ENOMEM;
     register MDS_Item_t lock = MDS_CoreInterruptLock();
 
     for (idx = 0; idx < ARRAY_SIZE(g_idleHook); idx++) {
@@ -65,7 +115,7 @@ MDS_Err_t MDS_KernelAddIdleHook(void (*hook)(void))
 MDS_Err_t MDS_KernelDelIdleHook(void (*hook)(void))
 {
     size_t idx;
-    MDS_Err_t err = MDS_ERROR;
+    MDS_Err_t err = MDS_ENOENT;
     register MDS_Item_t lock = MDS_CoreInterruptLock();
 
     for (idx = 0; idx < ARRAY_SIZE(g_idleHook); idx++) {
@@ -90,6 +140,12 @@ static void IDLE_ThreadDefunct(void)
             break;
         }
 
+#if (defined(MDS_THREAD_STACK_WATERMARK) && (MDS_THREAD_STACK_WATERMARK > 0))
+        if (thread == g_idleScanThread) {
+            g_idleScanThread = NULL;
+        }
+#endif
+
         if (!MDS_ObjectIsCreated(&(thread->object))) {
             MDS_ObjectDeInit(&(thread->object));
         } else {
@@ -99,6 +155,67 @@ static void IDLE_ThreadDefunct(void)
     }
 }
 
+#if (defined(MDS_THREAD_STACK_WATERMARK) && (MDS_THREAD_STACK_WATERMARK > 0))
+static MDS_Thread_t *IDLE_StackScanNext(MDS_Thread_t *thread)
+{
+    MDS_Object_t *object = NULL;
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+
+    if (thread != NULL) {
+        object = MDS_ObjectNext(&(thread->object));
+    } else {
+        const MDS_ListNode_t *list = MDS_ObjectGetList(MDS_OBJECT_TYPE_THREAD);
+        if (list->next != list) {
+            object = CONTAINER_OF(list->next, MDS_Object_t, node);
+        }
+    }
+
+    MDS_CoreInterruptRestore(lock);
+
+    return ((object != NULL) ? (CONTAINER_OF(object, MDS_Thread_t, object)) : (NULL));
+}
+
+static void IDLE_ThreadStackScan(void)
+{
+    MDS_Thread_t *thread = g_idleScanThread;
+
+    if (thread == NULL) {
+        thread = IDLE_StackScanNext(NULL);
+        g_idleScanOffset = 0;
+        if (thread == NULL) {
+            return;
+        }
+    }
+
+    /* stacks grow down from stackBase + stackSize, so the painted words left at the base are the free part */
+    uintptr_t base = (uintptr_t)(thread->stackBase);
+    const uint32_t *stack = (const uint32_t *)VALUE_ALIGN(base + sizeof(uint32_t) - 1U, sizeof(uint32_t));
+    size_t head = (uintptr_t)stack - base;
+    size_t words = (thread->stackFree > head) ? ((thread->stackFree - head) / sizeof(uint32_t)) : (0U);
+    size_t end = g_idleScanOffset + MDS_THREAD_STACK_SCAN_WORDS;
+    size_t idx;
+
+    if (end > words) {
+        end = words;
+    }
+
+    for (idx = g_idleScanOffset; idx < end; idx++) {
+        if (stack[idx] != IDLE_STACK_PAINT) {
+            thread->stackFree = head + (idx * sizeof(uint32_t));
+            break;
+        }
+    }
+
+    if ((idx < end) || (end == words)) {
+        g_idleScanThread = IDLE_StackScanNext(thread);
+        g_idleScanOffset = 0;
+    } else {
+        g_idleScanThread = thread;
+        g_idleScanOffset = end;
+    }
+}
+#endif
+
 static __attribute__((noreturn)) void IDLE_ThreadEntry(MDS_Arg_t *arg)
 {
     UNUSED(arg);
@@ -106,6 +223,10 @@ static __attribute__((noreturn)) void IDLE_ThreadEntry(MDS_Arg_t *arg)
     MDS_LOOP {
         IDLE_ThreadDefunct();
 
+#if (defined(MDS_THREAD_STACK_WATERMARK) && (MDS_THREAD_STACK_WATERMARK > 0))
+        IDLE_ThreadStackScan();
+#endif
+
 #if (defined(MDS_THREAD_IDLE_HOOK_SIZE) && (MDS_THREAD_IDLE_HOOK_SIZE > 0))
         size_t idx;
         for (idx = 0; idx < ARRAY_SIZE(g_idleHook); idx++) {
@@ -39,12 +39,10 @@ MDS_HOOK_INIT(MEMPOOL_HAS_FREE, MDS_MemPool_t *memPool, void *ptr);
 #endif
 
 /* IPC thread -------------------------------------------------------------- */
-static void IPC_ListSuspendThread(MDS_ListNode_t *list, MDS_Thread_t *thread, bool isPrio, MDS_Tick_t timeout)
+static void IPC_ListInsertThread(MDS_ListNode_t *list, MDS_Thread_t *thread, bool isPrio)
 {
     register MDS_Thread_t *iter = NULL;
 
-    MDS_ThreadSuspend(thread);
-
     if (isPrio) {
         MDS_LIST_FOREACH_NEXT (iter, node, list) {
             if (thread->currPrio < iter->currPrio) {
@@ -57,6 +55,13 @@ static void IPC_ListSuspendThread(MDS_ListNode_t *list, MDS_Thread_t *thread, bo
     if ((iter == NULL) || (&(iter->node) == list)) {
         MDS_ListInsertNodePrev(list, &(thread->node));
     }
+}
+
+static void IPC_ListSuspendThread(MDS_ListNode_t *list, MDS_Thread_t *thread, bool isPrio, MDS_Tick_t timeout)
+{
+    MDS_ThreadSuspend(thread);
+
+    IPC_ListInsertThread(list, thread, isPrio);
 
     if (timeout < MDS_TIMER_TICK_MAX) {
         MDS_TimerStart(&(thread->timer), timeout);
@@ -92,6 +97,13 @@ static void IPC_ListResumeThread(MDS_ListNode_t *list)
     MDS_ThreadResume(thread);
 }
 
+static void IPC_ListResumeThreadNums(MDS_ListNode_t *list, size_t nums)
+{
+    for (; (nums > 0) && (!MDS_ListIsEmpty(list)); nums--) {
+        IPC_ListResumeThread(list);
+    }
+}
+
 static void IPC_ListResumeAllThread(MDS_ListNode_t *list)
 {
     MDS_Thread_t *thread = NULL;
@@ -101,6 +113,7 @@ static void IPC_ListResumeAllThread(MDS_ListNode_t *list)
 
         thread = CONTAINER_OF(list->next, MDS_Thread_t, node);
         thread->err = MDS_EAGAIN;
+        thread->pendMutex = NULL;
 
         MDS_ThreadResume(thread);
 
@@ -327,6 +340,61 @@ MDS_Err_t MDS_ConditionWait(MDS_Condition_t *condition, MDS_Mutex_t *mutex, MDS_
 }
 
 /* Mutex ------------------------------------------------------------------- */
+static MDS_ThreadPriority_t IPC_MutexWaitPriority(const MDS_Mutex_t *mutex)
+{
+    if (MDS_ListIsEmpty(&(mutex->list))) {
+        return (MDS_THREAD_PRIORITY_MAX - 1);
+    }
+
+    return (CONTAINER_OF(mutex->list.next, MDS_Thread_t, node)->currPrio);
+}
+
+static MDS_ThreadPriority_t IPC_MutexOwnerPriority(MDS_Thread_t *thread)
+{
+    MDS_ThreadPriority_t priority = thread->initPrio;
+    MDS_Mutex_t *iter = NULL;
+
+    MDS_LIST_FOREACH_NEXT (iter, node, &(thread->mutexList)) {
+        if (iter->priority < priority) {
+            priority = iter->priority;
+        }
+    }
+
+    return (priority);
+}
+
+static void IPC_MutexPriorityUpdate(MDS_Thread_t *owner)
+{
+    while (owner != NULL) {
+        MDS_ThreadPriority_t priority = IPC_MutexOwnerPriority(owner);
+        if (priority == owner->currPrio) {
+            break;
+        }
+        MDS_ThreadChangePriority(owner, priority);
+
+        // a woken waiter has already left the wait list, re-sorting it would corrupt the ready queue
+        MDS_Mutex_t *mutex = owner->pendMutex;
+        if ((mutex == NULL) || ((owner->state & MDS_THREAD_STATE_MASK) != MDS_THREAD_STATE_BLOCKED)) {
+            break;
+        }
+        MDS_ListRemoveNode(&(owner->node));
+        IPC_ListInsertThread(&(mutex->list), owner, true);
+        mutex->priority = IPC_MutexWaitPriority(mutex);
+        owner = mutex->owner;
+    }
+}
+
+static void IPC_MutexListResumeAll(MDS_Mutex_t *mutex)
+{
+    IPC_ListResumeAllThread(&(mutex->list));
+
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    MDS_ListRemoveNode(&(mutex->node));
+    mutex->priority = MDS_THREAD_PRIORITY_MAX - 1;
+    IPC_MutexPriorityUpdate(mutex->owner);
+    MDS_CoreInterruptRestore(lock);
+}
+
 MDS_Err_t MDS_MutexInit(MDS_Mutex_t *mutex, const char *name)
 {
     MDS_ASSERT(mutex != NULL);
@@ -338,6 +406,7 @@ MDS_Err_t MDS_MutexInit(MDS_Mutex_t *mutex, const char *name)
         mutex->value = 1;
         mutex->nest = 0;
         MDS_ListInitNode(&(mutex->list));
+        MDS_ListInitNode(&(mutex->node));
     }
 
     return (err);
@@ -348,7 +417,7 @@ MDS_Err_t MDS_MutexDeInit(MDS_Mutex_t *mutex)
     MDS_ASSERT(mutex != NULL);
     MDS_ASSERT(MDS_ObjectGetType(&(mutex->object)) == MDS_OBJECT_TYPE_MUTEX);
 
-    IPC_ListResumeAllThread(&(mutex->list));
+    IPC_MutexListResumeAll(mutex);
 
     return (MDS_ObjectDeInit(&(mutex->object)));
 }
@@ -362,6 +431,7 @@ MDS_Mutex_t *MDS_MutexCreate(const char *name)
         mutex->value = 1;
         mutex->nest = 0;
         MDS_ListInitNode(&(mutex->list));
+        MDS_ListInitNode(&(mutex->node));
     }
 
     return (mutex);
@@ -372,7 +442,7 @@ MDS_Err_t MDS_MutexDestroy(MDS_Mutex_t *mutex)
     MDS_ASSERT(mutex != NULL);
     MDS_ASSERT(MDS_ObjectGetType(&(mutex->object)) == MDS_OBJECT_TYPE_MUTEX);
 
-    IPC_ListResumeAllThread(&(mutex->list));
+    IPC_MutexListResumeAll(mutex);
 
     return (MDS_ObjectDestory(&(mutex->object)));
 }
@@ -393,17 +463,13 @@ MDS_Err_t MDS_MutexAcquire(MDS_Mutex_t *mutex, MDS_Tick_t timeout)
     MDS_Err_t err = MDS_EOK;
     register MDS_Item_t lock = MDS_CoreInterruptLock();
 
-    if (thread == mutex->owner) {
-        if (mutex->nest < (__typeof__(mutex->nest))(-1)) {
-            mutex->nest += 1;
-        } else {
-            err = MDS_ERANGE;
-        }
-        MDS_CoreInterruptRestore(lock);
-    } else if (mutex->value > 0) {
+    if (mutex->value > 0) {
         mutex->value -= 1;
         mutex->owner = thread;
-        mutex->priority = thread->currPrio;
+        mutex->priority = MDS_THREAD_PRIORITY_MAX - 1;
+        mutex->nest = 1;
+        MDS_CoreInterruptRestore(lock);
+    } else if (thread == mutex->owner) {
         if (mutex->nest < (__typeof__(mutex->nest))(-1)) {
             mutex->nest += 1;
         } else {
@@ -417,13 +483,25 @@ MDS_Err_t MDS_MutexAcquire(MDS_Mutex_t *mutex, MDS_Tick_t timeout)
     } else {
         MDS_IPC_PRINT("mutex suspend thread(%p) entry:%p timer wait:%u", thread, thread->entry, timeout);
 
-        if (thread->currPrio < mutex->owner->currPrio) {
-            MDS_ThreadChangePriority(mutex->owner, thread->currPrio);
+        if (MDS_ListIsEmpty(&(mutex->node))) {
+            MDS_ListInsertNodePrev(&(mutex->owner->mutexList), &(mutex->node));
         }
+        thread->pendMutex = mutex;
         IPC_ListSuspendThread(&(mutex->list), thread, true, timeout);
+        mutex->priority = IPC_MutexWaitPriority(mutex);
+        IPC_MutexPriorityUpdate(mutex->owner);
         MDS_CoreInterruptRestore(lock);
         MDS_SchedulerCheck();
+
+        // only a timed out waiter may touch the mutex again, any other error means it was destroyed
+        lock = MDS_CoreInterruptLock();
+        thread->pendMutex = NULL;
         err = thread->err;
+        if ((err == MDS_ETIME) && (mutex->owner != thread)) {
+            mutex->priority = IPC_MutexWaitPriority(mutex);
+            IPC_MutexPriorityUpdate(mutex->owner);
+        }
+        MDS_CoreInterruptRestore(lock);
     }
 
     MDS_HOOK_CALL(MUTEX_HAS_ACQUIRE, mutex, err);
@@ -453,23 +531,19 @@ MDS_Err_t MDS_MutexRelease(MDS_Mutex_t *mutex)
     MDS_HOOK_CALL(MUTEX_HAS_RELEASE, mutex);
 
     mutex->nest -= 1;
-    if (mutex->nest == 0) {
-        if (mutex->priority != mutex->owner->currPrio) {
-            MDS_ThreadChangePriority(mutex->owner, mutex->priority);
-        }
+    if ((mutex->nest == 0) && MDS_ListIsEmpty(&(mutex->node))) {
+        mutex->owner = NULL;
+        mutex->value = 1;
+    } else if (mutex->nest == 0) {
+        MDS_ListRemoveNode(&(mutex->node));
         if (!MDS_ListIsEmpty(&(mutex->list))) {
             mutex->owner = CONTAINER_OF(mutex->list.next, MDS_Thread_t, node);
-            mutex->priority = mutex->owner->currPrio;
-            if (mutex->nest < (__typeof__(mutex->nest))(-1)) {
-                mutex->nest += 1;
-            } else {
-                MDS_CoreInterruptRestore(lock);
-                return (MDS_ERANGE);
-            }
+            mutex->nest += 1;
             IPC_ListResumeThread(&(mutex->list));
-            MDS_CoreInterruptRestore(lock);
-            MDS_SchedulerCheck();
-            return (MDS_EOK);
+            mutex->priority = IPC_MutexWaitPriority(mutex);
+            MDS_ListInsertNodePrev(&(mutex->owner->mutexList), &(mutex->node));
+            mutex->owner->pendMutex = NULL;
+            IPC_MutexPriorityUpdate(mutex->owner);
         } else {
             mutex->owner = NULL;
             mutex->priority = MDS_THREAD_PRIORITY_MAX - 1;
@@ -480,6 +554,11 @@ MDS_Err_t MDS_MutexRelease(MDS_Mutex_t *mutex)
                 return (MDS_ERANGE);
             }
         }
+        IPC_MutexPriorityUpdate(thread);
+        MDS_CoreInterruptRestore(lock);
+        MDS_SchedulerCheck();
+
+        return (MDS_EOK);
     }
 
     MDS_CoreInterruptRestore(lock);
@@ -822,6 +901,7 @@ typedef struct MDS_MsgQueueHeader {
 
 static void MDS_MsgQueueListInit(MDS_MsgQueue_t *msgQueue, size_t msgNums)
 {
+    msgQueue->msgNums = msgNums;
     msgQueue->lfree = NULL;
     msgQueue->lhead = NULL;
     msgQueue->ltail = NULL;
@@ -834,6 +914,110 @@ static void MDS_MsgQueueListInit(MDS_MsgQueue_t *msgQueue, size_t msgNums)
     }
 }
 
+static MDS_Err_t MDS_MsgQueueListWait(MDS_Item_t *lock, void **list, MDS_ListNode_t *wait, MDS_Tick_t timeout)
+{
+    MDS_Err_t err = MDS_EOK;
+
+    if (*list == NULL) {
+        if (timeout == 0) {
+            return (MDS_ETIME);
+        }
+
+        MDS_Thread_t *thread = MDS_KernelCurrentThread();
+
+        MDS_ASSERT(thread != NULL);
+
+        MDS_IPC_PRINT("msgqueue list(%p) suspend thread(%p) entry:%p timer wait:%u", list, thread, thread->entry,
+                      timeout);
+
+        while (*list == NULL) {
+            err = IPC_ListSuspendWait(lock, wait, thread, timeout);
+            if (err != MDS_EOK) {
+                break;
+            }
+        }
+    }
+
+    return (err);
+}
+
+static MDS_MsgQueueHeader_t *MDS_MsgQueueListTake(void **list, size_t nums, size_t *cnt)
+{
+    MDS_MsgQueueHeader_t *head = (MDS_MsgQueueHeader_t *)(*list);
+    MDS_MsgQueueHeader_t *tail = head;
+
+    for (*cnt = 1; (*cnt < nums) && (tail->next != NULL); *cnt += 1) {
+        tail = tail->next;
+    }
+    *list = (void *)(tail->next);
+    tail->next = NULL;
+
+    return (head);
+}
+
+static MDS_MsgQueueHeader_t *MDS_MsgQueueSlotHeader(MDS_MsgQueue_t *msgQueue, void *slot)
+{
+    if (slot == NULL) {
+        return (NULL);
+    }
+
+    // a pointer below queBuff wraps around and fails the range check as well
+    MDS_MsgQueueHeader_t *msg = ((MDS_MsgQueueHeader_t *)(*(uintptr_t *)slot)) - 1;
+    size_t stride = sizeof(MDS_MsgQueueHeader_t) + msgQueue->msgSize;
+    uintptr_t ofs = (uintptr_t)(msg) - (uintptr_t)(msgQueue->queBuff);
+    if ((ofs >= (stride * msgQueue->msgNums)) || ((ofs % stride) != 0)) {
+        return (NULL);
+    }
+
+    return (msg);
+}
+
+static void MDS_MsgQueueRecycle(MDS_MsgQueue_t *msgQueue, MDS_MsgQueueHeader_t *msg)
+{
+    MDS_Item_t lock = MDS_CoreInterruptLock();
+
+    msg->next = (MDS_MsgQueueHeader_t *)(msgQueue->lfree);
+    msgQueue->lfree = (void *)msg;
+
+    if (!MDS_ListIsEmpty(&(msgQueue->listSend))) {
+        IPC_ListResumeThread(&(msgQueue->listSend));
+        MDS_CoreInterruptRestore(lock);
+        MDS_SchedulerCheck();
+    } else {
+        MDS_CoreInterruptRestore(lock);
+    }
+}
+
+static void MDS_MsgQueuePublish(MDS_MsgQueue_t *msgQueue, MDS_MsgQueueHeader_t *msg, bool urgent)
+{
+    MDS_Item_t lock = MDS_CoreInterruptLock();
+
+    if (urgent) {
+        msg->next = (MDS_MsgQueueHeader_t *)(msgQueue->lhead);
+        msgQueue->lhead = msg;
+        if (msgQueue->ltail == NULL) {
+            msgQueue->ltail = msg;
+        }
+    } else {
+        msg->next = NULL;
+        if (msgQueue->ltail != NULL) {
+            ((MDS_MsgQueueHeader_t *)(msgQueue->ltail))->next = msg;
+        }
+        msgQueue->ltail = msg;
+        if (msgQueue->lhead == NULL) {
+            msgQueue->lhead = msg;
+        }
+    }
+
+    if (!MDS_ListIsEmpty(&(msgQueue->listRecv))) {
+        IPC_ListResumeThread(&(msgQueue->listRecv));
+        MDS_CoreInterruptRestore(lock);
+        MDS_SchedulerCheck();
+    } else {
+        MDS_CoreInterruptRestore(lock);
+    }
+}
+
 MDS_Err_t MDS_MsgQueueInit(MDS_MsgQueue_t *msgQueue, const char *name, void *queBuff, size_t bufSize, size_t msgSize)
 {
     MDS_ASSERT(msgQueue != NULL);
@@ -961,28 +1145,12 @@ MDS_Err_t MDS_MsgQueueRecvRelease(MDS_MsgQueue_t *msgQueue, void *recv)
     MDS_ASSERT(msgQueue != NULL);
     MDS_ASSERT(MDS_ObjectGetType(&(msgQueue->object)) == MDS_OBJECT_TYPE_MSGQUEUE);
 
-    if (recv == NULL) {
-        return (MDS_EINVAL);
-    }
-
-    MDS_MsgQueueHeader_t *msg = ((MDS_MsgQueueHeader_t *)(*(uintptr_t *)recv)) - 1;
-    if ((((uintptr_t)(msg) - (uintptr_t)(msgQueue->queBuff)) % (sizeof(MDS_MsgQueueHeader_t) + msgQueue->msgSize)) !=
-        0) {
+    MDS_MsgQueueHeader_t *msg = MDS_MsgQueueSlotHeader(msgQueue, recv);
+    if (msg == NULL) {
         return (MDS_EINVAL);
     }
 
-    MDS_Item_t lock = MDS_CoreInterruptLock();
-
-    msg->next = (MDS_MsgQueueHeader_t *)(msgQueue->lfree);
-    msgQueue->lfree = (void *)msg;
-
-    if (!MDS_ListIsEmpty(&(msgQueue->listSend))) {
-        IPC_ListResumeThread(&(msgQueue->listSend));
-        MDS_CoreInterruptRestore(lock);
-        MDS_SchedulerCheck();
-    } else {
-        MDS_CoreInterruptRestore(lock);
-    }
+    MDS_MsgQueueRecycle(msgQueue, msg);
 
     return (MDS_EOK);
 }
@@ -1064,23 +1232,7 @@ MDS_Err_t MDS_MsgQueueSendMsg(MDS_MsgQueue_t *msgQueue, const MDS_MsgList_t *msg
 
     MDS_IPC_PRINT("send message to msgqueue(%p) len:%u", msgQueue, len);
 
-    lock = MDS_CoreInterruptLock();
-
-    if (msgQueue->ltail != NULL) {
-        ((MDS_MsgQueueHeader_t *)(msgQueue->ltail))->next = msg;
-    }
-    msgQueue->ltail = msg;
-    if (msgQueue->lhead == NULL) {
-        msgQueue->lhead = msg;
-    }
-
-    if (!MDS_ListIsEmpty(&(msgQueue->listRecv))) {
-        IPC_ListResumeThread(&(msgQueue->listRecv));
-        MDS_CoreInterruptRestore(lock);
-        MDS_SchedulerCheck();
-    } else {
-        MDS_CoreInterruptRestore(lock);
-    }
+    MDS_MsgQueuePublish(msgQueue, msg, false);
 
     return (MDS_EOK);
 }
@@ -1130,16 +1282,127 @@ MDS_Err_t MDS_MsgQueueUrgentMsg(MDS_MsgQueue_t *msgQueue, const MDS_MsgList_t *m
 
     MDS_IPC_PRINT("send urgent message to msgqueue(%p) len:%u", msgQueue, len);
 
+    MDS_MsgQueuePublish(msgQueue, msg, true);
+
+    return (MDS_EOK);
+}
+
+MDS_Err_t MDS_MsgQueueUrgent(MDS_MsgQueue_t *msgQueue, const void *buff, size_t len)
+{
+    MDS_ASSERT(buff != NULL);
+
+    const MDS_MsgList_t msgList = {.buff = buff, .len = len, .next = NULL};
+
+    return (MDS_MsgQueueUrgentMsg(msgQueue, &msgList));
+}
+
+MDS_Err_t MDS_MsgQueueSendAcquire(MDS_MsgQueue_t *msgQueue, void *send, MDS_Tick_t timeout)
+{
+    MDS_ASSERT(msgQueue != NULL);
+    MDS_ASSERT(MDS_ObjectGetType(&(msgQueue->object)) == MDS_OBJECT_TYPE_MSGQUEUE);
+    MDS_ASSERT(send != NULL);
+
+    MDS_HOOK_CALL(MSGQUEUE_TRY_SEND, msgQueue, timeout);
+
+    size_t cnt = 0;
+    MDS_MsgQueueHeader_t *msg = NULL;
+    MDS_Item_t lock = MDS_CoreInterruptLock();
+    MDS_Err_t err = MDS_MsgQueueListWait(&lock, &(msgQueue->lfree), &(msgQueue->listSend), timeout);
+    if (err == MDS_EOK) {
+        msg = MDS_MsgQueueListTake(&(msgQueue->lfree), 1, &cnt);
+    }
+    MDS_CoreInterruptRestore(lock);
+
+    MDS_HOOK_CALL(MSGQUEUE_HAS_SEND, msgQueue, err);
+
+    if (err != MDS_EOK) {
+        return ((err == MDS_ETIME) ? (MDS_ERANGE) : (err));
+    }
+
+    *((uintptr_t *)send) = (uintptr_t)(msg + 1);
+
+    MDS_IPC_PRINT("acquire send slot(%p) from msgqueue(%p)", msg + 1, msgQueue);
+
+    return (MDS_EOK);
+}
+
+MDS_Err_t MDS_MsgQueueSendCommit(MDS_MsgQueue_t *msgQueue, void *send, size_t len, bool urgent)
+{
+    MDS_ASSERT(msgQueue != NULL);
+    MDS_ASSERT(MDS_ObjectGetType(&(msgQueue->object)) == MDS_OBJECT_TYPE_MSGQUEUE);
+
+    MDS_MsgQueueHeader_t *msg = MDS_MsgQueueSlotHeader(msgQueue, send);
+    if ((msg == NULL) || (len > msgQueue->msgSize)) {
+        return (MDS_EINVAL);
+    }
+
+    if (len == 0) {
+        MDS_MsgQueueRecycle(msgQueue, msg);
+    } else {
+        msg->len = len;
+        MDS_MsgQueuePublish(msgQueue, msg, urgent);
+    }
+
+    MDS_IPC_PRINT("commit send slot(%p) to msgqueue(%p) len:%u urgent:%u", msg + 1, msgQueue, len, urgent);
+
+    return (MDS_EOK);
+}
+
+MDS_Err_t MDS_MsgQueueSendBatch(MDS_MsgQueue_t *msgQueue, const void *buff, size_t len, size_t nums, size_t *cnt,
+                                MDS_Tick_t timeout)
+{
+    MDS_ASSERT(msgQueue != NULL);
+    MDS_ASSERT(MDS_ObjectGetType(&(msgQueue->object)) == MDS_OBJECT_TYPE_MSGQUEUE);
+    MDS_ASSERT(buff != NULL);
+
+    size_t num = 0;
+    if ((len == 0) || (len > msgQueue->msgSize) || (nums == 0)) {
+        return (MDS_EINVAL);
+    }
+
+    MDS_HOOK_CALL(MSGQUEUE_TRY_SEND, msgQueue, timeout);
+
+    MDS_MsgQueueHeader_t *head = NULL;
+    MDS_Item_t lock = MDS_CoreInterruptLock();
+    MDS_Err_t err = MDS_MsgQueueListWait(&lock, &(msgQueue->lfree), &(msgQueue->listSend), timeout);
+    if (err == MDS_EOK) {
+        head = MDS_MsgQueueListTake(&(msgQueue->lfree), nums, &num);
+    }
+    MDS_CoreInterruptRestore(lock);
+
+    MDS_HOOK_CALL(MSGQUEUE_HAS_SEND, msgQueue, err);
+
+    if (cnt != NULL) {
+        *cnt = num;
+    }
+    if (err != MDS_EOK) {
+        return ((err == MDS_ETIME) ? (MDS_ERANGE) : (err));
+    }
+
+    MDS_MsgQueueHeader_t *tail = head;
+    for (const uint8_t *data = (const uint8_t *)buff;; data += len) {
+        tail->len = len;
+        MDS_MemBuffCopy(tail + 1, msgQueue->msgSize, data, len);
+        if (tail->next == NULL) {
+            break;
+        }
+        tail = tail->next;
+    }
+
+    MDS_IPC_PRINT("send batch message to msgqueue(%p) len:%u nums:%u", msgQueue, len, num);
+
     lock = MDS_CoreInterruptLock();
 
-    msg->next = (MDS_MsgQueueHeader_t *)(msgQueue->lhead);
-    msgQueue->lhead = msg;
-    if (msgQueue->ltail == NULL) {
-        msgQueue->ltail = msg;
+    if (msgQueue->ltail != NULL) {
+        ((MDS_MsgQueueHeader_t *)(msgQueue->ltail))->next = head;
+    }
+    msgQueue->ltail = tail;
+    if (msgQueue->lhead == NULL) {
+        msgQueue->lhead = head;
     }
 
     if (!MDS_ListIsEmpty(&(msgQueue->listRecv))) {
-        IPC_ListResumeThread(&(msgQueue->listRecv));
+        IPC_ListResumeThreadNums(&(msgQueue->listRecv), num);
         MDS_CoreInterruptRestore(lock);
         MDS_SchedulerCheck();
     } else {
@@ -1149,13 +1412,68 @@ MDS_Err_t MDS_MsgQueueUrgentMsg(MDS_MsgQueue_t *msgQueue, const MDS_MsgList_t *m
     return (MDS_EOK);
 }
 
-MDS_Err_t MDS_MsgQueueUrgent(MDS_MsgQueue_t *msgQueue, const void *buff, size_t len)
+MDS_Err_t MDS_MsgQueueRecvBatch(MDS_MsgQueue_t *msgQueue, void *buff, size_t size, size_t nums, size_t *lens,
+                                size_t *cnt, MDS_Tick_t timeout)
 {
-    MDS_ASSERT(buff == NULL);
+    MDS_ASSERT(msgQueue != NULL);
+    MDS_ASSERT(MDS_ObjectGetType(&(msgQueue->object)) == MDS_OBJECT_TYPE_MSGQUEUE);
+    MDS_ASSERT(buff != NULL);
 
-    const MDS_MsgList_t msgList = {.buff = buff, .len = len, .next = NULL};
+    size_t num = 0;
+    if ((size == 0) || (nums == 0)) {
+        return (MDS_EINVAL);
+    }
 
-    return (MDS_MsgQueueUrgentMsg(msgQueue, &msgList));
+    MDS_HOOK_CALL(MSGQUEUE_TRY_RECV, msgQueue, timeout);
+
+    MDS_MsgQueueHeader_t *head = NULL;
+    MDS_Item_t lock = MDS_CoreInterruptLock();
+    MDS_Err_t err = MDS_MsgQueueListWait(&lock, &(msgQueue->lhead), &(msgQueue->listRecv), timeout);
+    if (err == MDS_EOK) {
+        head = MDS_MsgQueueListTake(&(msgQueue->lhead), nums, &num);
+        if (msgQueue->lhead == NULL) {
+            msgQueue->ltail = NULL;
+        }
+    }
+    MDS_CoreInterruptRestore(lock);
+
+    MDS_HOOK_CALL(MSGQUEUE_HAS_RECV, msgQueue, err);
+
+    if (cnt != NULL) {
+        *cnt = num;
+    }
+    if (err != MDS_EOK) {
+        return (err);
+    }
+
+    MDS_MsgQueueHeader_t *tail = head;
+    for (uint8_t *data = (uint8_t *)buff;; data += size) {
+        size_t len = MDS_MemBuffCopy(data, size, tail + 1, tail->len);
+        if (lens != NULL) {
+            *lens++ = len;
+        }
+        if (tail->next == NULL) {
+            break;
+        }
+        tail = tail->next;
+    }
+
+    MDS_IPC_PRINT("recv batch message from msgqueue(%p) nums:%u", msgQueue, num);
+
+    lock = MDS_CoreInterruptLock();
+
+    tail->next = (MDS_MsgQueueHeader_t *)(msgQueue->lfree);
+    msgQueue->lfree = (void *)head;
+
+    if (!MDS_ListIsEmpty(&(msgQueue->listSend))) {
+        IPC_ListResumeThreadNums(&(msgQueue->listSend), num);
+        MDS_CoreInterruptRestore(lock);
+        MDS_SchedulerCheck();
+    } else {
+        MDS_CoreInterruptRestore(lock);
+    }
+
+    return (MDS_EOK);
 }
 
 size_t MDS_MsgQueueGetMsgSize(const MDS_MsgQueue_t *msgQueue)
@@ -1206,7 +1524,8 @@ union MDS_MemPoolHeader {
 
 static void MDS_MemPoolListInit(MDS_MemPool_t *memPool, size_t blkNums)
 {
-    memPool->lfree = memPool->memBuff;
+    memPool->lfree = NULL;
+    memPool->blkFree = blkNums;
 
     for (size_t idx = 0; idx < blkNums; idx++) {
         union MDS_MemPoolHeader *list = (union MDS_MemPoolHeader *)(&(
@@ -1248,7 +1567,7 @@ MDS_MemPool_t *MDS_MemPoolCreate(const char *name, size_t blkSize, size_t blkNum
 
     if (memPool != NULL) {
         memPool->blkSize = VALUE_ALIGN(blkSize + MDS_SYSMEM_ALIGN_SIZE - 1, MDS_SYSMEM_ALIGN_SIZE);
-        memPool->memBuff = MDS_SysMemAlloc((memPool->blkSize + sizeof(MDS_MsgQueueHeader_t)) * blkNums);
+        memPool->memBuff = MDS_SysMemAlloc((memPool->blkSize + sizeof(union MDS_MemPoolHeader)) * blkNums);
         if (memPool->memBuff == NULL) {
             MDS_ObjectDestory(&(memPool->object));
             return (NULL);
@@ -1272,49 +1591,57 @@ MDS_Err_t MDS_MemPoolDestroy(MDS_MemPool_t *memPool)
     return (MDS_ObjectDestory(&(memPool->object)));
 }
 
-void *MDS_MemPoolAlloc(MDS_MemPool_t *memPool, MDS_Tick_t timeout)
+static union MDS_MemPoolHeader *MDS_MemPoolAllocBlk(MDS_MemPool_t *memPool)
 {
-    MDS_ASSERT(memPool != NULL);
-    MDS_ASSERT(MDS_ObjectGetType(&(memPool->object)) == MDS_OBJECT_TYPE_MEMPOOL);
+    union MDS_MemPoolHeader *blk = (union MDS_MemPoolHeader *)(memPool->lfree);
 
-    MDS_HOOK_CALL(MEMPOOL_TRY_ALLOC, memPool, timeout);
+    if (blk != NULL) {
+        memPool->lfree = (void *)(blk->next);
+        memPool->blkFree -= 1;
+        blk->memPool = memPool;
+    }
 
-    MDS_Thread_t *thread = MDS_KernelCurrentThread();
+    return (blk);
+}
 
-    MDS_Err_t err = MDS_EOK;
+static union MDS_MemPoolHeader *MDS_MemPoolAllocWait(MDS_MemPool_t *memPool, MDS_Item_t *lock, MDS_Tick_t timeout)
+{
+    MDS_Thread_t *thread = MDS_KernelCurrentThread();
     union MDS_MemPoolHeader *blk = NULL;
-    MDS_Item_t lock = MDS_CoreInterruptLock();
-    do {
-        if (memPool->lfree == NULL) {
-            if (timeout == 0) {
-                err = MDS_ETIME;
-                break;
-            }
 
-            MDS_ASSERT(thread != NULL);
+    MDS_ASSERT(MDS_CoreInterruptCurrent() == 0);
+    MDS_ASSERT(thread != NULL);
 
-            MDS_IPC_PRINT("mempool(%p) alloc blocksize:%u suspend thread(%p) entry:%p timer wait:%u", memPool,
-                          memPool->blkSize, thread, thread->entry, timeout);
-        }
+    MDS_IPC_PRINT("mempool(%p) alloc blocksize:%u suspend thread(%p) entry:%p timer wait:%u", memPool,
+                  memPool->blkSize, thread, thread->entry, timeout);
 
-        while (memPool->lfree == NULL) {
-            err = IPC_ListSuspendWait(&lock, &(memPool->list), thread, timeout);
-            if (err != MDS_EOK) {
-                break;
-            }
+    do {
+        if (IPC_ListSuspendWait(lock, &(memPool->list), thread, timeout) != MDS_EOK) {
+            break;
         }
+        blk = MDS_MemPoolAllocBlk(memPool);
+    } while (blk == NULL);
 
-        if (err == MDS_EOK) {
-            blk = (union MDS_MemPoolHeader *)(memPool->lfree);
-            memPool->lfree = (void *)(blk->next);
-            blk->memPool = memPool;
-        }
-    } while (0);
+    return (blk);
+}
+
+void *MDS_MemPoolAlloc(MDS_MemPool_t *memPool, MDS_Tick_t timeout)
+{
+    MDS_ASSERT(memPool != NULL);
+    MDS_ASSERT(MDS_ObjectGetType(&(memPool->object)) == MDS_OBJECT_TYPE_MEMPOOL);
+
+    MDS_HOOK_CALL(MEMPOOL_TRY_ALLOC, memPool, timeout);
+
+    MDS_Item_t lock = MDS_CoreInterruptLock();
+    union MDS_MemPoolHeader *blk = MDS_MemPoolAllocBlk(memPool);
+    if ((blk == NULL) && (timeout != 0)) {
+        blk = MDS_MemPoolAllocWait(memPool, &lock, timeout);
+    }
     MDS_CoreInterruptRestore(lock);
 
     MDS_HOOK_CALL(MEMPOOL_HAS_ALLOC, memPool, blk);
 
-    return (((err == MDS_EOK) && (blk != NULL)) ? ((void *)(blk + 1)) : (NULL));
+    return ((blk != NULL) ? ((void *)(blk + 1)) : (NULL));
 }
 
 static void MDS_MemPoolFreeBlk(union MDS_MemPoolHeader *blk)
@@ -1330,13 +1657,14 @@ static void MDS_MemPoolFreeBlk(union MDS_MemPoolHeader *blk)
 
     blk->next = memPool->lfree;
     memPool->lfree = blk;
+    memPool->blkFree += 1;
 
-    if (!MDS_ListIsEmpty(&(memPool->list))) {
-        IPC_ListResumeThread(&(memPool->list));
+    if (MDS_ListIsEmpty(&(memPool->list))) {
         MDS_CoreInterruptRestore(lock);
-        MDS_SchedulerCheck();
     } else {
+        IPC_ListResumeThread(&(memPool->list));
         MDS_CoreInterruptRestore(lock);
+        MDS_SchedulerCheck();
     }
 
     MDS_HOOK_CALL(MEMPOOL_HAS_FREE, memPool, blk);
@@ -1369,13 +1697,5 @@ size_t MDS_MemPoolGetBlkFree(const MDS_MemPool_t *memPool)
     MDS_ASSERT(memPool != NULL);
     MDS_ASSERT(MDS_ObjectGetType(&(memPool->object)) == MDS_OBJECT_TYPE_MEMPOOL);
 
-    size_t cnt = 0;
-    register MDS_Item_t lock = MDS_CoreInterruptLock();
-    union MDS_MemPoolHeader *blk = (union MDS_MemPoolHeader *)(memPool->lfree);
-    for (; blk != NULL; blk = blk->next) {
-        cnt += 1;
-    }
-    MDS_CoreInterruptRestore(lock);
-
-    return (cnt);
+    return (memPool->blkFree);
 }
@@ -25,6 +25,14 @@ extern void MDS_SchedulerInsertThread(MDS_Thread_t *thread);
 extern void MDS_SchedulerRemoveThread(MDS_Thread_t *thread);
 extern void MDS_SchedulerPushDefunct(MDS_Thread_t *thread);
 extern MDS_Thread_t *MDS_SchedulerPopDefunct(void);
+extern size_t MDS_SchedulerFFS(size_t value);
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+extern void MDS_SchedulerRunTimeUpdate(MDS_Thread_t *thread);
+#endif
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+extern void MDS_SchedulerEdfRenew(MDS_Thread_t *thread);
+extern bool MDS_SchedulerEdfBudget(MDS_Thread_t *thread);
+#endif
 
 /* Timer ------------------------------------------------------------------- */
 extern void MDS_SysTimerInit(void);
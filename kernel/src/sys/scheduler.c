@@ -43,6 +43,68 @@ static void MDS_SchedulerInit(void)
     MDS_SkipListInitNode(g_sysSchedulerTable, ARRAY_SIZE(g_sysSchedulerTable));
 }
 
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+#if (MDS_THREAD_EDF_PRIORITY >= (MDS_THREAD_PRIORITY_MAX - 1))
+#error "kernel edf scheduler priority band must be higher than idle thread"
+#endif
+
+static bool MDS_SchedulerEdfBefore(const MDS_Thread_t *thread, const MDS_Thread_t *other)
+{
+    if (thread->edfPeriod == 0U) {
+        return (false);
+    }
+    if (other->edfPeriod == 0U) {
+        return (true);
+    }
+
+    return ((MDS_Tick_t)(thread->edfDeadline - other->edfDeadline) > MDS_TIMER_TICK_MAX);
+}
+
+static void MDS_SchedulerEdfInsert(MDS_Thread_t *thread, bool isWakeup)
+{
+    MDS_Thread_t *iter = NULL;
+
+    if ((isWakeup) && (thread->edfPeriod != 0U)) {
+        MDS_SchedulerEdfRenew(thread);
+    }
+
+    MDS_LIST_FOREACH_NEXT (iter, node, &(g_sysSchedulerTable[MDS_THREAD_EDF_PRIORITY])) {
+        if (MDS_SchedulerEdfBefore(thread, iter)) {
+            break;
+        }
+    }
+    MDS_ListInsertNodePrev(&(iter->node), &(thread->node));
+}
+
+void MDS_SchedulerEdfRenew(MDS_Thread_t *thread)
+{
+    MDS_Tick_t tickcnt = MDS_SysTickGetCount();
+    MDS_Tick_t elapsed = tickcnt - thread->edfRelease;
+
+    if (elapsed < thread->edfPeriod) {
+        return;
+    }
+
+    thread->edfRelease = (elapsed < (thread->edfPeriod << 1)) ? (thread->edfRelease + thread->edfPeriod) : (tickcnt);
+    thread->edfDeadline = thread->edfRelease + thread->edfRelative;
+    thread->edfRemain = thread->edfBudget;
+}
+
+bool MDS_SchedulerEdfBudget(MDS_Thread_t *thread)
+{
+    if (thread->edfRemain > 1U) {
+        thread->edfRemain -= 1U;
+        return (false);
+    }
+
+    /* budget overrun: postpone the deadline so the others keep their bandwidth */
+    thread->edfDeadline += thread->edfPeriod;
+    thread->edfRemain = thread->edfBudget;
+
+    return (true);
+}
+#endif
+
 void MDS_SchedulerInsertThread(MDS_Thread_t *thread)
 {
     MDS_ASSERT(thread->currPrio < MDS_THREAD_PRIORITY_MAX);
@@ -50,11 +112,21 @@ void MDS_SchedulerInsertThread(MDS_Thread_t *thread)
     if (MDS_KernelCurrentThread() == thread) {
         thread->state = (thread->state & ~MDS_THREAD_STATE_MASK) | MDS_THREAD_STATE_RUNNING;
     } else {
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+        bool isWakeup = ((thread->state & MDS_THREAD_STATE_MASK) != MDS_THREAD_STATE_READY) &&
+                        ((thread->state & MDS_THREAD_STATE_MASK) != MDS_THREAD_STATE_RUNNING);
+#endif
         thread->state = (thread->state & ~MDS_THREAD_STATE_MASK) | MDS_THREAD_STATE_READY;
 
         MDS_ListRemoveNode(&(thread->node));
 
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+        if (thread->currPrio == MDS_THREAD_EDF_PRIORITY) {
+            MDS_SchedulerEdfInsert(thread, isWakeup);
+        } else if ((thread->state & MDS_THREAD_STATE_YIELD) != 0U) {
+#else
         if ((thread->state & MDS_THREAD_STATE_YIELD) != 0U) {
+#endif
             MDS_ListInsertNodePrev(&(g_sysSchedulerTable[thread->currPrio]), &(thread->node));
         } else {
             MDS_ListInsertNodeNext(&(g_sysSchedulerTable[thread->currPrio]), &(thread->node));
@@ -128,6 +200,62 @@ static MDS_Thread_t *MDS_SchedulerGetHighestPriorityThread(void)
     return (thread);
 }
 
+/* RunTime ----------------------------------------------------------------- */
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+static size_t g_sysRunTimeStamp = 0U;
+static uint64_t g_sysRunTimeTotal = 0U;
+static uint64_t g_sysCpuLoadTotal = 0U;
+static uint64_t g_sysCpuLoadIdle = 0U;
+
+__attribute__((weak)) size_t MDS_CoreCycleCount(void)
+{
+    return (MDS_SysTickGetCount());
+}
+
+void MDS_SchedulerRunTimeUpdate(MDS_Thread_t *thread)
+{
+    size_t stamp = MDS_CoreCycleCount();
+    size_t delta = stamp - g_sysRunTimeStamp;
+
+    g_sysRunTimeStamp = stamp;
+    g_sysRunTimeTotal += delta;
+    thread->runTime += delta;
+}
+
+uint64_t MDS_ThreadGetRunTime(const MDS_Thread_t *thread)
+{
+    MDS_ASSERT(thread != NULL);
+
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    if (thread == g_sysCurrThread) {
+        MDS_SchedulerRunTimeUpdate(g_sysCurrThread);
+    }
+    uint64_t runTime = thread->runTime;
+    MDS_CoreInterruptRestore(lock);
+
+    return (runTime);
+}
+
+uint64_t MDS_KernelGetIdleTime(void)
+{
+    return (MDS_ThreadGetRunTime(MDS_KernelGetIdleThread()));
+}
+
+size_t MDS_KernelGetCpuLoad(void)
+{
+    uint64_t idleTime = MDS_KernelGetIdleTime();
+
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    uint64_t total = g_sysRunTimeTotal - g_sysCpuLoadTotal;
+    uint64_t idle = idleTime - g_sysCpuLoadIdle;
+    g_sysCpuLoadTotal = g_sysRunTimeTotal;
+    g_sysCpuLoadIdle = idleTime;
+    MDS_CoreInterruptRestore(lock);
+
+    return ((total > idle) ? ((size_t)((total - idle) * 100U / total)) : (0U));
+}
+#endif
+
 /* Scheduler --------------------------------------------------------------- */
 void MDS_SchedulerCheck(void)
 {
@@ -149,6 +277,15 @@ void MDS_SchedulerCheck(void)
         if ((currThread->state & MDS_THREAD_STATE_MASK) == MDS_THREAD_STATE_RUNNING) {
             if (currThread->currPrio < toThread->currPrio) {
                 toThread = currThread;
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+            } else if ((currThread->currPrio == toThread->currPrio) &&
+                       (currThread->currPrio == MDS_THREAD_EDF_PRIORITY)) {
+                if (MDS_SchedulerEdfBefore(toThread, currThread)) {
+                    threadReady = true;
+                } else {
+                    toThread = currThread;
+                }
+#endif
             } else if ((currThread->currPrio == toThread->currPrio) &&
                        ((currThread->state & MDS_THREAD_STATE_YIELD) == 0)) {
                 toThread = currThread;
@@ -177,6 +314,10 @@ void MDS_SchedulerCheck(void)
                           toThread->stackPoint);
             }
 
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+            MDS_SchedulerRunTimeUpdate(currThread);
+#endif
+
             MDS_HOOK_CALL(SCHEDULER_SWITCH, toThread, currThread);
 
             MDS_CoreSchedulerSwitch(&(currThread->stackPoint), &(toThread->stackPoint));
@@ -233,6 +374,10 @@ void MDS_KernelStartup(void)
     g_sysCurrThread = toThread;
     toThread->state = MDS_THREAD_STATE_RUNNING;
 
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+    g_sysRunTimeStamp = MDS_CoreCycleCount();
+#endif
+
     MDS_SCHEDULER_PRINT("scheduler thread startup with thread(%p) entry:%p sp:%p priority:%u", toThread,
                         toThread->entry, toThread->stackPoint, toThread->currPrio);
 
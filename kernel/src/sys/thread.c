@@ -68,6 +68,7 @@ static void THREAD_Timeout(MDS_Arg_t *arg)
     MDS_SchedulerInsertThread(thread);
 
     thread->err = MDS_ETIME;
+    thread->pendMutex = NULL;
 
     MDS_CoreInterruptRestore(lock);
 
@@ -92,6 +93,9 @@ static MDS_Err_t THREAD_Init(MDS_Thread_t *thread, MDS_ThreadEntry_t entry, MDS_
 
     thread->stackPoint = MDS_CoreThreadStackInit(thread->stackBase, thread->stackSize, (void *)entry, (void *)arg,
                                                  (void *)THREAD_Exit);
+#if (defined(MDS_THREAD_STACK_WATERMARK) && (MDS_THREAD_STACK_WATERMARK > 0))
+    thread->stackFree = stackSize;
+#endif
 
     thread->eventMask = 0U;
     thread->eventOpt = 0U;
@@ -99,10 +103,26 @@ static MDS_Err_t THREAD_Init(MDS_Thread_t *thread, MDS_ThreadEntry_t entry, MDS_
 
     thread->initPrio = priority;
     thread->currPrio = priority;
+    MDS_ListInitNode(&(thread->mutexList));
+    thread->pendMutex = NULL;
 
     thread->initTick = ticks;
     thread->remainTick = ticks;
 
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+    thread->runTime = 0;
+#endif
+
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+    thread->edfPeriod = 0U;
+    thread->edfBudget = 0U;
+    thread->edfRelative = 0U;
+    thread->edfRelease = 0U;
+    thread->edfDeadline = 0U;
+    thread->edfRemain = 0U;
+    thread->edfMiss = 0U;
+#endif
+
     thread->err = MDS_EOK;
     MDS_Err_t err = MDS_TimerInit(&(thread->timer), thread->object.name, MDS_TIMER_TYPE_ONCE | MDS_TIMER_TYPE_SYSTEM,
                                   THREAD_Timeout, (MDS_Arg_t *)thread);
@@ -309,3 +329,93 @@ MDS_ThreadState_t MDS_ThreadGetState(const MDS_Thread_t *thread)
 {
     return (thread->state & MDS_THREAD_STATE_MASK);
 }
+
+#if (defined(MDS_THREAD_STACK_WATERMARK) && (MDS_THREAD_STACK_WATERMARK > 0))
+size_t MDS_ThreadGetStackMaxUsed(const MDS_Thread_t *thread)
+{
+    MDS_ASSERT(thread != NULL);
+
+    return (thread->stackSize - thread->stackFree);
+}
+#endif
+
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+MDS_Err_t MDS_ThreadSetDeadline(MDS_Thread_t *thread, MDS_Tick_t period, MDS_Tick_t budget, MDS_Tick_t deadline)
+{
+    MDS_ASSERT(thread != NULL);
+    MDS_ASSERT(MDS_ObjectGetType(&(thread->object)) == MDS_OBJECT_TYPE_THREAD);
+
+    if (deadline == 0U) {
+        deadline = period;
+    }
+    if ((period == 0U) || (period >= MDS_TIMER_TICK_MAX) || (budget == 0U) || (budget > deadline) ||
+        (deadline > period)) {
+        return (MDS_EINVAL);
+    }
+
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+
+    if ((thread->state & MDS_THREAD_STATE_MASK) != MDS_THREAD_STATE_INACTIVED) {
+        MDS_CoreInterruptRestore(lock);
+        return (MDS_EBUSY);
+    }
+
+    thread->initPrio = MDS_THREAD_EDF_PRIORITY;
+    thread->currPrio = MDS_THREAD_EDF_PRIORITY;
+    thread->edfPeriod = period;
+    thread->edfBudget = budget;
+    thread->edfRelative = deadline;
+    thread->edfRelease = MDS_SysTickGetCount() - period;
+    thread->edfDeadline = thread->edfRelease + deadline;
+    thread->edfRemain = budget;
+    thread->edfMiss = 0U;
+
+    MDS_CoreInterruptRestore(lock);
+
+    MDS_THREAD_PRINT("thread(%p) entry:%p set deadline period:%u budget:%u deadline:%u", thread, thread->entry,
+                     period, budget, deadline);
+
+    return (MDS_EOK);
+}
+
+MDS_Err_t MDS_ThreadWaitPeriod(void)
+{
+    register MDS_Item_t lock = MDS_CoreInterruptLock();
+    MDS_Thread_t *thread = MDS_KernelCurrentThread();
+
+    MDS_ASSERT(thread != NULL);
+
+    if (thread->edfPeriod == 0U) {
+        MDS_CoreInterruptRestore(lock);
+        return (MDS_EINVAL);
+    }
+
+    MDS_Tick_t tickcnt = MDS_SysTickGetCount();
+    MDS_Tick_t next = thread->edfRelease + thread->edfPeriod;
+
+    if ((tickcnt - thread->edfRelease) > thread->edfRelative) {
+        thread->edfMiss += 1U;
+    }
+
+    MDS_Tick_t delay = next - tickcnt;
+    if ((delay != 0U) && (delay <= MDS_TIMER_TICK_MAX)) {
+        MDS_CoreInterruptRestore(lock);
+        return (MDS_ThreadDelay(delay));
+    }
+
+    /* next job already released, renew deadline and let an earlier one preempt */
+    MDS_SchedulerEdfRenew(thread);
+    MDS_SchedulerCheck();
+
+    MDS_CoreInterruptRestore(lock);
+
+    return (MDS_EOK);
+}
+
+size_t MDS_ThreadGetDeadlineMiss(const MDS_Thread_t *thread)
+{
+    MDS_ASSERT(thread != NULL);
+
+    return (thread->edfMiss);
+}
+#endif
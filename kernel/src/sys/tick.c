@@ -40,7 +40,15 @@ void MDS_SysTickIncCount(void)
     if (thread == NULL) {
         MDS_CoreInterruptRestore(lock);
     } else {
+#if (defined(MDS_THREAD_RUNTIME) && (MDS_THREAD_RUNTIME > 0))
+        MDS_SchedulerRunTimeUpdate(thread);
+#endif
         thread->remainTick -= 1U;
+#if (defined(MDS_THREAD_EDF) && (MDS_THREAD_EDF > 0))
+        if (thread->edfPeriod != 0U) {
+            thread->remainTick = (MDS_SchedulerEdfBudget(thread)) ? (0U) : (thread->initTick);
+        }
+#endif
         if (thread->remainTick == 0) {
             thread->remainTick = thread->initTick;
             thread->state |= MDS_THREAD_STATE_YIELD;
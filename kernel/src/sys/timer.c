@@ -25,8 +25,43 @@ MDS_HOOK_INIT(TIMER_STOP, MDS_Timer_t *timer);
 #define MDS_TIMER_PRINT(fmt, ...)
 #endif
 
+#if (defined(MDS_TIMER_WHEEL) && (MDS_TIMER_WHEEL > 0))
+#ifndef MDS_TIMER_WHEEL_LEVEL
+#define MDS_TIMER_WHEEL_LEVEL 4
+#endif
+
+#ifndef MDS_TIMER_WHEEL_BITS
+#define MDS_TIMER_WHEEL_BITS 5
+#endif
+
+#if ((MDS_TIMER_WHEEL_BITS > 5) || ((MDS_TIMER_WHEEL_BITS * MDS_TIMER_WHEEL_LEVEL) >= (__SIZEOF_SIZE_T__ * 8 - 1)))
+#error "kernel timer wheel supported max bits:5 and total range must below MDS_TIMER_TICK_MAX"
+#endif
+
+#define TIMER_WHEEL_SLOTS            (1UL << MDS_TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK             (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_RANGE            (1UL << (MDS_TIMER_WHEEL_BITS * MDS_TIMER_WHEEL_LEVEL))
+#define TIMER_WHEEL_INDEX(tick, lvl) (((tick) >> (MDS_TIMER_WHEEL_BITS * (lvl))) & TIMER_WHEEL_MASK)
+#endif
+
+/* Typedef ----------------------------------------------------------------- */
+#if (defined(MDS_TIMER_WHEEL) && (MDS_TIMER_WHEEL > 0))
+struct TimerList {
+    MDS_Tick_t currTick;
+    MDS_Tick_t nextTick;
+    bool nextValid;
+    uint32_t bitmap[MDS_TIMER_WHEEL_LEVEL];
+    MDS_ListNode_t slot[MDS_TIMER_WHEEL_LEVEL][TIMER_WHEEL_SLOTS];
+    MDS_ListNode_t overflow;
+};
+#else
+struct TimerList {
+    MDS_ListNode_t skipList[MDS_TIMER_SKIPLIST_LEVEL];
+};
+#endif
+
 /* Variable ---------------------------------------------------------------- */
-static MDS_ListNode_t g_sysTimerSkipList[MDS_TIMER_SKIPLIST_LEVEL];
+static struct TimerList g_sysTimerList;
 
 #ifdef MDS_THREAD_TIMER_ENABLE
 #ifndef MDS_THREAD_TIMER_STACKSIZE
@@ -42,12 +77,177 @@ static MDS_ListNode_t g_sysTimerSkipList[MDS_TIMER_SKIPLIST_LEVEL];
 #endif
 
 static bool g_softIsBusy;
-static MDS_ListNode_t g_softTimerSkipList[MDS_TIMER_SKIPLIST_LEVEL];
+static struct TimerList g_softTimerList;
 static MDS_Thread_t g_softTimerThread;
 static uint8_t g_softTimerStack[MDS_THREAD_TIMER_STACKSIZE];
 #endif
 
 /* Function ---------------------------------------------------------------- */
+#if (defined(MDS_TIMER_WHEEL) && (MDS_TIMER_WHEEL > 0))
+static void TIMER_ListInit(struct TimerList *list)
+{
+    list->currTick = MDS_SysTickGetCount();
+    list->nextValid = false;
+    MDS_ListInitNode(&(list->overflow));
+    for (size_t lvl = 0; lvl < ARRAY_SIZE(list->slot); lvl++) {
+        list->bitmap[lvl] = 0U;
+        MDS_SkipListInitNode(list->slot[lvl], ARRAY_SIZE(list->slot[lvl]));
+    }
+}
+
+static bool TIMER_ListIsInit(const struct TimerList *list)
+{
+    return ((list->slot[0][0].next != NULL) && (list->slot[0][0].prev != NULL));
+}
+
+static void TIMER_ListInsert(struct TimerList *list, MDS_Timer_t *timer)
+{
+    MDS_Tick_t diffTick = timer->ticklimit - list->currTick;
+    MDS_Tick_t expire = timer->ticklimit;
+    size_t lvl = 0;
+
+    if (diffTick >= MDS_TIMER_TICK_MAX) {
+        expire = list->currTick;
+    } else if (diffTick >= TIMER_WHEEL_RANGE) {
+        MDS_ListInsertNodePrev(&(list->overflow), &(timer->node[0]));
+        expire = MDS_TICK_FOREVER;
+    } else {
+        while ((lvl < (MDS_TIMER_WHEEL_LEVEL - 1)) && (diffTick >= (1UL << (MDS_TIMER_WHEEL_BITS * (lvl + 1))))) {
+            lvl += 1;
+        }
+    }
+
+    if (expire != MDS_TICK_FOREVER) {
+        size_t idx = TIMER_WHEEL_INDEX(expire, lvl);
+        MDS_ListInsertNodePrev(&(list->slot[lvl][idx]), &(timer->node[0]));
+        list->bitmap[lvl] |= (1UL << idx);
+    }
+
+    if ((list->nextValid) && ((timer->ticklimit - list->currTick) < (list->nextTick - list->currTick))) {
+        list->nextTick = timer->ticklimit;
+    }
+}
+
+static void TIMER_ListRemove(struct TimerList *list, MDS_Timer_t *timer)
+{
+    MDS_ListNode_t *head = timer->node[0].next;
+
+    if ((head == timer->node[0].prev) && (head >= &(list->slot[0][0])) &&
+        (head <= &(list->slot[MDS_TIMER_WHEEL_LEVEL - 1][TIMER_WHEEL_MASK]))) {
+        size_t pos = head - &(list->slot[0][0]);
+        list->bitmap[pos / TIMER_WHEEL_SLOTS] &= ~(1UL << (pos % TIMER_WHEEL_SLOTS));
+    }
+    if ((list->nextValid) && (timer->ticklimit == list->nextTick)) {
+        list->nextValid = false;
+    }
+
+    MDS_SkipListRemoveNode(timer->node, ARRAY_SIZE(timer->node));
+}
+
+static void TIMER_ListReinsert(struct TimerList *list, MDS_ListNode_t *head)
+{
+    if (MDS_ListIsEmpty(head)) {
+        return;
+    }
+
+    MDS_ListNode_t cascade = {.prev = head->prev, .next = head->next};
+    cascade.prev->next = &cascade;
+    cascade.next->prev = &cascade;
+    MDS_ListInitNode(head);
+
+    while (!MDS_ListIsEmpty(&cascade)) {
+        MDS_Timer_t *t = CONTAINER_OF(cascade.next, MDS_Timer_t, node[0]);
+        MDS_ListRemoveNode(&(t->node[0]));
+        TIMER_ListInsert(list, t);
+    }
+}
+
+static void TIMER_ListCascade(struct TimerList *list)
+{
+    for (size_t lvl = 1; lvl < MDS_TIMER_WHEEL_LEVEL; lvl++) {
+        size_t idx = TIMER_WHEEL_INDEX(list->currTick, lvl);
+
+        list->bitmap[lvl] &= ~(1UL << idx);
+        TIMER_ListReinsert(list, &(list->slot[lvl][idx]));
+
+        if (idx != 0) {
+            return;
+        }
+    }
+
+    TIMER_ListReinsert(list, &(list->overflow));
+}
+
+static MDS_Timer_t *TIMER_ListExpired(struct TimerList *list, MDS_Tick_t currTick)
+{
+    while ((currTick - list->currTick) < MDS_TIMER_TICK_MAX) {
+        size_t idx = TIMER_WHEEL_INDEX(list->currTick, 0);
+        if (!MDS_ListIsEmpty(&(list->slot[0][idx]))) {
+            MDS_Timer_t *t = CONTAINER_OF(list->slot[0][idx].next, MDS_Timer_t, node[0]);
+            TIMER_ListRemove(list, t);
+            return (t);
+        }
+
+        MDS_Tick_t nextTick = list->currTick + 1;
+        if ((list->bitmap[0] & ~((2UL << idx) - 1)) == 0U) {
+            nextTick = (list->currTick | TIMER_WHEEL_MASK) + 1;
+        }
+        if ((nextTick - list->currTick) > (currTick + 1 - list->currTick)) {
+            nextTick = currTick + 1;
+        }
+
+        list->currTick = nextTick;
+        if (TIMER_WHEEL_INDEX(nextTick, 0) == 0U) {
+            TIMER_ListCascade(list);
+        }
+    }
+
+    return (NULL);
+}
+
+static MDS_Tick_t TIMER_ListNextTick(struct TimerList *list)
+{
+    if (list->nextValid) {
+        return (list->nextTick);
+    }
+
+    MDS_Tick_t diffTick = MDS_TICK_FOREVER;
+
+    for (size_t lvl = 0; lvl < MDS_TIMER_WHEEL_LEVEL; lvl++) {
+        uint32_t bitmap = list->bitmap[lvl];
+        if (bitmap == 0U) {
+            continue;
+        }
+
+        size_t idx = TIMER_WHEEL_INDEX(list->currTick, lvl) + ((lvl > 0) ? (1) : (0));
+        uint32_t upper = (idx < TIMER_WHEEL_SLOTS) ? (bitmap & ~((1UL << idx) - 1)) : (0U);
+        size_t pos = MDS_SchedulerFFS((upper != 0U) ? (upper) : (bitmap)) - 1;
+
+        MDS_Timer_t *t = NULL;
+        MDS_LIST_FOREACH_NEXT (t, node[0], &(list->slot[lvl][pos])) {
+            if ((t->ticklimit - list->currTick) < diffTick) {
+                diffTick = t->ticklimit - list->currTick;
+            }
+        }
+    }
+
+    MDS_Timer_t *t = NULL;
+    MDS_LIST_FOREACH_NEXT (t, node[0], &(list->overflow)) {
+        if ((t->ticklimit - list->currTick) < diffTick) {
+            diffTick = t->ticklimit - list->currTick;
+        }
+    }
+
+    if (diffTick == MDS_TICK_FOREVER) {
+        return (MDS_TICK_FOREVER);
+    }
+
+    list->nextTick = list->currTick + diffTick;
+    list->nextValid = true;
+
+    return (list->nextTick);
+}
+#else
 static int TIMER_SkipListCompare(const MDS_ListNode_t *node, const void *value)
 {
     const MDS_Timer_t *timer = CONTAINER_OF(node, MDS_Timer_t, node);
@@ -57,28 +257,84 @@ static int TIMER_SkipListCompare(const MDS_ListNode_t *node, const void *value)
     return ((diffTick != 0) && (diffTick < MDS_TIMER_TICK_MAX)) ? (1) : (-1);
 }
 
-static void TIMER_Check(MDS_ListNode_t timerList[], size_t size, bool isSoft)
+static void TIMER_ListInit(struct TimerList *list)
+{
+    MDS_SkipListInitNode(list->skipList, ARRAY_SIZE(list->skipList));
+}
+
+static bool TIMER_ListIsInit(const struct TimerList *list)
+{
+    return ((list->skipList[0].next != NULL) && (list->skipList[0].prev != NULL));
+}
+
+static void TIMER_ListInsert(struct TimerList *list, MDS_Timer_t *timer)
+{
+    static size_t skipRand = 0;
+
+    MDS_ListNode_t *skipList = MDS_SkipListSearchNode(list->skipList, ARRAY_SIZE(timer->node), &(timer->ticklimit),
+                                                      TIMER_SkipListCompare);
+
+    skipRand = skipRand + timer->tickstart + 1;
+    MDS_SkipListInsertNode(skipList, timer->node, ARRAY_SIZE(timer->node), skipRand, MDS_TIMER_SKIPLIST_SHIFT);
+}
+
+static void TIMER_ListRemove(struct TimerList *list, MDS_Timer_t *timer)
+{
+    UNUSED(list);
+
+    MDS_SkipListRemoveNode(timer->node, ARRAY_SIZE(timer->node));
+}
+
+static MDS_Timer_t *TIMER_ListExpired(struct TimerList *list, MDS_Tick_t currTick)
 {
-    if ((timerList[0].next == NULL) || (timerList[0].prev == NULL)) {
+    const size_t size = ARRAY_SIZE(list->skipList);
+
+    if (MDS_ListIsEmpty(&(list->skipList[size - 1]))) {
+        return (NULL);
+    }
+
+    MDS_Timer_t *t = CONTAINER_OF(list->skipList[size - 1].next, MDS_Timer_t, node[size - 1]);
+    if ((currTick - t->ticklimit) >= MDS_TIMER_TICK_MAX) {
+        return (NULL);
+    }
+
+    MDS_SkipListRemoveNode(t->node, size);
+
+    return (t);
+}
+
+static MDS_Tick_t TIMER_ListNextTick(struct TimerList *list)
+{
+    const size_t size = ARRAY_SIZE(list->skipList);
+
+    if (MDS_ListIsEmpty(&(list->skipList[size - 1]))) {
+        return (MDS_TICK_FOREVER);
+    }
+
+    return (CONTAINER_OF(list->skipList[size - 1].next, MDS_Timer_t, node[size - 1])->ticklimit);
+}
+#endif
+
+static void TIMER_Check(struct TimerList *list, bool isSoft)
+{
+    if (!TIMER_ListIsInit(list)) {
         return;
     }
 
     MDS_ListNode_t runList = {.prev = &runList, .next = &runList};
     register MDS_Item_t lock = MDS_CoreInterruptLock();
 
-    while (!MDS_ListIsEmpty(&timerList[size - 1])) {
+    for (;;) {
         MDS_Tick_t currTick = MDS_SysTickGetCount();
-        MDS_Timer_t *t = CONTAINER_OF(timerList[size - 1].next, MDS_Timer_t, node[size - 1]);
-
-        if ((currTick - t->ticklimit) >= MDS_TIMER_TICK_MAX) {
+        MDS_Timer_t *t = TIMER_ListExpired(list, currTick);
+        if (t == NULL) {
             break;
         }
 
-        MDS_SkipListRemoveNode(t->node, size);
         if ((t->object.flags & MDS_TIMER_TYPE_PERIOD) == 0U) {
             t->object.flags &= ~MDS_TIMER_FLAG_ACTIVED;
         }
-        MDS_ListInsertNodeNext(&runList, &(t->node[size - 1]));
+        MDS_ListInsertNodeNext(&runList, &(t->node[ARRAY_SIZE(t->node) - 1]));
 
         MDS_HOOK_CALL(TIMER_ENTER, t);
 
@@ -109,7 +365,7 @@ static void TIMER_Check(MDS_ListNode_t timerList[], size_t size, bool isSoft)
             continue;
         }
 
-        MDS_ListRemoveNode(&(t->node[size - 1]));
+        MDS_ListRemoveNode(&(t->node[ARRAY_SIZE(t->node) - 1]));
         if ((t->object.flags & (MDS_TIMER_FLAG_ACTIVED | MDS_TIMER_TYPE_PERIOD)) ==
             (MDS_TIMER_FLAG_ACTIVED | MDS_TIMER_TYPE_PERIOD)) {
             MDS_TimerStart(t, t->ticklimit - t->tickstart);
@@ -119,18 +375,25 @@ static void TIMER_Check(MDS_ListNode_t timerList[], size_t size, bool isSoft)
     MDS_CoreInterruptRestore(lock);
 }
 
-static MDS_Timer_t *TIMER_NextTickoutTimer(MDS_ListNode_t timerList[], size_t size)
+static MDS_Tick_t TIMER_NextTick(struct TimerList *list)
 {
-    MDS_Timer_t *timer = NULL;
     register MDS_Item_t lock = MDS_CoreInterruptLock();
 
-    if (!MDS_ListIsEmpty(&(timerList[size - 1]))) {
-        timer = CONTAINER_OF(timerList[size - 1].next, MDS_Timer_t, node[size - 1]);
-    }
+    MDS_Tick_t nextTick = TIMER_ListNextTick(list);
 
     MDS_CoreInterruptRestore(lock);
 
-    return (timer);
+    return (nextTick);
+}
+
+static struct TimerList *TIMER_GetList(const MDS_Timer_t *timer)
+{
+#ifdef MDS_THREAD_TIMER_ENABLE
+    return (((timer->object.flags & MDS_TIMER_TYPE_SYSTEM) == 0U) ? (&g_softTimerList) : (&g_sysTimerList));
+#else
+    UNUSED(timer);
+    return (&g_sysTimerList);
+#endif
 }
 
 #ifdef MDS_THREAD_TIMER_ENABLE
@@ -139,8 +402,7 @@ static __attribute__((noreturn)) void TIMER_ThreadEntry(MDS_Arg_t *arg)
     UNUSED(arg);
 
     MDS_LOOP {
-        MDS_Timer_t *nextTimer = TIMER_NextTickoutTimer(g_softTimerSkipList, ARRAY_SIZE(g_softTimerSkipList));
-        MDS_Tick_t nextTick = (nextTimer != NULL) ? (nextTimer->ticklimit) : (MDS_TICK_FOREVER);
+        MDS_Tick_t nextTick = TIMER_NextTick(&g_softTimerList);
 
         MDS_TIMER_PRINT("soft timer thread take a next check:%u", nextTick);
 
@@ -156,7 +418,7 @@ static __attribute__((noreturn)) void TIMER_ThreadEntry(MDS_Arg_t *arg)
             }
         }
 
-        TIMER_Check(g_softTimerSkipList, ARRAY_SIZE(g_softTimerSkipList), true);
+        TIMER_Check(&g_softTimerList, true);
     }
 }
 #endif
@@ -214,18 +476,12 @@ MDS_Err_t MDS_TimerStart(MDS_Timer_t *timer, MDS_Tick_t timeout)
         return (MDS_EINVAL);
     }
 
-    static size_t skipRand = 0;
-#ifdef MDS_THREAD_TIMER_ENABLE
-    MDS_ListNode_t *timerList = ((timer->object.flags & MDS_TIMER_TYPE_SYSTEM) == 0U) ? (g_softTimerSkipList)
-                                                                                      : (g_sysTimerSkipList);
-#else
-    MDS_ListNode_t *timerList = g_sysTimerSkipList;
-#endif
+    struct TimerList *timerList = TIMER_GetList(timer);
 
     do {
         register MDS_Item_t lock = MDS_CoreInterruptLock();
 
-        MDS_SkipListRemoveNode(timer->node, ARRAY_SIZE(timer->node));
+        TIMER_ListRemove(timerList, timer);
         timer->object.flags &= ~MDS_TIMER_FLAG_ACTIVED;
 
         if (timeout == 0) {
@@ -236,11 +492,7 @@ MDS_Err_t MDS_TimerStart(MDS_Timer_t *timer, MDS_Tick_t timeout)
 
             MDS_HOOK_CALL(TIMER_START, timer);
 
-            MDS_ListNode_t *skipList = MDS_SkipListSearchNode(timerList, ARRAY_SIZE(timer->node), &(timer->ticklimit),
-                                                              TIMER_SkipListCompare);
-
-            skipRand = skipRand + timer->tickstart + 1;
-            MDS_SkipListInsertNode(skipList, timer->node, ARRAY_SIZE(timer->node), skipRand, MDS_TIMER_SKIPLIST_SHIFT);
+            TIMER_ListInsert(timerList, timer);
             timer->object.flags |= MDS_TIMER_FLAG_ACTIVED;
 
 #ifdef MDS_THREAD_TIMER_ENABLE
@@ -273,7 +525,7 @@ MDS_Err_t MDS_TimerStop(MDS_Timer_t *timer)
 
         MDS_HOOK_CALL(TIMER_STOP, timer);
 
-        MDS_SkipListRemoveNode(timer->node, ARRAY_SIZE(timer->node));
+        TIMER_ListRemove(TIMER_GetList(timer), timer);
         timer->object.flags &= ~MDS_TIMER_FLAG_ACTIVED;
 
         MDS_CoreInterruptRestore(lock);
@@ -298,10 +550,10 @@ bool MDS_TimerIsActived(const MDS_Timer_t *timer)
 
 void MDS_SysTimerInit(void)
 {
-    MDS_SkipListInitNode(g_sysTimerSkipList, ARRAY_SIZE(g_sysTimerSkipList));
+    TIMER_ListInit(&g_sysTimerList);
 
 #ifdef MDS_THREAD_TIMER_ENABLE
-    MDS_SkipListInitNode(g_softTimerSkipList, ARRAY_SIZE(g_softTimerSkipList));
+    TIMER_ListInit(&g_softTimerList);
 
     MDS_Err_t err = MDS_ThreadInit(&g_softTimerThread, "timer", TIMER_ThreadEntry, NULL, &g_softTimerStack,
                                    sizeof(g_softTimerStack), MDS_THREAD_TIMER_PRIORITY, MDS_THREAD_TIMER_TICKS);
@@ -313,25 +565,19 @@ void MDS_SysTimerInit(void)
 
 void MDS_SysTimerCheck(void)
 {
-    TIMER_Check(g_sysTimerSkipList, ARRAY_SIZE(g_sysTimerSkipList), false);
+    TIMER_Check(&g_sysTimerList, false);
 }
 
 MDS_Tick_t MDS_SysTimerNextTick(void)
 {
-    MDS_Timer_t *timer = TIMER_NextTickoutTimer(g_sysTimerSkipList, ARRAY_SIZE(g_sysTimerSkipList));
-    if (timer == NULL) {
-        return (MDS_TICK_FOREVER);
-    }
+    MDS_Tick_t nextTick = TIMER_NextTick(&g_sysTimerList);
 
 #if (defined(MDS_DEBUG_TIMER) && (MDS_DEBUG_TIMER > 0))
-    static MDS_Timer_t *last = NULL;
-    if (last != NULL) {
+    if (nextTick != MDS_TICK_FOREVER) {
         MDS_Tick_t currTick = MDS_SysTickGetCount();
-        MDS_TIMER_PRINT("next timer(%p) entry:%p currTick:%u nextTick:%u diffTick:%u", timer, timer->entry, currTick,
-                        timer->ticklimit, timer->ticklimit - currTick);
+        MDS_TIMER_PRINT("next timer currTick:%u nextTick:%u diffTick:%u", currTick, nextTick, nextTick - currTick);
     }
-    last = timer;
 #endif
 
-    return (timer->ticklimit);
+    return (nextTick);
 }
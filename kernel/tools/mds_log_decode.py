@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+# Copyright (c) [2022] [pchom]
+# [MDS] is licensed under Mulan PSL v2.
+# You can use this software according to the terms and conditions of the Mulan PSL v2.
+# You may obtain a copy of Mulan PSL v2 at:
+#          http://license.coscl.org.cn/MulanPSL2
+# THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+# EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+# MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+# See the Mulan PSL v2 for more details.
+"""
+Render a stream of MDS_LOG_Compress_t records (as written by the deferred log
+sink or MDS_LOG_CompressStructVa) into text, resolving the format string
+address against the .logstr.* sections of the firmware ELF.
+
+    $ python3 mds_log_decode.py app.elf log.bin
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+LOG_MAGIC = 0xD6
+LOG_ARG_FIX = 0xBDC5CA39
+LOG_HEADER_SIZE = 16
+LOG_LEVELS = ["OFF", "T", "F", "E", "W", "I", "D", "A"]
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+PRINTF_SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t|L)?([diouxXcspfFeEgGaA%])")
+
+
+class Elf:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+        if data[:4] != b"\x7fELF":
+            raise ValueError("%s is not an ELF file" % path)
+
+        is64 = data[4] == 2
+        self.endian = "<" if data[5] == 1 else ">"
+        if is64:
+            shoff, = struct.unpack_from(self.endian + "Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(self.endian + "HHH", data, 0x3A)
+            shfmt = "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(self.endian + "I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(self.endian + "HHH", data, 0x2E)
+            shfmt = "IIIIIIIIII"
+
+        headers = [struct.unpack_from(self.endian + shfmt, data, shoff + idx * shentsize) for idx in range(shnum)]
+        strtab = headers[shstrndx]
+        strdata = data[strtab[4]:strtab[4] + strtab[5]]
+
+        self.sections = []
+        for name, type, flags, addr, offset, size, *_ in headers:
+            if (flags & SHF_ALLOC) == 0 or type == SHT_NOBITS or size == 0:
+                continue
+            secname = strdata[name:strdata.index(b"\0", name)].decode()
+            self.sections.append((secname, addr & 0xFFFFFFFF, data[offset:offset + size]))
+
+    def string(self, addr, mask=0xFFFFFFFF, prefix=""):
+        for name, base, data in self.sections:
+            if not name.startswith(prefix):
+                continue
+            ofs = (addr - (base & mask)) & mask
+            if ofs < len(data):
+                end = data.find(b"\0", ofs)
+                return data[ofs:end if end >= 0 else len(data)].decode("utf-8", "replace")
+        return None
+
+
+def log_format(elf, fmt, args):
+    args = list(args)
+
+    def convert(match):
+        flags, width, prec, length, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(args.pop(0)) if args else ""
+        if prec == "*":
+            prec = str(args.pop(0)) if args else ""
+        if not args:
+            return match.group(0)
+        val = args.pop(0)
+        spec = "%" + flags + (width or "") + ("." + prec if prec else "")
+        if conv in "di":
+            return (spec + "d") % (val - (1 << 32) if val & 0x80000000 else val)
+        if conv in "ouxX":
+            return (spec + conv) % val
+        if conv == "c":
+            return (spec + "c") % chr(val & 0xFF)
+        if conv == "p":
+            return (spec + "s") % ("0x%08x" % val)
+        if conv == "s":
+            text = elf.string(val)
+            return (spec + "s") % (text if text is not None else "<0x%08x>" % val)
+        return "<%s:0x%08x>" % (conv, val)
+
+    return PRINTF_SPEC.sub(convert, fmt)
+
+
+def log_decode(elf, data, argsMax):
+    pos = 0
+    while pos + LOG_HEADER_SIZE <= len(data):
+        if data[pos] != LOG_MAGIC:
+            pos += 1
+            continue
+
+        word0, word1, stamp = struct.unpack_from(elf.endian + "IIQ", data, pos)
+        address = word0 >> 8
+        level = word1 & 0x0F
+        count = (word1 >> 4) & 0x0F
+        psn = (word1 >> 8) & 0x0FFF
+        stamp &= (1 << 44) - 1
+        length = LOG_HEADER_SIZE + 4 * count
+
+        fmt = elf.string(address, 0x00FFFFFF, ".logstr") if count <= argsMax else None
+        if fmt is None or pos + length > len(data):
+            pos += 1
+            continue
+
+        args = struct.unpack_from(elf.endian + "I" * count, data, pos + LOG_HEADER_SIZE)
+        args = [0xFFFFFFFF if arg == LOG_ARG_FIX else arg for arg in args]
+        yield stamp, level, psn, log_format(elf, fmt, args).rstrip("\n")
+        pos += length
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode MDS compressed log records")
+    parser.add_argument("elf", help="firmware elf with .logstr sections")
+    parser.add_argument("log", nargs="?", help="binary record stream, default stdin")
+    parser.add_argument("--args-max", type=int, default=7, help="MDS_LOG_COMPRESS_ARGS_MAX of the build")
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    if args.log:
+        with open(args.log, "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    for stamp, level, psn, text in log_decode(elf, data, args.args_max):
+        name = LOG_LEVELS[level] if level < len(LOG_LEVELS) else str(level)
+        print("[%d.%03d] %s %03x: %s" % (stamp // 1000, stamp % 1000, name, psn, text))
+
+
+if __name__ == "__main__":
+    main()
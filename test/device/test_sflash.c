@@ -0,0 +1,747 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+#include "drv_sflash.h"
+#include "dev_gpio.h"
+#include <stdlib.h>
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_NOR_PAGE_SIZE 256U
+#define TEST_NOR_SFDP_SIZE 256U
+#define TEST_FUZZ_LEN_MAX  70000U
+
+#define TEST_NOR_WREN  0x06U
+#define TEST_NOR_WRDI  0x04U
+#define TEST_NOR_VWREN 0x50U
+#define TEST_NOR_EN4B  0xB7U
+#define TEST_NOR_RDSR1 0x05U
+#define TEST_NOR_RDSR2 0x35U
+#define TEST_NOR_WRSR1 0x01U
+#define TEST_NOR_WRSR2 0x31U
+#define TEST_NOR_RDID  0x9FU
+#define TEST_NOR_RDSFDP 0x5AU
+#define TEST_NOR_PP    0x02U
+#define TEST_NOR_SE    0x20U
+#define TEST_NOR_BE32  0x52U
+#define TEST_NOR_BE64  0xD8U
+
+/* Typedef ----------------------------------------------------------------- */
+typedef struct TEST_Nor {
+    uint8_t *mem;
+    uint32_t size;
+    uint8_t jedec[3];
+    uint8_t sfdp[TEST_NOR_SFDP_SIZE];
+    uint8_t sr1, sr2;
+    bool wel, addr4, qeInSr1;
+    size_t busy;
+
+    size_t fault;
+    size_t progCmds;
+    size_t eraseCmds[3];
+    size_t polls;
+} TEST_Nor_t;
+
+typedef struct TEST_Case {
+    const char *name;
+    const DEV_STORAGE_Driver_t *driver;  // NULL runs the spi driver
+    uint32_t size;
+    bool sfdp;
+    uint32_t qer;
+    uint8_t readCmd;
+} TEST_Case_t;
+
+/* Variable ---------------------------------------------------------------- */
+static TEST_Nor_t g_testNor;
+static uint8_t *g_testImage = NULL;
+static uint8_t g_testBuff[TEST_FUZZ_LEN_MAX];
+static uint8_t g_testRead[TEST_FUZZ_LEN_MAX];
+static uint32_t g_testRandom = 12345;
+
+static DEV_QSPI_Command_t g_testQspiPend;
+static bool g_testQspiHasPend = false;
+
+static uint8_t g_testSpiFrame[8];
+static size_t g_testSpiPos = 0;
+static uint32_t g_testSpiAddr = 0;
+static uint8_t g_testSpiData[512];
+static size_t g_testSpiDataLen = 0;
+
+static DEV_GPIO_Module_t g_testGpio;
+static DEV_GPIO_Pin_t g_testNss;
+static DEV_QSPI_Adaptr_t g_testQspi;
+static DEV_QSPI_Periph_t g_testQspiPeriph;
+static DEV_SPI_Adaptr_t g_testSpi;
+static DEV_SPI_Periph_t g_testSpiPeriph;
+static DEV_STORAGE_Adaptr_t g_testStorage;
+static DEV_STORAGE_Periph_t g_testPeriph;
+static DRV_SFLASH_QSPIHandle_t g_testQspiHandle;
+static DRV_SFLASH_SPIHandle_t g_testSpiHandle;
+
+static const TEST_Case_t g_testCase[] = {
+    {"qspi sfdp qer=4", &G_DRV_SFLASH_QSPI, 16U << 20, true, 4, 0xEB},
+    {"qspi sfdp qer=5", &G_DRV_SFLASH_QSPI, 8U << 20, true, 5, 0xEB},
+    {"qspi sfdp qer=2", &G_DRV_SFLASH_QSPI, 4U << 20, true, 2, 0xEB},
+    {"qspi sfdp qer=6", &G_DRV_SFLASH_QSPI, 4U << 20, true, 6, 0xEB},
+    {"qspi sfdp qer=3", &G_DRV_SFLASH_QSPI, 4U << 20, true, 3, 0xBB},
+    {"qspi 32MiB 4B addr", &G_DRV_SFLASH_QSPI, 32U << 20, true, 4, 0xEB},
+    {"dspi sfdp", &G_DRV_SFLASH_DSPI, 16U << 20, true, 4, 0xBB},
+    {"qspi no sfdp", &G_DRV_SFLASH_QSPI, 16U << 20, false, 0, 0x0B},
+    {"spi sfdp", NULL, 16U << 20, true, 4, 0x0B},
+    {"spi no sfdp", NULL, 4U << 20, false, 4, 0x0B},
+    {"spi 32MiB 4B addr", NULL, 32U << 20, true, 4, 0x0B},
+};
+
+/* Function ---------------------------------------------------------------- */
+static uint32_t TEST_Random(void)
+{
+    g_testRandom ^= g_testRandom << 13;
+    g_testRandom ^= g_testRandom >> 17;
+    g_testRandom ^= g_testRandom << 5;
+
+    return (g_testRandom);
+}
+
+/* NOR model --------------------------------------------------------------- */
+static void TEST_NorFault(const char *what, uint32_t value)
+{
+    // the driver broke the flash protocol, keep going so the case still ends cleanly
+    if (g_testNor.fault == 0) {
+        MDS_LOG_I("[test] FAIL nor: %s 0x%x", what, (unsigned)value);
+    }
+    g_testNor.fault += 1;
+}
+
+static bool TEST_NorQuadEnabled(void)
+{
+    return ((g_testNor.qeInSr1) ? ((g_testNor.sr1 & 0x40U) != 0) : ((g_testNor.sr2 & 0x02U) != 0));
+}
+
+static uint8_t TEST_NorStatus1(void)
+{
+    uint8_t status = (g_testNor.sr1 & ~0x03U) | ((g_testNor.wel) ? (0x02U) : (0x00U));
+
+    // a program or erase reports busy for a few polls
+    if (g_testNor.busy > 0) {
+        g_testNor.busy -= 1;
+        status |= 0x01U;
+    }
+
+    return (status);
+}
+
+static void TEST_NorSfdpBuild(uint32_t qer, bool addr4)
+{
+    static const uint8_t param[16] = {
+        0x84, 0x00, 0x01, 0x02, 0x40, 0x00, 0x00, 0xFF,  // a vendor table ahead of the basic one
+        0x00, 0x06, 0x01, 0x10, 0x80, 0x00, 0x00, 0xFF,  // basic flash parameter table at 0x80
+    };
+    uint32_t dword[16];
+
+    MDS_MemBuffSet(g_testNor.sfdp, 0xFF, sizeof(g_testNor.sfdp));
+    MDS_MemBuffCopy(g_testNor.sfdp, 4, "SFDP", 4);
+    g_testNor.sfdp[4] = 0x06;
+    g_testNor.sfdp[5] = 0x01;
+    g_testNor.sfdp[6] = 0x01;
+    g_testNor.sfdp[7] = 0xFF;
+    MDS_MemBuffCopy(&(g_testNor.sfdp[8]), sizeof(param), param, sizeof(param));
+
+    MDS_MemBuffSet(dword, 0xFF, sizeof(dword));
+    dword[0] = 0x01U | 0x04U | (0x20U << 8) | (1U << 16) | (((addr4) ? (1U) : (0U)) << 17) | (1U << 20) |
+               (1U << 21) | (1U << 22) | 0xFF800000U;
+    dword[1] = (g_testNor.size * 8U) - 1U;
+    dword[2] = 0x6B08EB44U;
+    dword[3] = 0xBB803B08U;
+    dword[7] = 0x520F200CU;
+    dword[8] = 0x0000D810U;
+    dword[10] = 0x80U;
+    dword[14] = qer << 20;
+    for (size_t idx = 0; idx < ARRAY_SIZE(dword); idx++) {
+        for (size_t ofs = 0; ofs < sizeof(uint32_t); ofs++) {
+            g_testNor.sfdp[0x80 + (idx * sizeof(uint32_t)) + ofs] = (uint8_t)(dword[idx] >> (ofs * 8U));
+        }
+    }
+}
+
+static bool TEST_NorInit(uint32_t size, bool sfdp, uint32_t qer)
+{
+    free(g_testNor.mem);
+    MDS_MemBuffSet(&g_testNor, 0, sizeof(g_testNor));
+
+    g_testNor.mem = malloc(size);
+    if (g_testNor.mem == NULL) {
+        return (false);
+    }
+    MDS_MemBuffSet(g_testNor.mem, 0xFF, size);
+    g_testNor.size = size;
+    g_testNor.jedec[0] = 0xEF;
+    g_testNor.jedec[1] = 0x40;
+    for (uint8_t bits = 16; bits < 32; bits++) {
+        if ((1UL << bits) == size) {
+            g_testNor.jedec[2] = bits;
+        }
+    }
+    g_testNor.qeInSr1 = (qer == 2);
+    if (sfdp) {
+        TEST_NorSfdpBuild(qer, size > (16U << 20));
+    } else {
+        MDS_MemBuffSet(g_testNor.sfdp, 0xFF, sizeof(g_testNor.sfdp));
+    }
+
+    return (true);
+}
+
+static void TEST_NorProgram(uint32_t addr, const uint8_t *data, size_t len)
+{
+    if ((!g_testNor.wel) || (g_testNor.busy > 0) || (len > TEST_NOR_PAGE_SIZE)) {
+        TEST_NorFault("program state", addr);
+        return;
+    }
+    if (((addr % TEST_NOR_PAGE_SIZE) + len) > TEST_NOR_PAGE_SIZE) {
+        TEST_NorFault("program wraps the page", addr);
+    }
+
+    uint32_t base = addr & ~(TEST_NOR_PAGE_SIZE - 1U);
+    for (size_t idx = 0; idx < len; idx++) {
+        g_testNor.mem[(base + ((addr + idx) % TEST_NOR_PAGE_SIZE)) % g_testNor.size] &= data[idx];
+    }
+    g_testNor.wel = false;
+    g_testNor.busy = 2;
+    g_testNor.progCmds += 1;
+}
+
+static void TEST_NorErase(uint8_t inst, uint32_t addr)
+{
+    static const uint8_t eraseInst[] = {TEST_NOR_SE, TEST_NOR_BE32, TEST_NOR_BE64};
+    static const uint32_t eraseSize[] = {4096, 32768, 65536};
+
+    for (size_t idx = 0; idx < ARRAY_SIZE(eraseInst); idx++) {
+        if (inst != eraseInst[idx]) {
+            continue;
+        }
+        if ((!g_testNor.wel) || ((addr % eraseSize[idx]) != 0)) {
+            TEST_NorFault("erase state", addr);
+            return;
+        }
+        MDS_MemBuffSet(&(g_testNor.mem[addr % g_testNor.size]), 0xFF, eraseSize[idx]);
+        g_testNor.wel = false;
+        g_testNor.busy = 5;
+        g_testNor.eraseCmds[idx] += 1;
+        return;
+    }
+
+    TEST_NorFault("erase instruction", inst);
+}
+
+static void TEST_NorSimple(uint8_t inst)
+{
+    if (inst == TEST_NOR_WREN) {
+        g_testNor.wel = true;
+    } else if ((inst == TEST_NOR_WRDI) || (inst == TEST_NOR_VWREN)) {
+        g_testNor.wel = false;
+    } else if (inst == TEST_NOR_EN4B) {
+        g_testNor.addr4 = true;
+    } else {
+        TEST_NorFault("instruction", inst);
+    }
+}
+
+static void TEST_NorWriteStatus(uint8_t inst, const uint8_t *data, size_t len)
+{
+    if (!g_testNor.wel) {
+        TEST_NorFault("write status without wel", inst);
+        return;
+    }
+
+    if (inst == TEST_NOR_WRSR1) {
+        g_testNor.sr1 = data[0] & 0xFCU;
+        if (len > 1) {
+            g_testNor.sr2 = data[1];
+        } else if (!g_testNor.qeInSr1) {
+            // a one byte write clears status register 2 on these parts
+            g_testNor.sr2 = 0;
+        }
+    } else {
+        g_testNor.sr2 = data[0];
+    }
+    g_testNor.wel = false;
+    g_testNor.busy = 1;
+}
+
+/* QSPI adaptr ------------------------------------------------------------- */
+static size_t TEST_QspiLines(DEV_QSPI_CmdLine_t line)
+{
+    static const size_t lines[] = {0, 1, 2, 4};
+
+    return (lines[line]);
+}
+
+static void TEST_QspiCheckAddr(const DEV_QSPI_Command_t *cmd)
+{
+    size_t want = (g_testNor.addr4) ? (4) : (3);
+    size_t got = (cmd->addressSize == DEV_QSPI_CMDSIZE_4B) ? (4) : (3);
+
+    if ((cmd->instruction != TEST_NOR_RDSFDP) && (got != want)) {
+        TEST_NorFault("address size", cmd->instruction);
+    }
+}
+
+static MDS_Err_t TEST_QspiControl(const DEV_QSPI_Adaptr_t *qspi, MDS_Item_t cmd, MDS_Arg_t *arg)
+{
+    UNUSED(qspi);
+    UNUSED(cmd);
+    UNUSED(arg);
+
+    return (MDS_EOK);
+}
+
+static MDS_Err_t TEST_QspiCommand(const DEV_QSPI_Periph_t *periph, const DEV_QSPI_Command_t *cmd,
+                                  const DEV_QSPI_Polling_t *poll)
+{
+    UNUSED(periph);
+
+    if (TEST_QspiLines(cmd->instructionLine) != 1) {
+        TEST_NorFault("instruction line", cmd->instruction);
+    }
+
+    if (poll != NULL) {
+        if (cmd->instruction != TEST_NOR_RDSR1) {
+            TEST_NorFault("poll instruction", cmd->instruction);
+        }
+        g_testNor.polls += 1;
+        for (size_t cnt = 0; cnt < 1000; cnt++) {
+            if ((TEST_NorStatus1() & poll->mask) == poll->match) {
+                return (MDS_EOK);
+            }
+        }
+        return (MDS_ETIME);
+    }
+
+    if (cmd->dataLine != DEV_QSPI_CMDLINE_0) {
+        g_testQspiPend = *cmd;
+        g_testQspiHasPend = true;
+    } else if (cmd->addressLine != DEV_QSPI_CMDLINE_0) {
+        TEST_QspiCheckAddr(cmd);
+        TEST_NorErase(cmd->instruction, cmd->address);
+    } else {
+        TEST_NorSimple(cmd->instruction);
+    }
+
+    return (MDS_EOK);
+}
+
+static MDS_Err_t TEST_QspiTransmit(const DEV_QSPI_Periph_t *periph, const uint8_t *tx, size_t size)
+{
+    UNUSED(periph);
+
+    const DEV_QSPI_Command_t *cmd = &g_testQspiPend;
+    if ((!g_testQspiHasPend) || (cmd->dataSize != size)) {
+        TEST_NorFault("transmit without command", (uint32_t)size);
+        return (MDS_EIO);
+    }
+    g_testQspiHasPend = false;
+
+    if (cmd->instruction == TEST_NOR_PP) {
+        TEST_QspiCheckAddr(cmd);
+        if ((TEST_QspiLines(cmd->addressLine) != 1) || (TEST_QspiLines(cmd->dataLine) != 1)) {
+            TEST_NorFault("program lines", cmd->instruction);
+        }
+        TEST_NorProgram(cmd->address, tx, size);
+    } else if ((cmd->instruction == TEST_NOR_WRSR1) || (cmd->instruction == TEST_NOR_WRSR2)) {
+        TEST_NorWriteStatus(cmd->instruction, tx, size);
+    } else {
+        TEST_NorFault("transmit instruction", cmd->instruction);
+    }
+
+    return (MDS_EOK);
+}
+
+static bool TEST_QspiReadMode(const DEV_QSPI_Command_t *cmd)
+{
+    size_t addrLine = TEST_QspiLines(cmd->addressLine);
+    size_t dataLine = TEST_QspiLines(cmd->dataLine);
+    bool alt = (cmd->alternateLine != DEV_QSPI_CMDLINE_0);
+
+    // the lines, dummy clocks and mode bits each fast read command needs
+    switch (cmd->instruction) {
+        case 0x0B:
+            return ((addrLine == 1) && (dataLine == 1) && (cmd->dummyCycles == 8) && (!alt));
+        case 0x3B:
+            return ((addrLine == 1) && (dataLine == 2) && (cmd->dummyCycles == 8) && (!alt));
+        case 0xBB:
+            return ((addrLine == 2) && (dataLine == 2) && (cmd->dummyCycles == 0) && (alt) &&
+                    (cmd->alternate == 0xFF) && (TEST_QspiLines(cmd->alternateLine) == 2));
+        case 0x6B:
+            return ((addrLine == 1) && (dataLine == 4) && (cmd->dummyCycles == 8) && (!alt) &&
+                    TEST_NorQuadEnabled());
+        case 0xEB:
+            return ((addrLine == 4) && (dataLine == 4) && (cmd->dummyCycles == 4) && (alt) &&
+                    (cmd->alternate == 0xFF) && (cmd->alternateSize == DEV_QSPI_CMDSIZE_1B) &&
+                    TEST_NorQuadEnabled());
+        default:
+            return (false);
+    }
+}
+
+static MDS_Err_t TEST_QspiRecvice(const DEV_QSPI_Periph_t *periph, uint8_t *rx, size_t size)
+{
+    UNUSED(periph);
+
+    const DEV_QSPI_Command_t *cmd = &g_testQspiPend;
+    if ((!g_testQspiHasPend) || (cmd->dataSize != size)) {
+        TEST_NorFault("recvice without command", (uint32_t)size);
+        return (MDS_EIO);
+    }
+    g_testQspiHasPend = false;
+
+    if (cmd->instruction == TEST_NOR_RDID) {
+        MDS_MemBuffCopy(rx, size, g_testNor.jedec, sizeof(g_testNor.jedec));
+    } else if (cmd->instruction == TEST_NOR_RDSR1) {
+        for (size_t idx = 0; idx < size; idx++) {
+            rx[idx] = TEST_NorStatus1();
+        }
+    } else if (cmd->instruction == TEST_NOR_RDSR2) {
+        MDS_MemBuffSet(rx, g_testNor.sr2, size);
+    } else if (cmd->instruction == TEST_NOR_RDSFDP) {
+        if (cmd->dummyCycles != 8) {
+            TEST_NorFault("sfdp dummy clocks", cmd->dummyCycles);
+        }
+        for (size_t idx = 0; idx < size; idx++) {
+            rx[idx] = g_testNor.sfdp[(cmd->address + idx) % TEST_NOR_SFDP_SIZE];
+        }
+    } else {
+        TEST_QspiCheckAddr(cmd);
+        if ((!TEST_QspiReadMode(cmd)) || (g_testNor.busy > 0)) {
+            TEST_NorFault("read command", cmd->instruction);
+        }
+        for (size_t idx = 0; idx < size; idx++) {
+            rx[idx] = g_testNor.mem[(cmd->address + idx) % g_testNor.size];
+        }
+    }
+
+    return (MDS_EOK);
+}
+
+static const DEV_QSPI_Driver_t G_TEST_QSPI = {
+    .control = TEST_QspiControl,
+    .command = TEST_QspiCommand,
+    .transmit = TEST_QspiTransmit,
+    .recvice = TEST_QspiRecvice,
+};
+
+/* SPI adaptr -------------------------------------------------------------- */
+static void TEST_SpiFrameEnd(void)
+{
+    uint8_t inst = g_testSpiFrame[0];
+
+    if (g_testSpiPos == 0) {
+        return;
+    }
+    g_testSpiPos = 0;
+
+    if ((inst == TEST_NOR_WREN) || (inst == TEST_NOR_WRDI) || (inst == TEST_NOR_VWREN) || (inst == TEST_NOR_EN4B)) {
+        TEST_NorSimple(inst);
+    } else if (inst == TEST_NOR_PP) {
+        TEST_NorProgram(g_testSpiAddr, g_testSpiData, g_testSpiDataLen);
+    } else if ((inst == TEST_NOR_SE) || (inst == TEST_NOR_BE32) || (inst == TEST_NOR_BE64)) {
+        TEST_NorErase(inst, g_testSpiAddr);
+    } else if ((inst == TEST_NOR_WRSR1) || (inst == TEST_NOR_WRSR2)) {
+        TEST_NorWriteStatus(inst, g_testSpiData, g_testSpiDataLen);
+    }
+}
+
+static MDS_Err_t TEST_GpioControl(const DEV_GPIO_Module_t *gpio, MDS_Item_t cmd, MDS_Arg_t *arg)
+{
+    UNUSED(gpio);
+    UNUSED(cmd);
+    UNUSED(arg);
+
+    return (MDS_EOK);
+}
+
+static void TEST_GpioWrite(const DEV_GPIO_Pin_t *pin, MDS_Mask_t val)
+{
+    UNUSED(pin);
+
+    // chip select is active low: falling starts a frame, rising ends it
+    if (val == 0) {
+        g_testSpiPos = 0;
+        g_testSpiDataLen = 0;
+    } else {
+        TEST_SpiFrameEnd();
+    }
+}
+
+static const DEV_GPIO_Driver_t G_TEST_GPIO = {
+    .control = TEST_GpioControl,
+    .write = TEST_GpioWrite,
+};
+
+static MDS_Err_t TEST_SpiControl(const DEV_SPI_Adaptr_t *spi, MDS_Item_t cmd, MDS_Arg_t *arg)
+{
+    UNUSED(spi);
+    UNUSED(cmd);
+    UNUSED(arg);
+
+    return (MDS_EOK);
+}
+
+static uint8_t TEST_SpiByte(uint8_t tx)
+{
+    uint8_t inst = g_testSpiFrame[0];
+    size_t addrSize = ((inst == TEST_NOR_RDSFDP) || (!g_testNor.addr4)) ? (3) : (4);
+    size_t dummy = ((inst == 0x0B) || (inst == TEST_NOR_RDSFDP)) ? (1) : (0);
+    bool hasAddr = (inst == 0x03) || (inst == 0x0B) || (inst == TEST_NOR_RDSFDP) || (inst == TEST_NOR_PP) ||
+                   (inst == TEST_NOR_SE) || (inst == TEST_NOR_BE32) || (inst == TEST_NOR_BE64);
+    size_t head = (hasAddr) ? (1 + addrSize + dummy) : (1);
+
+    if (g_testSpiPos < head) {
+        if ((hasAddr) && (g_testSpiPos <= addrSize)) {
+            g_testSpiAddr = (g_testSpiAddr << 8) | tx;
+        }
+        g_testSpiPos += 1;
+        return (0xFF);
+    }
+
+    size_t idx = g_testSpiPos - head;
+    g_testSpiPos += 1;
+    if (inst == TEST_NOR_RDID) {
+        return ((idx < sizeof(g_testNor.jedec)) ? (g_testNor.jedec[idx]) : (0x00));
+    } else if (inst == TEST_NOR_RDSR1) {
+        return (TEST_NorStatus1());
+    } else if (inst == TEST_NOR_RDSR2) {
+        return (g_testNor.sr2);
+    } else if (inst == TEST_NOR_RDSFDP) {
+        return (g_testNor.sfdp[(g_testSpiAddr + idx) % TEST_NOR_SFDP_SIZE]);
+    } else if (inst == 0x0B) {
+        if (g_testNor.busy > 0) {
+            TEST_NorFault("read while busy", g_testSpiAddr);
+        }
+        return (g_testNor.mem[(g_testSpiAddr + idx) % g_testNor.size]);
+    } else if ((inst == TEST_NOR_PP) || (inst == TEST_NOR_WRSR1) || (inst == TEST_NOR_WRSR2)) {
+        if (g_testSpiDataLen < sizeof(g_testSpiData)) {
+            g_testSpiData[g_testSpiDataLen++] = tx;
+        }
+    } else {
+        TEST_NorFault("spi instruction", inst);
+    }
+
+    return (0xFF);
+}
+
+static MDS_Err_t TEST_SpiTransfer(const DEV_SPI_Periph_t *periph, const uint8_t *tx, uint8_t *rx, size_t size)
+{
+    UNUSED(periph);
+
+    for (size_t idx = 0; idx < size; idx++) {
+        uint8_t out = 0xFF;
+        uint8_t in = (tx != NULL) ? (tx[idx]) : (0xFF);
+
+        if (g_testSpiPos == 0) {
+            g_testSpiFrame[0] = in;
+            g_testSpiAddr = 0;
+            g_testSpiPos = 1;
+        } else {
+            out = TEST_SpiByte(in);
+        }
+        if (rx != NULL) {
+            rx[idx] = out;
+        }
+    }
+
+    return (MDS_EOK);
+}
+
+static const DEV_SPI_Driver_t G_TEST_SPI = {
+    .control = TEST_SpiControl,
+    .transfer = TEST_SpiTransfer,
+};
+
+/* Test -------------------------------------------------------------------- */
+static size_t TEST_ProgramPages(size_t addr, const uint8_t *buff, size_t len)
+{
+    size_t pages = 0;
+
+    // pages that stay erased are skipped by the driver
+    for (size_t ofs = 0; ofs < len;) {
+        size_t size = TEST_NOR_PAGE_SIZE - ((addr + ofs) % TEST_NOR_PAGE_SIZE);
+        size = (size > (len - ofs)) ? (len - ofs) : (size);
+        for (size_t idx = 0; idx < size; idx++) {
+            if (buff[ofs + idx] != 0xFF) {
+                pages += 1;
+                break;
+            }
+        }
+        ofs += size;
+    }
+
+    return (pages);
+}
+
+static void TEST_Fuzz(const char *name, size_t rounds)
+{
+    size_t blockSize = DEV_STORAGE_PeriphBlockSize(&g_testPeriph, 0);
+    size_t baseSize = blockSize * g_testPeriph.object.blockBase;
+    size_t totalSize = blockSize * DEV_STORAGE_PeriphBlockNums(&g_testPeriph);
+    size_t mismatch = 0;
+    size_t pages = 0;
+
+    MDS_MemBuffCopy(g_testImage, g_testNor.size, g_testNor.mem, g_testNor.size);
+    for (size_t round = 0; (round < rounds) && (mismatch == 0); round++) {
+        uint32_t op = TEST_Random() % 10;
+
+        if (op < 4) {
+            size_t len = (TEST_Random() % 3000) + 1;
+            size_t addr = TEST_Random() % (totalSize - len);
+            for (size_t idx = 0; idx < len; idx++) {
+                g_testBuff[idx] = ((TEST_Random() % 5) == 0) ? (0xFF) : ((uint8_t)TEST_Random());
+            }
+            size_t before = g_testNor.progCmds;
+            MDS_Err_t err = DEV_STORAGE_PeriphProgram(&g_testPeriph, addr / blockSize, addr % blockSize, g_testBuff,
+                                                      len);
+            size_t expect = TEST_ProgramPages(baseSize + addr, g_testBuff, len);
+            mismatch += ((err != MDS_EOK) || ((g_testNor.progCmds - before) != expect)) ? (1) : (0);
+            pages += expect;
+            for (size_t idx = 0; idx < len; idx++) {
+                g_testImage[baseSize + addr + idx] &= g_testBuff[idx];
+            }
+        } else if (op < 5) {
+            size_t nums = ((TEST_Random() % 3) == 0) ? ((TEST_Random() % 40) + 1) : ((TEST_Random() % 3) + 1);
+            size_t block = TEST_Random() % ((totalSize / blockSize) - nums + 1);
+            mismatch += (DEV_STORAGE_PeriphErase(&g_testPeriph, block, nums) != MDS_EOK) ? (1) : (0);
+            MDS_MemBuffSet(&(g_testImage[baseSize + (block * blockSize)]), 0xFF, nums * blockSize);
+        } else {
+            size_t len = (TEST_Random() % sizeof(g_testRead)) + 1;
+            size_t addr = TEST_Random() % (totalSize - len + 1);
+            MDS_Err_t err = DEV_STORAGE_PeriphRead(&g_testPeriph, addr / blockSize, addr % blockSize, g_testRead,
+                                                   len);
+            mismatch += ((err != MDS_EOK) || (MDS_MemBuffCmp(g_testRead, &(g_testImage[baseSize + addr]), len) != 0))
+                            ? (1)
+                            : (0);
+        }
+    }
+
+    MDS_LOG_I("[test] sflash %s pages:%u erase 4k:%u 32k:%u 64k:%u polls:%u", name, (unsigned)pages,
+              (unsigned)g_testNor.eraseCmds[0], (unsigned)g_testNor.eraseCmds[1], (unsigned)g_testNor.eraseCmds[2],
+              (unsigned)g_testNor.polls);
+    MDS_TEST_CHECK(mismatch == 0);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(g_testNor.mem, g_testImage, g_testNor.size) == 0);
+}
+
+static const DRV_SFLASH_Info_t *TEST_Attach(const TEST_Case_t *tc)
+{
+    MDS_Err_t err;
+
+    MDS_MemBuffSet(&g_testStorage, 0, sizeof(g_testStorage));
+    MDS_MemBuffSet(&g_testPeriph, 0, sizeof(g_testPeriph));
+    if (tc->driver != NULL) {
+        MDS_MemBuffSet(&g_testQspiHandle, 0, sizeof(g_testQspiHandle));
+        err = DEV_QSPI_AdaptrInit(&g_testQspi, "qspi", &G_TEST_QSPI, NULL, NULL);
+        if (err == MDS_EOK) {
+            err = DEV_QSPI_PeriphInit(&g_testQspiPeriph, "qflash", &g_testQspi);
+        }
+        g_testQspiHandle.periph = &g_testQspiPeriph;
+        g_testQspiHandle.timeout = 100;
+        if (err == MDS_EOK) {
+            err = DEV_STORAGE_AdaptrInit(&g_testStorage, "sflash", tc->driver, (MDS_DevHandle_t *)&g_testQspiHandle,
+                                         NULL);
+        }
+    } else {
+        MDS_MemBuffSet(&g_testSpiHandle, 0, sizeof(g_testSpiHandle));
+        err = DEV_SPI_AdaptrInit(&g_testSpi, "spi", &G_TEST_SPI, NULL, NULL);
+        if (err == MDS_EOK) {
+            err = DEV_SPI_PeriphInit(&g_testSpiPeriph, "sflash", &g_testSpi);
+        }
+        g_testSpiPeriph.object.nss = &g_testNss;
+        g_testSpiPeriph.object.busCS = DEV_SPI_BUSCS_LOW;
+        g_testSpiHandle.periph = &g_testSpiPeriph;
+        g_testSpiHandle.timeout = 100;
+        if (err == MDS_EOK) {
+            err = DEV_STORAGE_AdaptrInit(&g_testStorage, "sflash", &G_DRV_SFLASH_SPI,
+                                         (MDS_DevHandle_t *)&g_testSpiHandle, NULL);
+        }
+    }
+    if (err == MDS_EOK) {
+        err = DEV_STORAGE_PeriphInit(&g_testPeriph, "part", &g_testStorage);
+    }
+
+    return ((MDS_TEST_CHECK(err == MDS_EOK))
+                ? ((tc->driver != NULL) ? (&(g_testQspiHandle.info)) : (&(g_testSpiHandle.info)))
+                : (NULL));
+}
+
+static void TEST_Detach(const TEST_Case_t *tc)
+{
+    DEV_STORAGE_PeriphDeInit(&g_testPeriph);
+    DEV_STORAGE_AdaptrDeInit(&g_testStorage);
+    if (tc->driver != NULL) {
+        DEV_QSPI_PeriphDeInit(&g_testQspiPeriph);
+        DEV_QSPI_AdaptrDeInit(&g_testQspi);
+    } else {
+        DEV_SPI_PeriphDeInit(&g_testSpiPeriph);
+        DEV_SPI_AdaptrDeInit(&g_testSpi);
+    }
+}
+
+static void TEST_Case(const TEST_Case_t *tc)
+{
+    if (!MDS_TEST_CHECK(TEST_NorInit(tc->size, tc->sfdp, tc->qer))) {
+        return;
+    }
+
+    const DRV_SFLASH_Info_t *info = TEST_Attach(tc);
+    if (info == NULL) {
+        return;
+    }
+    MDS_LOG_I("[test] sflash %s size:%u page:%u sector:%u block:%u addr:%u read:%02x", tc->name,
+              (unsigned)info->totalSize, (unsigned)info->pageSize, (unsigned)info->sectorSize,
+              (unsigned)info->blockSize, (unsigned)info->addrSize, (unsigned)info->readCmd);
+    MDS_TEST_CHECK(info->totalSize == tc->size);
+    MDS_TEST_CHECK(info->readCmd == tc->readCmd);
+
+    // an unpartitioned periph or one past the end of the flash is refused
+    size_t blockNums = info->totalSize / info->sectorSize;
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, 100) == MDS_EINVAL);
+    g_testPeriph.object.blockBase = 1;
+    g_testPeriph.object.blockNums = blockNums;
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, 100) == MDS_EINVAL);
+
+    // a partition away from the start of the flash, with room behind it
+    g_testPeriph.object.blockBase = 16;
+    g_testPeriph.object.blockNums = blockNums - 32;
+    if (MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, 100) == MDS_EOK)) {
+        TEST_Fuzz(tc->name, 3000);
+        DEV_STORAGE_PeriphClose(&g_testPeriph);
+    }
+    MDS_TEST_CHECK(g_testNor.fault == 0);
+
+    TEST_Detach(tc);
+}
+
+void MDS_TEST_Main(void)
+{
+    g_testImage = malloc(32U << 20);
+    MDS_Err_t err = DEV_GPIO_ModuleInit(&g_testGpio, "gpio", &G_TEST_GPIO, NULL, NULL);
+    if (err == MDS_EOK) {
+        err = DEV_GPIO_PinInit(&g_testNss, "nss", &g_testGpio);
+    }
+    if ((!MDS_TEST_CHECK(g_testImage != NULL)) || (!MDS_TEST_CHECK(err == MDS_EOK))) {
+        return;
+    }
+
+    for (size_t idx = 0; idx < ARRAY_SIZE(g_testCase); idx++) {
+        TEST_Case(&(g_testCase[idx]));
+    }
+
+    free(g_testNor.mem);
+    free(g_testImage);
+}
@@ -0,0 +1,463 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+#include "drv_storage_simulate.h"
+#include "emfs.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_CACHE_BLOCK_SIZE 4096
+#define TEST_CACHE_BLOCK_NUMS 32
+#define TEST_CACHE_LINE_SIZE  256
+#define TEST_CACHE_LINE_NUMS  8
+#define TEST_CACHE_FUZZ_NUMS  50000
+#define TEST_CACHE_SLOT_SIZE  1024
+#define TEST_CACHE_SLOT_NUMS  6
+#define TEST_CACHE_LOG_BLOCK  2
+#define TEST_CACHE_HEAD_SIZE  8
+#define TEST_CACHE_HEAD_ROUND 200
+
+/* Variable ---------------------------------------------------------------- */
+static uint8_t g_testFlash[TEST_CACHE_BLOCK_SIZE * TEST_CACHE_BLOCK_NUMS];
+static uint8_t g_testImage[TEST_CACHE_BLOCK_SIZE * TEST_CACHE_BLOCK_NUMS];
+static uint8_t g_testLineBuff[TEST_CACHE_LINE_SIZE * TEST_CACHE_LINE_NUMS];
+static uint8_t g_testPage[TEST_CACHE_BLOCK_SIZE];
+static DRV_STORAGE_SimulateHandle_t g_testSimulate = {
+    .buff = g_testFlash,
+    .blockSize = TEST_CACHE_BLOCK_SIZE,
+    .blockNums = TEST_CACHE_BLOCK_NUMS,
+};
+static DEV_STORAGE_Adaptr_t g_testAdaptr;
+static DEV_STORAGE_Periph_t g_testPeriph;
+static DEV_STORAGE_Cache_t g_testCache;
+static DEV_STORAGE_CacheLine_t g_testLine[TEST_CACHE_LINE_NUMS];
+static uint32_t g_testRandom = 1;
+
+// second view of the same image through a driver that counts geometry queries
+static DRV_STORAGE_SimulateHandle_t g_testGeoSimulate = {
+    .buff = g_testFlash,
+    .blockSize = TEST_CACHE_BLOCK_SIZE,
+    .blockNums = TEST_CACHE_BLOCK_NUMS,
+};
+static DEV_STORAGE_Driver_t g_testGeoDriver;
+static DEV_STORAGE_Adaptr_t g_testGeoAdaptr;
+static DEV_STORAGE_Periph_t g_testGeoPeriph;
+static size_t g_testGeoQuery = 0;
+
+/* Function ---------------------------------------------------------------- */
+static uint32_t TEST_Random(void)
+{
+    g_testRandom ^= g_testRandom << 13;
+    g_testRandom ^= g_testRandom >> 17;
+    g_testRandom ^= g_testRandom << 5;
+
+    return (g_testRandom);
+}
+
+static void TEST_CacheClose(void)
+{
+    uint8_t data[8] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08};
+
+    // a partial program stays in the write-back line until the periph is closed
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, MDS_TICK_FOREVER) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphErase(&g_testPeriph, 0, 1) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphProgram(&g_testPeriph, 0, 16, data, sizeof(data)) == MDS_EOK);
+    MDS_TEST_CHECK(g_testCache.dirty != NULL);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphClose(&g_testPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(g_testCache.dirty == NULL);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(&g_testFlash[16], data, sizeof(data)) == 0);
+}
+
+static void TEST_CacheReadThrough(void)
+{
+    uint8_t data[8] = {0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18};
+    uint8_t read[sizeof(data)];
+
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, MDS_TICK_FOREVER) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphProgram(&g_testPeriph, 0, 64, data, sizeof(data)) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphReadThrough(&g_testPeriph, 0, 64, read, sizeof(read)) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(read, data, sizeof(data)) == 0);
+    MDS_TEST_CHECK(g_testCache.dirty == NULL);
+
+    // cells that did not take the program are only visible to a read of the device
+    g_testFlash[64] = 0x00;
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphRead(&g_testPeriph, 0, 64, read, sizeof(read)) == MDS_EOK);
+    MDS_TEST_CHECK(read[0] == data[0]);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphReadThrough(&g_testPeriph, 0, 64, read, sizeof(read)) == MDS_EOK);
+    MDS_TEST_CHECK(read[0] == 0x00);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphClose(&g_testPeriph) == MDS_EOK);
+}
+
+static void TEST_CacheFuzz(void)
+{
+    uint8_t data[TEST_CACHE_BLOCK_SIZE * 2];
+    size_t idx = 0;
+
+    // random reads, programs into erased space and erases against a reference image
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, MDS_TICK_FOREVER) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphErase(&g_testPeriph, 0, TEST_CACHE_BLOCK_NUMS) == MDS_EOK);
+    MDS_MemBuffSet(g_testImage, 0xFF, sizeof(g_testImage));
+    for (; idx < TEST_CACHE_FUZZ_NUMS; idx++) {
+        size_t block = TEST_Random() % TEST_CACHE_BLOCK_NUMS;
+        size_t ofs = TEST_Random() % TEST_CACHE_BLOCK_SIZE;
+        size_t len = ((TEST_Random() % 4) == 0) ? (1 + (TEST_Random() % sizeof(data))) : (1 + (TEST_Random() % 64));
+        uint8_t *image = &g_testImage[(block * TEST_CACHE_BLOCK_SIZE) + ofs];
+        uint32_t op = TEST_Random() % 100;
+        MDS_Err_t err = MDS_EOK;
+
+        if ((image + len) > (g_testImage + sizeof(g_testImage))) {
+            len = (g_testImage + sizeof(g_testImage)) - image;
+        }
+        if (op < 50) {
+            err = DEV_STORAGE_PeriphRead(&g_testPeriph, block, ofs, data, len);
+            if ((err == MDS_EOK) && (MDS_MemBuffCmp(data, image, len) != 0)) {
+                err = MDS_EIO;
+            }
+        } else if (op < 97) {
+            size_t cnt = 0;
+            while ((cnt < len) && (image[cnt] == 0xFF)) {
+                cnt++;
+            }
+            if (cnt == len) {
+                for (cnt = 0; cnt < len; cnt++) {
+                    data[cnt] = (uint8_t)TEST_Random();
+                    image[cnt] &= data[cnt];
+                }
+                err = DEV_STORAGE_PeriphProgram(&g_testPeriph, block, ofs, data, len);
+            }
+        } else if (op < 99) {
+            MDS_MemBuffSet(&g_testImage[block * TEST_CACHE_BLOCK_SIZE], 0xFF, TEST_CACHE_BLOCK_SIZE);
+            err = DEV_STORAGE_PeriphErase(&g_testPeriph, block, 1);
+        } else {
+            err = DEV_STORAGE_PeriphSync(&g_testPeriph);
+            if ((err == MDS_EOK) && (MDS_MemBuffCmp(g_testFlash, g_testImage, sizeof(g_testImage)) != 0)) {
+                err = MDS_EIO;
+            }
+        }
+        if (err != MDS_EOK) {
+            break;
+        }
+    }
+    MDS_TEST_CHECK(idx == TEST_CACHE_FUZZ_NUMS);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphClose(&g_testPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(g_testFlash, g_testImage, sizeof(g_testImage)) == 0);
+    MDS_LOG_I("[test] cache hit:%u miss:%u flush:%u", (unsigned)(g_testCache.hitCount),
+              (unsigned)(g_testCache.missCount), (unsigned)(g_testCache.flushCount));
+}
+
+static void TEST_CacheEmfs(void)
+{
+    MDS_EMFS_FsInitStruct_t init = {
+        .device = &g_testPeriph,
+        .buff = g_testPage,
+        .size = sizeof(g_testPage),
+    };
+    MDS_EMFS_FileSystem_t fs;
+    MDS_EMFS_FileDesc_t fd;
+    uint8_t data[sizeof(uint32_t)];
+    size_t cnt = 0;
+
+    // every emfs barrier leaves the device image complete without the cache
+    MDS_TEST_CHECK(MDS_EMFS_Mkfs(&g_testPeriph, TEST_CACHE_BLOCK_SIZE) == MDS_EOK);
+    MDS_MemBuffSet(&fs, 0, sizeof(fs));
+    MDS_TEST_CHECK(MDS_EMFS_Mount(&fs, &init) == MDS_EOK);
+    for (uint32_t idx = 0; idx < 200; idx++) {
+        MDS_Err_t err = MDS_EMFS_FileOpen(&fd, &fs, 1 + (idx % 4));
+        if (err == MDS_ENOENT) {
+            err = MDS_EMFS_FileCreate(&fd, &fs, 1 + (idx % 4));
+        }
+        MDS_PutU32BE(data, idx);
+        if (err == MDS_EOK) {
+            err = MDS_EMFS_FileWrite(&fd, 0, data, sizeof(data), &cnt);
+            MDS_EMFS_FileClose(&fd);
+        }
+        if (!MDS_TEST_CHECK((err == MDS_EOK) && (g_testCache.dirty == NULL))) {
+            break;
+        }
+    }
+    MDS_TEST_CHECK(MDS_EMFS_Unmout(&fs) == MDS_EOK);
+
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphCache(&g_testPeriph, NULL) == MDS_EOK);
+    MDS_MemBuffSet(&fs, 0, sizeof(fs));
+    MDS_TEST_CHECK(MDS_EMFS_Mount(&fs, &init) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_EMFS_FileOpen(&fd, &fs, 4) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_EMFS_FileRead(&fd, 0, data, sizeof(data), &cnt) == MDS_EOK);
+    MDS_TEST_CHECK((cnt == sizeof(data)) && (MDS_GetU32BE(data) == 199));
+    MDS_TEST_CHECK(MDS_EMFS_FileClose(&fd) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_EMFS_Unmout(&fs) == MDS_EOK);
+}
+
+static void TEST_CacheVector(void)
+{
+    uint8_t data[64];
+    uint8_t read[64];
+
+    for (size_t idx = 0; idx < sizeof(data); idx++) {
+        data[idx] = (uint8_t)TEST_Random();
+    }
+
+    // ranges adjacent on the device and in memory go out as one driver call
+    DEV_STORAGE_Vector_t prog[] = {
+        {.block = 0, .ofs = 0, .buff = &data[0], .len = 16},
+        {.block = 0, .ofs = 16, .buff = &data[16], .len = 16},
+        {.block = 0, .ofs = 64, .buff = &data[32], .len = 16},
+        {.block = 1, .ofs = 0, .buff = &data[48], .len = 16},
+    };
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, MDS_TICK_FOREVER) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphErase(&g_testPeriph, 0, 2) == MDS_EOK);
+    MDS_MemBuffSet(&(g_testSimulate.stats), 0, sizeof(g_testSimulate.stats));
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphProgramv(&g_testPeriph, prog, ARRAY_SIZE(prog)) == MDS_EOK);
+    MDS_TEST_CHECK(g_testSimulate.stats.progCount == 3);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(&g_testFlash[0], &data[0], 32) == 0);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(&g_testFlash[64], &data[32], 16) == 0);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(&g_testFlash[TEST_CACHE_BLOCK_SIZE], &data[48], 16) == 0);
+
+    // adjacent on the device only is not merged, the gap in memory is left alone
+    DEV_STORAGE_Vector_t vec[] = {
+        {.block = 0, .ofs = 0, .buff = &read[0], .len = 16},
+        {.block = 0, .ofs = 16, .buff = &read[16], .len = 16},
+        {.block = 0, .ofs = 32, .buff = &read[40], .len = 8},
+        {.block = 1, .ofs = 0, .buff = &read[48], .len = 16},
+    };
+    MDS_MemBuffSet(read, 0x5A, sizeof(read));
+    MDS_MemBuffSet(&(g_testSimulate.stats), 0, sizeof(g_testSimulate.stats));
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphReadv(&g_testPeriph, vec, ARRAY_SIZE(vec)) == MDS_EOK);
+    MDS_TEST_CHECK(g_testSimulate.stats.readCount == 3);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(&read[0], &data[0], 32) == 0);
+    MDS_TEST_CHECK((read[32] == 0x5A) && (read[39] == 0x5A) && (read[40] == 0xFF) && (read[47] == 0xFF));
+    MDS_TEST_CHECK(MDS_MemBuffCmp(&read[48], &data[48], 16) == 0);
+
+    // the cached path sees the same data
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphClose(&g_testPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_CacheInit(&g_testCache, g_testLine, TEST_CACHE_LINE_NUMS, g_testLineBuff,
+                                         TEST_CACHE_LINE_SIZE, true) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphCache(&g_testPeriph, &g_testCache) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, MDS_TICK_FOREVER) == MDS_EOK);
+    MDS_MemBuffSet(read, 0x5A, sizeof(read));
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphReadv(&g_testPeriph, vec, ARRAY_SIZE(vec)) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(&read[0], &data[0], 32) == 0);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(&read[48], &data[48], 16) == 0);
+
+    vec[0].block = TEST_CACHE_BLOCK_NUMS;
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphReadv(&g_testPeriph, vec, 1) == MDS_EINVAL);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphClose(&g_testPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphCache(&g_testPeriph, NULL) == MDS_EOK);
+}
+
+static size_t TEST_GeoBlockSize(const DEV_STORAGE_Adaptr_t *storage, size_t blk)
+{
+    g_testGeoQuery += 1;
+
+    return (G_DRV_STORAGE_SIMULATE.blksize(storage, blk));
+}
+
+static void TEST_CacheGeometry(void)
+{
+    uint8_t data[16];
+
+    g_testGeoDriver = G_DRV_STORAGE_SIMULATE;
+    g_testGeoDriver.blksize = TEST_GeoBlockSize;
+    MDS_Err_t err = DEV_STORAGE_AdaptrInit(&g_testGeoAdaptr, "geo", &g_testGeoDriver,
+                                           (MDS_DevHandle_t *)(&g_testGeoSimulate), NULL);
+    if (err == MDS_EOK) {
+        err = DEV_STORAGE_PeriphInit(&g_testGeoPeriph, "geo", &g_testGeoAdaptr);
+        g_testGeoPeriph.object.blockNums = TEST_CACHE_BLOCK_NUMS;
+    }
+    if (!MDS_TEST_CHECK(err == MDS_EOK)) {
+        return;
+    }
+
+    // the driver is asked once per block, every access after that runs on the cached geometry
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testGeoPeriph, MDS_TICK_FOREVER) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphTotalSize(&g_testGeoPeriph) == (TEST_CACHE_BLOCK_SIZE * TEST_CACHE_BLOCK_NUMS));
+    size_t query = g_testGeoQuery;
+    MDS_TEST_CHECK(query <= TEST_CACHE_BLOCK_NUMS);
+    for (size_t idx = 0; idx < 100; idx++) {
+        MDS_TEST_CHECK(DEV_STORAGE_PeriphRead(&g_testGeoPeriph, idx % TEST_CACHE_BLOCK_NUMS, 0, data,
+                                              sizeof(data)) == MDS_EOK);
+    }
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphErase(&g_testGeoPeriph, 2, 1) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphProgram(&g_testGeoPeriph, 2, 0, data, sizeof(data)) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphBlockSize(&g_testGeoPeriph, 3) == TEST_CACHE_BLOCK_SIZE);
+    MDS_TEST_CHECK(g_testGeoQuery == query);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphClose(&g_testGeoPeriph) == MDS_EOK);
+
+    // a smaller media stays unseen until the change is reported
+    g_testGeoPeriph.object.blockNums = TEST_CACHE_BLOCK_NUMS / 2;
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphTotalSize(&g_testGeoPeriph) == (TEST_CACHE_BLOCK_SIZE * TEST_CACHE_BLOCK_NUMS));
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphMediaChanged(&g_testGeoPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphTotalSize(&g_testGeoPeriph) ==
+                   (TEST_CACHE_BLOCK_SIZE * TEST_CACHE_BLOCK_NUMS / 2));
+    MDS_TEST_CHECK(g_testGeoQuery == (query + (TEST_CACHE_BLOCK_NUMS / 2)));
+    g_testGeoPeriph.object.blockNums = 0;
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphMediaChanged(&g_testGeoPeriph) == MDS_ENODEV);
+
+    DEV_STORAGE_PeriphDeInit(&g_testGeoPeriph);
+    DEV_STORAGE_AdaptrDeInit(&g_testGeoAdaptr);
+}
+
+static void TEST_CacheMediaChanged(void)
+{
+    uint8_t data[8] = {0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28};
+    uint8_t read[sizeof(data)];
+
+    MDS_TEST_CHECK(DEV_STORAGE_CacheInit(&g_testCache, g_testLine, TEST_CACHE_LINE_NUMS, g_testLineBuff,
+                                         TEST_CACHE_LINE_SIZE, true) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphCache(&g_testPeriph, &g_testCache) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, MDS_TICK_FOREVER) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphErase(&g_testPeriph, 0, 1) == MDS_EOK);
+
+    // lines of the old media are dropped, a swapped image is read from the device again
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphRead(&g_testPeriph, 0, 0, read, sizeof(read)) == MDS_EOK);
+    MDS_MemBuffCopy(g_testFlash, sizeof(data), data, sizeof(data));
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphRead(&g_testPeriph, 0, 0, read, sizeof(read)) == MDS_EOK);
+    MDS_TEST_CHECK(read[0] == 0xFF);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphMediaChanged(&g_testPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphRead(&g_testPeriph, 0, 0, read, sizeof(read)) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(read, data, sizeof(data)) == 0);
+
+    // pending write-back data belonged to the old media and never reaches the new one
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphProgram(&g_testPeriph, 0, 64, data, sizeof(data)) == MDS_EOK);
+    MDS_TEST_CHECK(g_testCache.dirty != NULL);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphMediaChanged(&g_testPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(g_testCache.dirty == NULL);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphClose(&g_testPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(g_testFlash[64] == 0xFF);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphCache(&g_testPeriph, NULL) == MDS_EOK);
+}
+
+static bool TEST_CacheHeaderRound(size_t round)
+{
+    uint8_t head[TEST_CACHE_HEAD_SIZE];
+    uint8_t page[TEST_CACHE_SLOT_SIZE];
+    uint8_t record[16];
+    size_t slot = round % TEST_CACHE_SLOT_NUMS;
+    size_t ofs = (TEST_CACHE_LOG_BLOCK * TEST_CACHE_BLOCK_SIZE) + (round * sizeof(record));
+
+    // a header scan over every slot, one full page read of the candidate and a small record appended to a log
+    for (size_t idx = 0; idx < TEST_CACHE_SLOT_NUMS; idx++) {
+        if ((DEV_STORAGE_PeriphRead(&g_testPeriph, 0, idx * TEST_CACHE_SLOT_SIZE, head, sizeof(head)) != MDS_EOK) ||
+            (MDS_MemBuffCmp(head, &g_testImage[idx * TEST_CACHE_SLOT_SIZE], sizeof(head)) != 0)) {
+            return (false);
+        }
+    }
+    if ((DEV_STORAGE_PeriphRead(&g_testPeriph, 0, slot * TEST_CACHE_SLOT_SIZE, page, sizeof(page)) != MDS_EOK) ||
+        (MDS_MemBuffCmp(page, &g_testImage[slot * TEST_CACHE_SLOT_SIZE], sizeof(page)) != 0)) {
+        return (false);
+    }
+
+    MDS_MemBuffSet(record, (uint8_t)round, sizeof(record));
+    MDS_MemBuffCopy(&g_testImage[ofs], sizeof(record), record, sizeof(record));
+
+    return (DEV_STORAGE_PeriphProgram(&g_testPeriph, TEST_CACHE_LOG_BLOCK, round * sizeof(record), record,
+                                      sizeof(record)) == MDS_EOK);
+}
+
+static void TEST_CacheHeaders(const char *name, DEV_STORAGE_Cache_t *cache)
+{
+    size_t round = 0;
+
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphCache(&g_testPeriph, cache) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphOpen(&g_testPeriph, MDS_TICK_FOREVER) == MDS_EOK);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphErase(&g_testPeriph, 0, TEST_CACHE_BLOCK_NUMS) == MDS_EOK);
+    MDS_MemBuffSet(g_testImage, 0xFF, sizeof(g_testImage));
+    for (size_t idx = 0; idx < TEST_CACHE_SLOT_NUMS; idx++) {
+        uint8_t *head = &g_testImage[idx * TEST_CACHE_SLOT_SIZE];
+        MDS_MemBuffSet(head, (uint8_t)idx, TEST_CACHE_HEAD_SIZE);
+        MDS_TEST_CHECK(DEV_STORAGE_PeriphProgram(&g_testPeriph, 0, idx * TEST_CACHE_SLOT_SIZE, head,
+                                                 TEST_CACHE_HEAD_SIZE) == MDS_EOK);
+    }
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphSync(&g_testPeriph) == MDS_EOK);
+
+    if (cache != NULL) {
+        cache->hitCount = 0;
+        cache->missCount = 0;
+        cache->flushCount = 0;
+    }
+    MDS_MemBuffSet(&(g_testSimulate.stats), 0, sizeof(g_testSimulate.stats));
+    for (; round < TEST_CACHE_HEAD_ROUND; round++) {
+        if (!TEST_CacheHeaderRound(round)) {
+            break;
+        }
+    }
+    MDS_TEST_CHECK(round == TEST_CACHE_HEAD_ROUND);
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphClose(&g_testPeriph) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MemBuffCmp(g_testFlash, g_testImage, sizeof(g_testImage)) == 0);
+
+    size_t hit = (cache != NULL) ? (cache->hitCount) : (0);
+    size_t access = (cache != NULL) ? (cache->hitCount + cache->missCount) : (0);
+    MDS_LOG_I("[test] cache headers %s hit:%u%% reads:%u programs:%u busy:%uus", name,
+              (unsigned)((access != 0) ? ((hit * 100) / access) : (0)), (unsigned)(g_testSimulate.stats.readCount),
+              (unsigned)(g_testSimulate.stats.progCount), (unsigned)(g_testSimulate.stats.busyNs / 1000));
+}
+
+static void TEST_CacheHeaderBench(void)
+{
+    DRV_STORAGE_SimulateStats_t stats[3];
+
+    // roughly a 20MB/s serial NOR with a fixed cost per command
+    g_testSimulate.readNs = 2000;
+    g_testSimulate.readByteNs = 50;
+    g_testSimulate.progNs = 10000;
+    g_testSimulate.progByteNs = 100;
+
+    TEST_CacheHeaders("none", NULL);
+    stats[0] = g_testSimulate.stats;
+    MDS_TEST_CHECK(DEV_STORAGE_CacheInit(&g_testCache, g_testLine, TEST_CACHE_LINE_NUMS, g_testLineBuff,
+                                         TEST_CACHE_LINE_SIZE, false) == MDS_EOK);
+    TEST_CacheHeaders("write-through", &g_testCache);
+    stats[1] = g_testSimulate.stats;
+    MDS_TEST_CHECK(DEV_STORAGE_CacheInit(&g_testCache, g_testLine, TEST_CACHE_LINE_NUMS, g_testLineBuff,
+                                         TEST_CACHE_LINE_SIZE, true) == MDS_EOK);
+    TEST_CacheHeaders("write-back", &g_testCache);
+    stats[2] = g_testSimulate.stats;
+    MDS_TEST_CHECK(DEV_STORAGE_PeriphCache(&g_testPeriph, NULL) == MDS_EOK);
+
+    // header lines stay cached in both modes, only write-back merges the log records
+    MDS_TEST_CHECK((stats[1].readCount < stats[0].readCount) && (stats[2].readCount < stats[0].readCount));
+    MDS_TEST_CHECK((stats[1].busyNs < stats[0].busyNs) && (stats[2].busyNs < stats[1].busyNs));
+    MDS_TEST_CHECK(stats[2].progCount < stats[1].progCount);
+
+    g_testSimulate.readNs = 0;
+    g_testSimulate.readByteNs = 0;
+    g_testSimulate.progNs = 0;
+    g_testSimulate.progByteNs = 0;
+}
+
+void MDS_TEST_Main(void)
+{
+    MDS_Err_t err = DEV_STORAGE_AdaptrInit(&g_testAdaptr, "flash", &G_DRV_STORAGE_SIMULATE,
+                                           (MDS_DevHandle_t *)(&g_testSimulate), NULL);
+    if (err == MDS_EOK) {
+        err = DEV_STORAGE_PeriphInit(&g_testPeriph, "cache", &g_testAdaptr);
+        g_testPeriph.object.blockNums = TEST_CACHE_BLOCK_NUMS;
+    }
+    if (err == MDS_EOK) {
+        err = DEV_STORAGE_CacheInit(&g_testCache, g_testLine, TEST_CACHE_LINE_NUMS, g_testLineBuff,
+                                    TEST_CACHE_LINE_SIZE, true);
+    }
+    if (err == MDS_EOK) {
+        err = DEV_STORAGE_PeriphCache(&g_testPeriph, &g_testCache);
+    }
+    if (!MDS_TEST_CHECK(err == MDS_EOK)) {
+        return;
+    }
+
+    TEST_CacheClose();
+    TEST_CacheReadThrough();
+    TEST_CacheFuzz();
+    TEST_CacheEmfs();
+    TEST_CacheVector();
+    TEST_CacheGeometry();
+    TEST_CacheMediaChanged();
+    TEST_CacheHeaderBench();
+}
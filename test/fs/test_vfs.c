@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+#include "mds_fs.h"
+#include <stdio.h>
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_VFS_FILE_NUMS 40
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_FsDevice_t g_testDevice[2];
+static size_t g_testNodes = 0;
+static size_t g_testOpens = 0;
+static size_t g_testCloses = 0;
+static MDS_FileDesc_t g_testFd[TEST_VFS_FILE_NUMS][2];
+
+/* Function ---------------------------------------------------------------- */
+static MDS_Err_t TEST_VfsOpen(MDS_FileDesc_t *fd)
+{
+    // a node seen for the first time counts once, a shared node keeps its marker
+    if (fd->node->data == NULL) {
+        fd->node->data = (MDS_Arg_t *)(&g_testNodes);
+        g_testNodes += 1;
+    }
+    g_testOpens += 1;
+
+    return (MDS_EOK);
+}
+
+static MDS_Err_t TEST_VfsClose(MDS_FileDesc_t *fd)
+{
+    UNUSED(fd);
+
+    g_testCloses += 1;
+
+    return (MDS_EOK);
+}
+
+static MDS_Err_t TEST_VfsStat(MDS_FileSystem_t *fs, const char *filename, MDS_FileStat_t *stat)
+{
+    UNUSED(fs);
+    UNUSED(filename);
+    UNUSED(stat);
+
+    return (MDS_EOK);
+}
+
+static const MDS_FileSystemOps_t G_TEST_VFS_OPS = {
+    .name = "testvfs",
+    .open = TEST_VfsOpen,
+    .close = TEST_VfsClose,
+    .stat = TEST_VfsStat,
+};
+MDS_FILE_SYSTEM_EXPORT(testvfs, G_TEST_VFS_OPS);
+
+static void TEST_VfsShared(void)
+{
+    MDS_FileDesc_t fd[3];
+
+    // two spellings of one file share the node of the mount relative path
+    size_t nodes = g_testNodes;
+    MDS_TEST_CHECK(MDS_FileOpen(&(fd[0]), "/mnt/a", MDS_FFLAG_RDONLY) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_FileOpen(&(fd[1]), "/mnt/./dir/../a", MDS_FFLAG_RDONLY) == MDS_EOK);
+    MDS_TEST_CHECK(fd[0].node == fd[1].node);
+    MDS_TEST_CHECK(fd[1].node->refCount == 2);
+    MDS_TEST_CHECK(g_testNodes == (nodes + 1));
+
+    // one close keeps the node for the other descriptor
+    MDS_TEST_CHECK(MDS_FileClose(&(fd[0])) == MDS_EOK);
+    MDS_TEST_CHECK(fd[1].node->refCount == 1);
+    MDS_TEST_CHECK(MDS_FileOpen(&(fd[2]), "/mnt/a", MDS_FFLAG_RDONLY) == MDS_EOK);
+    MDS_TEST_CHECK(fd[2].node == fd[1].node);
+    MDS_TEST_CHECK(fd[2].node->refCount == 2);
+    MDS_TEST_CHECK(g_testNodes == (nodes + 1));
+
+    // the same relative path under another mount is another file
+    MDS_TEST_CHECK(MDS_FileOpen(&(fd[0]), "/data/a", MDS_FFLAG_RDONLY) == MDS_EOK);
+    MDS_TEST_CHECK(fd[0].node != fd[1].node);
+    MDS_TEST_CHECK(g_testNodes == (nodes + 2));
+
+    // closing the last descriptor of a node is not an error
+    MDS_TEST_CHECK(MDS_FileClose(&(fd[2])) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_FileClose(&(fd[1])) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_FileClose(&(fd[0])) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_FileSystemUnmount("/data") == MDS_EOK);
+}
+
+static void TEST_VfsMany(void)
+{
+    char path[32];
+    size_t nodes = g_testNodes;
+
+    // enough nodes to chain in every hash bucket, each opened twice
+    for (size_t idx = 0; idx < TEST_VFS_FILE_NUMS; idx++) {
+        snprintf(path, sizeof(path), "/mnt/file%u", (unsigned)idx);
+        MDS_TEST_CHECK(MDS_FileOpen(&(g_testFd[idx][0]), path, MDS_FFLAG_RDWR) == MDS_EOK);
+        snprintf(path, sizeof(path), "/mnt//file%u/", (unsigned)idx);
+        MDS_TEST_CHECK(MDS_FileOpen(&(g_testFd[idx][1]), path, MDS_FFLAG_RDWR) == MDS_EOK);
+        MDS_TEST_CHECK(g_testFd[idx][0].node == g_testFd[idx][1].node);
+    }
+    MDS_TEST_CHECK(g_testNodes == (nodes + TEST_VFS_FILE_NUMS));
+
+    for (size_t idx = 0; idx < TEST_VFS_FILE_NUMS; idx++) {
+        MDS_TEST_CHECK(MDS_FileClose(&(g_testFd[idx][idx % 2])) == MDS_EOK);
+    }
+    MDS_TEST_CHECK(MDS_FileSystemUnmount("/mnt") == MDS_EBUSY);
+
+    for (size_t idx = 0; idx < TEST_VFS_FILE_NUMS; idx++) {
+        MDS_FileDesc_t *fd = &(g_testFd[idx][(idx + 1) % 2]);
+        MDS_TEST_CHECK((fd->node != NULL) && (fd->node->refCount == 1));
+        MDS_TEST_CHECK(MDS_FileClose(fd) == MDS_EOK);
+    }
+    MDS_TEST_CHECK(g_testOpens == g_testCloses);
+}
+
+void MDS_TEST_Main(void)
+{
+#if (defined(MDS_FILESYSTEM_HASH_SIZE) && (MDS_FILESYSTEM_HASH_SIZE > 0))
+    MDS_LOG_I("[test] vfs hash size:%u", MDS_FILESYSTEM_HASH_SIZE);
+#endif
+
+    MDS_TEST_CHECK(MDS_FileSystemMount(&(g_testDevice[0]), "/mnt", "testvfs", NULL) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_FileSystemMount(&(g_testDevice[1]), "/data", "testvfs", NULL) == MDS_EOK);
+
+    TEST_VfsShared();
+    TEST_VfsMany();
+
+    // an unmounted path is gone, also for lookups the path cache answered before
+    MDS_FileStat_t stat;
+    MDS_TEST_CHECK(MDS_FileStat("/mnt/a", &stat) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_FileSystemUnmount("/mnt") == MDS_EOK);
+    MDS_TEST_CHECK(MDS_FileStat("/mnt/a", &stat) == MDS_ENOENT);
+
+    MDS_LOG_I("[test] vfs nodes:%u opens:%u closes:%u", (unsigned)g_testNodes, (unsigned)g_testOpens,
+              (unsigned)g_testCloses);
+}
@@ -0,0 +1,350 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+#include "mds_dev.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_HOOK_TICKS  500
+#define TEST_HOOK_YIELDS 20000
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_Timer_t g_testTimer;
+static volatile size_t g_testToggle = 0;
+static volatile size_t g_testCount[3] = {0};
+static char g_testOrder[4];
+static size_t g_testOrderLen = 0;
+
+static MDS_Device_t g_testDevice;
+
+/* Function ---------------------------------------------------------------- */
+static void TEST_HookWork(size_t idx)
+{
+    if (g_testOrderLen < ARRAY_SIZE(g_testOrder)) {
+        g_testOrder[g_testOrderLen++] = (char)('A' + idx);
+    }
+    g_testCount[idx] += 1;
+
+    // widen the window for the tick interrupt to land inside the chain
+    for (volatile size_t cnt = 0; cnt < 64; cnt++) {
+    }
+}
+
+static void TEST_DeviceHookA(const MDS_Device_t *device, MDS_DeviceCmd_t cmd)
+{
+    UNUSED(device);
+    UNUSED(cmd);
+
+    TEST_HookWork(0);
+}
+
+static void TEST_DeviceHookB(const MDS_Device_t *device, MDS_DeviceCmd_t cmd)
+{
+    UNUSED(device);
+    UNUSED(cmd);
+
+    TEST_HookWork(1);
+}
+
+static void TEST_DeviceHookC(const MDS_Device_t *device, MDS_DeviceCmd_t cmd)
+{
+    UNUSED(device);
+    UNUSED(cmd);
+
+    TEST_HookWork(2);
+}
+
+static void TEST_DeviceTimerEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    // toggles the last hook while the thread walks the chain
+    if (MDS_DeviceUnregisterHook(&g_testDevice, TEST_DeviceHookB) != MDS_EOK) {
+        MDS_DeviceRegisterHook(&g_testDevice, TEST_DeviceHookB);
+    }
+    g_testToggle += 1;
+}
+
+static void TEST_ResetCount(void)
+{
+    g_testToggle = 0;
+    g_testOrderLen = 0;
+    for (size_t idx = 0; idx < ARRAY_SIZE(g_testCount); idx++) {
+        g_testCount[idx] = 0;
+    }
+}
+
+static bool TEST_ChainStress(void (*entry)(MDS_Arg_t *), void (*trigger)(void), size_t fixed)
+{
+    MDS_Err_t err = MDS_TimerInit(&g_testTimer, "hook", MDS_TIMER_TYPE_PERIOD | MDS_TIMER_TYPE_SYSTEM, entry, NULL);
+    if (err == MDS_EOK) {
+        err = MDS_TimerStart(&g_testTimer, 1);
+    }
+    if (!MDS_TEST_CHECK(err == MDS_EOK)) {
+        return (false);
+    }
+
+    TEST_ResetCount();
+    size_t calls = 0;
+    MDS_Tick_t start = MDS_SysTickGetCount();
+    while ((MDS_SysTickGetCount() - start) < TEST_HOOK_TICKS) {
+        trigger();
+        calls += 1;
+    }
+    MDS_TimerStop(&g_testTimer);
+    MDS_TimerDeInit(&g_testTimer);
+
+    MDS_LOG_I("[test] hook calls:%u toggle:%u A:%u B:%u", (unsigned)calls, (unsigned)g_testToggle,
+              (unsigned)g_testCount[0], (unsigned)g_testCount[1]);
+
+    // the first hook is never behind a removed one, the toggled one ran only while registered
+    MDS_TEST_CHECK(g_testToggle >= (TEST_HOOK_TICKS / 2));
+    MDS_TEST_CHECK((fixed == 0) || (g_testCount[0] == calls));
+    MDS_TEST_CHECK(g_testCount[1] <= calls);
+
+    return (true);
+}
+
+static void TEST_DeviceTrigger(void)
+{
+    MDS_DeviceGetId(&g_testDevice);
+}
+
+static void TEST_DeviceHook(void)
+{
+    MDS_TEST_CHECK(MDS_DeviceUnregisterHook(&g_testDevice, TEST_DeviceHookA) == MDS_ENOENT);
+    MDS_TEST_CHECK(MDS_DeviceRegisterHook(&g_testDevice, TEST_DeviceHookA) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_DeviceRegisterHook(&g_testDevice, TEST_DeviceHookA) == MDS_EEXIST);
+
+#if (MDS_DEVICE_HOOK_SIZE >= 3)
+    // removal keeps the order of the remaining hooks
+    MDS_TEST_CHECK(MDS_DeviceRegisterHook(&g_testDevice, TEST_DeviceHookB) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_DeviceRegisterHook(&g_testDevice, TEST_DeviceHookC) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_DeviceUnregisterHook(&g_testDevice, TEST_DeviceHookA) == MDS_EOK);
+    TEST_ResetCount();
+    TEST_DeviceTrigger();
+    MDS_TEST_CHECK((g_testOrderLen == 2) && (g_testOrder[0] == 'B') && (g_testOrder[1] == 'C'));
+    MDS_DeviceRegisterHook(&g_testDevice, NULL);
+    MDS_DeviceRegisterHook(&g_testDevice, TEST_DeviceHookA);
+#else
+    UNUSED(TEST_DeviceHookC);
+#endif
+
+    size_t fixed = 1;
+    if (MDS_DeviceRegisterHook(&g_testDevice, TEST_DeviceHookB) == MDS_ENOMEM) {
+        // a single slot chain, only the toggled hook is left
+        MDS_DeviceRegisterHook(&g_testDevice, NULL);
+        fixed = 0;
+    }
+    TEST_ChainStress(TEST_DeviceTimerEntry, TEST_DeviceTrigger, fixed);
+    MDS_DeviceRegisterHook(&g_testDevice, NULL);
+}
+
+#if (defined(MDS_HOOK_ENABLE) && (MDS_HOOK_ENABLE > 0))
+static MDS_Semaphore_t g_testSemaphore;
+
+static void TEST_KernelHookA(MDS_Semaphore_t *semaphore, MDS_Tick_t timeout)
+{
+    UNUSED(timeout);
+
+    if (semaphore == &g_testSemaphore) {
+        TEST_HookWork(0);
+    }
+}
+
+static void TEST_KernelHookB(MDS_Semaphore_t *semaphore, MDS_Tick_t timeout)
+{
+    UNUSED(timeout);
+
+    if (semaphore == &g_testSemaphore) {
+        TEST_HookWork(1);
+    }
+}
+
+static void TEST_KernelHookC(MDS_Semaphore_t *semaphore, MDS_Tick_t timeout)
+{
+    UNUSED(timeout);
+
+    if (semaphore == &g_testSemaphore) {
+        TEST_HookWork(2);
+    }
+}
+
+static void TEST_KernelTimerEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    if (MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookB) != MDS_EOK) {
+        MDS_HOOK_REGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookB);
+    }
+    g_testToggle += 1;
+}
+
+static void TEST_KernelTrigger(void)
+{
+    MDS_SemaphoreAcquire(&g_testSemaphore, 0);
+}
+
+static volatile bool g_testYieldStop = false;
+static volatile size_t g_testSwitch[4] = {0};
+
+static void TEST_SwitchHookA(MDS_Thread_t *toThread, MDS_Thread_t *fromThread)
+{
+    UNUSED(toThread);
+    UNUSED(fromThread);
+
+    g_testSwitch[0] += 1;
+}
+
+static void TEST_SwitchHookB(MDS_Thread_t *toThread, MDS_Thread_t *fromThread)
+{
+    UNUSED(toThread);
+    UNUSED(fromThread);
+
+    g_testSwitch[1] += 1;
+}
+
+static void TEST_SwitchHookC(MDS_Thread_t *toThread, MDS_Thread_t *fromThread)
+{
+    UNUSED(toThread);
+    UNUSED(fromThread);
+
+    g_testSwitch[2] += 1;
+}
+
+static void TEST_SwitchHookD(MDS_Thread_t *toThread, MDS_Thread_t *fromThread)
+{
+    UNUSED(toThread);
+    UNUSED(fromThread);
+
+    g_testSwitch[3] += 1;
+}
+
+static void TEST_YieldEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    while (!g_testYieldStop) {
+        MDS_ThreadYield();
+    }
+}
+
+static uint64_t TEST_YieldPingPong(void)
+{
+    // same priority as this thread, so every yield hands the core over
+    g_testYieldStop = false;
+    MDS_Thread_t *peer = MDS_ThreadCreate("yield", TEST_YieldEntry, NULL, 32768, 2, 10);
+    if (!MDS_TEST_CHECK(peer != NULL)) {
+        return (0);
+    }
+    MDS_ThreadStartup(peer);
+    MDS_ThreadYield();
+
+    uint64_t start = MDS_TEST_ClockNs();
+    for (size_t idx = 0; idx < TEST_HOOK_YIELDS; idx++) {
+        MDS_ThreadYield();
+    }
+    uint64_t cost = MDS_TEST_ClockNs() - start;
+
+    g_testYieldStop = true;
+    MDS_ThreadYield();
+    MDS_ThreadDestroy(peer);
+
+    return (cost / (TEST_HOOK_YIELDS * 2));
+}
+
+static void TEST_SwitchHook(void)
+{
+    static void (*const hooks[])(MDS_Thread_t *, MDS_Thread_t *) = {
+        TEST_SwitchHookA,
+        TEST_SwitchHookB,
+        TEST_SwitchHookC,
+        TEST_SwitchHookD,
+    };
+    size_t limit = (MDS_HOOK_CHAIN_SIZE < ARRAY_SIZE(hooks)) ? (MDS_HOOK_CHAIN_SIZE) : (ARRAY_SIZE(hooks));
+    uint64_t base = 0;
+
+    // switch cost with a growing chain, every subscriber sees each switch of both threads
+    for (size_t nums = 0; nums <= limit; nums++) {
+        for (size_t idx = 0; idx < ARRAY_SIZE(g_testSwitch); idx++) {
+            g_testSwitch[idx] = 0;
+        }
+        for (size_t idx = 0; idx < nums; idx++) {
+            MDS_TEST_CHECK(MDS_HOOK_REGISTER(SCHEDULER_SWITCH, hooks[idx]) == MDS_EOK);
+        }
+
+        uint64_t cost = TEST_YieldPingPong();
+
+        for (size_t idx = 0; idx < nums; idx++) {
+            MDS_HOOK_UNREGISTER(SCHEDULER_SWITCH, hooks[idx]);
+            MDS_TEST_CHECK(g_testSwitch[idx] >= (TEST_HOOK_YIELDS * 2));
+        }
+        if (nums == 0) {
+            base = cost;
+            MDS_LOG_I("[test] yield switch subscribers:0 %uns/switch", (unsigned)cost);
+        } else {
+            MDS_LOG_I("[test] yield switch subscribers:%u %uns/switch %dns/subscriber", (unsigned)nums, (unsigned)cost,
+                      (int)(((int64_t)cost - (int64_t)base) / (int64_t)nums));
+        }
+    }
+}
+
+static void TEST_KernelHook(void)
+{
+    MDS_Err_t err = MDS_SemaphoreInit(&g_testSemaphore, "hook", 0, 1);
+    if (!MDS_TEST_CHECK(err == MDS_EOK)) {
+        return;
+    }
+
+    MDS_TEST_CHECK(MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookA) == MDS_ENOENT);
+    MDS_TEST_CHECK(MDS_HOOK_REGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookA) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_HOOK_REGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookA) == MDS_EEXIST);
+
+#if (MDS_HOOK_CHAIN_SIZE >= 3)
+    MDS_TEST_CHECK(MDS_HOOK_REGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookB) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_HOOK_REGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookC) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookA) == MDS_EOK);
+    TEST_ResetCount();
+    TEST_KernelTrigger();
+    MDS_TEST_CHECK((g_testOrderLen == 2) && (g_testOrder[0] == 'B') && (g_testOrder[1] == 'C'));
+    MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookB);
+    MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookC);
+    MDS_HOOK_REGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookA);
+#else
+    UNUSED(TEST_KernelHookC);
+#endif
+
+    size_t fixed = 1;
+    if (MDS_HOOK_REGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookB) == MDS_ENOMEM) {
+        MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookA);
+        fixed = 0;
+    }
+    TEST_ChainStress(TEST_KernelTimerEntry, TEST_KernelTrigger, fixed);
+    MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookA);
+    MDS_HOOK_UNREGISTER(SEMAPHORE_TRY_ACQUIRE, TEST_KernelHookB);
+
+    MDS_SemaphoreDeInit(&g_testSemaphore);
+
+    TEST_SwitchHook();
+}
+#endif
+
+void MDS_TEST_Main(void)
+{
+    TEST_DeviceHook();
+
+#if (defined(MDS_HOOK_ENABLE) && (MDS_HOOK_ENABLE > 0))
+    TEST_KernelHook();
+#else
+    MDS_LOG_I("[test] kernel hooks are off, only the device chain was checked");
+#endif
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_MEMBUFF_SIZE  4200
+#define TEST_MEMBUFF_ROUND 200000
+#define TEST_MEMBUFF_BENCH 20000
+
+/* Variable ---------------------------------------------------------------- */
+static uint8_t g_testSrc[TEST_MEMBUFF_SIZE];
+static uint8_t g_testDst[TEST_MEMBUFF_SIZE];
+static uint8_t g_testRef[TEST_MEMBUFF_SIZE];
+static uint32_t g_testSeed = 0x9E3779B9U;
+
+/* Function ---------------------------------------------------------------- */
+static uint32_t TEST_Random(void)
+{
+    g_testSeed ^= g_testSeed << 13;
+    g_testSeed ^= g_testSeed >> 17;
+    g_testSeed ^= g_testSeed << 5;
+
+    return (g_testSeed);
+}
+
+static int TEST_Sign(int value)
+{
+    return ((value > 0) - (value < 0));
+}
+
+static size_t TEST_Fuzz(void)
+{
+    size_t bad = 0;
+
+    // every alignment pair of source and destination against the libc reference
+    for (size_t round = 0; round < TEST_MEMBUFF_ROUND; round++) {
+        size_t len = TEST_Random() % ((round < (TEST_MEMBUFF_ROUND / 2)) ? (70) : (4000));
+        size_t dstOfs = TEST_Random() % 16;
+        size_t srcOfs = TEST_Random() % 16;
+        size_t span = len + 32;
+
+        for (size_t idx = 0; idx < span; idx++) {
+            g_testSrc[idx] = (uint8_t)TEST_Random();
+            g_testDst[idx] = g_testRef[idx] = (uint8_t)TEST_Random();
+        }
+
+        uint32_t op = TEST_Random() % 3;
+        if (op == 0) {
+            size_t ret = MDS_MemBuffCopy(g_testDst + dstOfs, len, g_testSrc + srcOfs, len + (TEST_Random() % 3));
+            memcpy(g_testRef + dstOfs, g_testSrc + srcOfs, len);
+            bad += ((ret != len) || (memcmp(g_testDst, g_testRef, span) != 0)) ? (1) : (0);
+        } else if (op == 1) {
+            int c = (int)TEST_Random();
+            MDS_MemBuffSet(g_testDst + dstOfs, c, len);
+            memset(g_testRef + dstOfs, c, len);
+            bad += (memcmp(g_testDst, g_testRef, span) != 0) ? (1) : (0);
+        } else {
+            memcpy(g_testDst + dstOfs, g_testSrc + srcOfs, len);
+            if ((len != 0) && ((TEST_Random() % 2) != 0)) {
+                g_testDst[dstOfs + (TEST_Random() % len)] ^= (uint8_t)(1U << (TEST_Random() % 8));
+            }
+            int ret = MDS_MemBuffCmp(g_testSrc + srcOfs, g_testDst + dstOfs, len);
+            bad += (TEST_Sign(ret) != TEST_Sign(memcmp(g_testSrc + srcOfs, g_testDst + dstOfs, len))) ? (1) : (0);
+        }
+    }
+
+    return (bad);
+}
+
+static void TEST_Bench(size_t dstOfs, size_t srcOfs)
+{
+    const size_t len = 4096;
+    volatile int sink = 0;
+
+    uint64_t start = MDS_TEST_ClockNs();
+    for (size_t round = 0; round < TEST_MEMBUFF_BENCH; round++) {
+        MDS_MemBuffCopy(g_testDst + dstOfs, len, g_testSrc + srcOfs, len);
+        __asm volatile("" ::"r"(g_testDst) : "memory");
+    }
+    uint64_t copy = MDS_TEST_ClockNs() - start;
+
+    start = MDS_TEST_ClockNs();
+    for (size_t round = 0; round < TEST_MEMBUFF_BENCH; round++) {
+        MDS_MemBuffSet(g_testDst + dstOfs, (int)round, len);
+        __asm volatile("" ::"r"(g_testDst) : "memory");
+    }
+    uint64_t set = MDS_TEST_ClockNs() - start;
+
+    memcpy(g_testDst + dstOfs, g_testSrc + srcOfs, len);
+    start = MDS_TEST_ClockNs();
+    for (size_t round = 0; round < TEST_MEMBUFF_BENCH; round++) {
+        sink += MDS_MemBuffCmp(g_testDst + dstOfs, g_testSrc + srcOfs, len);
+        __asm volatile("" ::"r"(g_testDst) : "memory");
+    }
+    uint64_t cmp = MDS_TEST_ClockNs() - start;
+    MDS_TEST_CHECK(sink == 0);
+
+    // bytes per nanosecond is GB/s, logged in MB/s to stay with integers
+    uint64_t bytes = (uint64_t)len * TEST_MEMBUFF_BENCH * 1000U;
+    MDS_LOG_I("[test] membuff dst+%u src+%u copy:%uMB/s set:%uMB/s cmp:%uMB/s", (unsigned)dstOfs, (unsigned)srcOfs,
+              (unsigned)(bytes / copy), (unsigned)(bytes / set), (unsigned)(bytes / cmp));
+}
+
+void MDS_TEST_Main(void)
+{
+    size_t bad = TEST_Fuzz();
+
+    MDS_LOG_I("[test] membuff fuzz rounds:%u bad:%u", (unsigned)TEST_MEMBUFF_ROUND, (unsigned)bad);
+    MDS_TEST_CHECK(bad == 0);
+
+    TEST_Bench(0, 0);
+    TEST_Bench(1, 0);
+    TEST_Bench(0, 3);
+    TEST_Bench(1, 2);
+}
@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_MEMHEAP_SIZE  (256 * 1024)
+#define TEST_MEMHEAP_SLOTS 2000
+#define TEST_MEMHEAP_ROUND 300000
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_MemHeap_t g_testHeap;
+static uint8_t g_testHeapBuff[TEST_MEMHEAP_SIZE] __attribute__((aligned(16)));
+
+static uint8_t *g_testPtr[TEST_MEMHEAP_SLOTS];
+static size_t g_testSize[TEST_MEMHEAP_SLOTS];
+static uint8_t g_testFill[TEST_MEMHEAP_SLOTS];
+static uint32_t g_testSeed = 0x2545F491U;
+
+/* Function ---------------------------------------------------------------- */
+static uint32_t TEST_Random(void)
+{
+    g_testSeed ^= g_testSeed << 13;
+    g_testSeed ^= g_testSeed >> 17;
+    g_testSeed ^= g_testSeed << 5;
+
+    return (g_testSeed);
+}
+
+static size_t TEST_RandomSize(void)
+{
+    // mostly small blocks with an occasional large one to fragment the heap
+    return (1 + (TEST_Random() % (((TEST_Random() % 8) == 0) ? (8192) : (256))));
+}
+
+static bool TEST_CheckFill(const uint8_t *ptr, size_t size, uint8_t fill)
+{
+    for (size_t idx = 0; idx < size; idx++) {
+        if (ptr[idx] != fill) {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+static bool TEST_InHeap(const uint8_t *ptr, size_t size)
+{
+    return ((ptr >= g_testHeapBuff) && ((ptr + size) <= (g_testHeapBuff + sizeof(g_testHeapBuff))));
+}
+
+void MDS_TEST_Main(void)
+{
+    MDS_Err_t err = MDS_MemHeapInit(&g_testHeap, "heap", g_testHeapBuff, g_testHeapBuff + sizeof(g_testHeapBuff));
+    if (!MDS_TEST_CHECK(err == MDS_EOK)) {
+        return;
+    }
+
+    size_t fails = 0;
+    size_t corrupt = 0;
+    size_t misalign = 0;
+    uint64_t allocSum = 0;
+    uint64_t allocMax = 0;
+    uint64_t allocCnt = 0;
+    uint64_t freeMax = 0;
+
+    for (size_t round = 0; round < TEST_MEMHEAP_ROUND; round++) {
+        size_t idx = TEST_Random() % TEST_MEMHEAP_SLOTS;
+
+        if (g_testPtr[idx] == NULL) {
+            size_t size = TEST_RandomSize();
+            size_t align = ((TEST_Random() % 10) == 0) ? (16U << (TEST_Random() % 4)) : (0);
+
+            uint64_t start = MDS_TEST_ClockNs();
+            uint8_t *ptr = (align != 0) ? (MDS_MemHeapAlignedAlloc(&g_testHeap, align, size))
+                                        : (MDS_MemHeapAlloc(&g_testHeap, size));
+            uint64_t cost = MDS_TEST_ClockNs() - start;
+            allocSum += cost;
+            allocCnt += 1;
+            allocMax = (cost > allocMax) ? (cost) : (allocMax);
+            if (ptr == NULL) {
+                fails += 1;
+                continue;
+            }
+            if (!TEST_InHeap(ptr, size)) {
+                corrupt += 1;
+                continue;
+            }
+#if (defined(MDS_MEMHEAP_TLSF) && (MDS_MEMHEAP_TLSF > 0))
+            // the first-fit backend only keeps the system alignment
+            if ((align != 0) && (((uintptr_t)ptr % align) != 0)) {
+                misalign += 1;
+            }
+#endif
+            g_testPtr[idx] = ptr;
+            g_testSize[idx] = size;
+            g_testFill[idx] = (uint8_t)TEST_Random();
+            memset(ptr, g_testFill[idx], size);
+            continue;
+        }
+
+        if (!TEST_CheckFill(g_testPtr[idx], g_testSize[idx], g_testFill[idx])) {
+            corrupt += 1;
+        }
+        if ((TEST_Random() % 4) == 0) {
+            size_t size = TEST_RandomSize();
+            uint8_t *ptr = MDS_MemHeapRealloc(&g_testHeap, g_testPtr[idx], size);
+            if (ptr != NULL) {
+                size_t keep = (size < g_testSize[idx]) ? (size) : (g_testSize[idx]);
+                if ((!TEST_InHeap(ptr, size)) || (!TEST_CheckFill(ptr, keep, g_testFill[idx]))) {
+                    corrupt += 1;
+                }
+                g_testPtr[idx] = ptr;
+                g_testSize[idx] = size;
+                memset(ptr, g_testFill[idx], size);
+            }
+        } else {
+            uint64_t start = MDS_TEST_ClockNs();
+            MDS_MemHeapFree(g_testPtr[idx]);
+            uint64_t cost = MDS_TEST_ClockNs() - start;
+            freeMax = (cost > freeMax) ? (cost) : (freeMax);
+            g_testPtr[idx] = NULL;
+        }
+    }
+
+    for (size_t idx = 0; idx < TEST_MEMHEAP_SLOTS; idx++) {
+        if (g_testPtr[idx] != NULL) {
+            if (!TEST_CheckFill(g_testPtr[idx], g_testSize[idx], g_testFill[idx])) {
+                corrupt += 1;
+            }
+            MDS_MemHeapFree(g_testPtr[idx]);
+            g_testPtr[idx] = NULL;
+        }
+    }
+
+    MDS_LOG_I("[test] memheap alloc avg:%uns max:%uns free max:%uns fails:%u", (unsigned)(allocSum / allocCnt),
+              (unsigned)allocMax, (unsigned)freeMax, (unsigned)fails);
+    MDS_TEST_CHECK(corrupt == 0);
+    MDS_TEST_CHECK(misalign == 0);
+#if (defined(MDS_MEMHEAP_STATS) && (MDS_MEMHEAP_STATS > 0))
+    MDS_TEST_CHECK(g_testHeap.cur == 0);
+#endif
+
+    // every free block merged back, so nearly the whole heap is one block again
+    void *whole = MDS_MemHeapAlloc(&g_testHeap, sizeof(g_testHeapBuff) - 1024);
+    MDS_TEST_CHECK(whole != NULL);
+    MDS_MemHeapFree(whole);
+
+    MDS_TEST_CHECK(MDS_MemHeapDeInit(&g_testHeap) == MDS_EOK);
+}
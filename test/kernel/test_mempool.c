@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_MEMPOOL_BLKSIZE 32
+#define TEST_MEMPOOL_BLKNUMS 5
+#define TEST_MEMPOOL_WORKERS 3
+#define TEST_MEMPOOL_TICKS   2000
+#define TEST_MEMPOOL_HOLDS   4
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_MemPool_t g_testPool;
+static uint8_t g_testPoolBuff[TEST_MEMPOOL_BLKNUMS * (TEST_MEMPOOL_BLKSIZE + sizeof(void *))];
+static MDS_Timer_t g_testTimer;
+static void *g_testIsrHold[TEST_MEMPOOL_HOLDS];
+static volatile size_t g_testIsrAlloc = 0;
+static volatile size_t g_testIsrEmpty = 0;
+static volatile size_t g_testWorkAlloc = 0;
+static volatile size_t g_testDuplicate = 0;
+static volatile bool g_testStop = false;
+static volatile size_t g_testDone = 0;
+
+/* Function ---------------------------------------------------------------- */
+static void TEST_OwnBlock(void *ptr, uint8_t tag)
+{
+    volatile uint8_t *blk = (volatile uint8_t *)ptr;
+
+    // a block handed out twice gets overwritten by its other owner while we look at it
+    for (size_t idx = 0; idx < TEST_MEMPOOL_BLKSIZE; idx++) {
+        blk[idx] = tag;
+    }
+    for (volatile size_t cnt = 0; cnt < 50; cnt++) {
+    }
+    for (size_t idx = 0; idx < TEST_MEMPOOL_BLKSIZE; idx++) {
+        if (blk[idx] != tag) {
+            g_testDuplicate += 1;
+            break;
+        }
+    }
+}
+
+static void TEST_TimerEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    for (size_t idx = 0; idx < TEST_MEMPOOL_HOLDS; idx++) {
+        if (g_testIsrHold[idx] != NULL) {
+            TEST_OwnBlock(g_testIsrHold[idx], (uint8_t)(100 + idx));
+            MDS_MemPoolFree(g_testIsrHold[idx]);
+            g_testIsrHold[idx] = NULL;
+        }
+    }
+
+    size_t nums = MDS_SysTickGetCount() % (TEST_MEMPOOL_HOLDS + 1);
+    for (size_t idx = 0; idx < nums; idx++) {
+        void *ptr = MDS_MemPoolAlloc(&g_testPool, 0);
+        if (ptr == NULL) {
+            g_testIsrEmpty += 1;
+            continue;
+        }
+        TEST_OwnBlock(ptr, (uint8_t)(100 + idx));
+        g_testIsrHold[idx] = ptr;
+        g_testIsrAlloc += 1;
+    }
+}
+
+static void TEST_WorkerEntry(MDS_Arg_t *arg)
+{
+    uint8_t tag = (uint8_t)(uintptr_t)arg;
+
+    for (size_t round = 1; !g_testStop; round++) {
+        void *ptr = MDS_MemPoolAlloc(&g_testPool, 10);
+        if (ptr == NULL) {
+            continue;
+        }
+        TEST_OwnBlock(ptr, tag);
+        void *more = MDS_MemPoolAlloc(&g_testPool, 3);
+        if (more != NULL) {
+            TEST_OwnBlock(more, tag + 10);
+            MDS_MemPoolFree(more);
+        }
+        if ((round % 97) == 0) {
+            MDS_ThreadDelay(1);
+        }
+        MDS_MemPoolFree(ptr);
+        g_testWorkAlloc += 1;
+    }
+
+    g_testDone += 1;
+}
+
+static void TEST_PoolBlocks(void)
+{
+    void *blk[TEST_MEMPOOL_BLKNUMS];
+
+    // every block is handed out once, then the pool is empty
+    for (size_t idx = 0; idx < TEST_MEMPOOL_BLKNUMS; idx++) {
+        blk[idx] = MDS_MemPoolAlloc(&g_testPool, 0);
+        MDS_TEST_CHECK(blk[idx] != NULL);
+        for (size_t prev = 0; prev < idx; prev++) {
+            MDS_TEST_CHECK(blk[prev] != blk[idx]);
+        }
+    }
+    MDS_TEST_CHECK(MDS_MemPoolGetBlkFree(&g_testPool) == 0);
+    MDS_TEST_CHECK(MDS_MemPoolAlloc(&g_testPool, 0) == NULL);
+    for (size_t idx = 0; idx < TEST_MEMPOOL_BLKNUMS; idx++) {
+        MDS_MemPoolFree(blk[idx]);
+    }
+    MDS_TEST_CHECK(MDS_MemPoolGetBlkFree(&g_testPool) == TEST_MEMPOOL_BLKNUMS);
+
+    // a created pool holds the number of blocks asked for
+    MDS_MemPool_t *pool = MDS_MemPoolCreate("pool", TEST_MEMPOOL_BLKSIZE, TEST_MEMPOOL_BLKNUMS);
+    if (MDS_TEST_CHECK(pool != NULL)) {
+        MDS_TEST_CHECK(MDS_MemPoolGetBlkFree(pool) == TEST_MEMPOOL_BLKNUMS);
+        MDS_MemPoolDestroy(pool);
+    }
+}
+
+void MDS_TEST_Main(void)
+{
+    MDS_Err_t err = MDS_MemPoolInit(&g_testPool, "pool", g_testPoolBuff, sizeof(g_testPoolBuff), TEST_MEMPOOL_BLKSIZE);
+    if (!MDS_TEST_CHECK(err == MDS_EOK)) {
+        return;
+    }
+    MDS_TEST_CHECK(MDS_MemPoolGetBlkFree(&g_testPool) == TEST_MEMPOOL_BLKNUMS);
+
+    TEST_PoolBlocks();
+
+    err = MDS_TimerInit(&g_testTimer, "pool", MDS_TIMER_TYPE_PERIOD | MDS_TIMER_TYPE_SYSTEM, TEST_TimerEntry, NULL);
+    if (err == MDS_EOK) {
+        err = MDS_TimerStart(&g_testTimer, 1);
+    }
+    MDS_TEST_CHECK(err == MDS_EOK);
+
+    for (size_t idx = 0; idx < TEST_MEMPOOL_WORKERS; idx++) {
+        MDS_Thread_t *worker = MDS_ThreadCreate("worker", TEST_WorkerEntry, (MDS_Arg_t *)(uintptr_t)(idx + 1), 32768,
+                                                5 + (idx % 2), 2);
+        MDS_TEST_CHECK(worker != NULL);
+        MDS_ThreadStartup(worker);
+    }
+
+    MDS_ThreadDelay(TEST_MEMPOOL_TICKS);
+    MDS_TimerStop(&g_testTimer);
+    g_testStop = true;
+    while (g_testDone < TEST_MEMPOOL_WORKERS) {
+        MDS_ThreadDelay(10);
+    }
+    for (size_t idx = 0; idx < TEST_MEMPOOL_HOLDS; idx++) {
+        MDS_MemPoolFree(g_testIsrHold[idx]);
+        g_testIsrHold[idx] = NULL;
+    }
+
+    MDS_LOG_I("[test] mempool isr alloc:%u empty:%u thread alloc:%u", (unsigned)g_testIsrAlloc,
+              (unsigned)g_testIsrEmpty, (unsigned)g_testWorkAlloc);
+    MDS_TEST_CHECK(g_testIsrAlloc > 0);
+    MDS_TEST_CHECK(g_testWorkAlloc > 0);
+    MDS_TEST_CHECK(g_testDuplicate == 0);
+    MDS_TEST_CHECK(MDS_MemPoolGetBlkFree(&g_testPool) == TEST_MEMPOOL_BLKNUMS);
+
+    MDS_TimerDeInit(&g_testTimer);
+    MDS_TEST_CHECK(MDS_MemPoolDeInit(&g_testPool) == MDS_EOK);
+}
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_MSGQUEUE_NUMS   16
+#define TEST_MSGQUEUE_ROUNDS 2000
+#define TEST_MSGQUEUE_BATCH  8
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_MsgQueue_t g_testMsgQueue;
+static uint8_t g_testQueBuff[TEST_MSGQUEUE_NUMS * (sizeof(void *) + sizeof(uint32_t) + sizeof(uint64_t))];
+static volatile uint32_t g_testRecvCount = 0;
+static volatile uint32_t g_testRecvError = 0;
+
+/* Function ---------------------------------------------------------------- */
+static void TEST_ConsumerEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    uint32_t buff[TEST_MSGQUEUE_BATCH];
+    size_t lens[TEST_MSGQUEUE_BATCH];
+
+    for (uint32_t expect = 0; expect < (TEST_MSGQUEUE_ROUNDS * TEST_MSGQUEUE_BATCH);) {
+        size_t cnt = 0;
+        if (MDS_MsgQueueRecvBatch(&g_testMsgQueue, buff, sizeof(uint32_t), TEST_MSGQUEUE_BATCH, lens, &cnt,
+                                  MDS_TICK_FOREVER) != MDS_EOK) {
+            g_testRecvError += 1;
+            continue;
+        }
+        for (size_t idx = 0; idx < cnt; idx++, expect++) {
+            if ((buff[idx] != expect) || (lens[idx] != sizeof(uint32_t))) {
+                g_testRecvError += 1;
+            }
+        }
+        g_testRecvCount = expect;
+    }
+}
+
+void MDS_TEST_Main(void)
+{
+    MDS_Err_t err = MDS_MsgQueueInit(&g_testMsgQueue, "queue", g_testQueBuff, sizeof(g_testQueBuff), sizeof(uint32_t));
+    MDS_TEST_CHECK(err == MDS_EOK);
+    size_t nums = MDS_MsgQueueGetMsgFree(&g_testMsgQueue);
+    MDS_TEST_CHECK(nums > TEST_MSGQUEUE_BATCH);
+
+    // slots outside the queue buffer are rejected
+    void *slot = NULL;
+    err = MDS_MsgQueueSendAcquire(&g_testMsgQueue, &slot, 0);
+    MDS_TEST_CHECK(err == MDS_EOK);
+    size_t stride = (uintptr_t)(slot) - (uintptr_t)(g_testQueBuff);
+    void *bad = (uint8_t *)(slot) + (stride * nums);
+    MDS_TEST_CHECK(MDS_MsgQueueSendCommit(&g_testMsgQueue, &bad, sizeof(uint32_t), false) == MDS_EINVAL);
+    bad = (uint8_t *)(slot) - (stride * 2);
+    MDS_TEST_CHECK(MDS_MsgQueueSendCommit(&g_testMsgQueue, &bad, sizeof(uint32_t), false) == MDS_EINVAL);
+    bad = (uint8_t *)(slot) + 1;
+    MDS_TEST_CHECK(MDS_MsgQueueSendCommit(&g_testMsgQueue, &bad, sizeof(uint32_t), false) == MDS_EINVAL);
+    MDS_TEST_CHECK(MDS_MsgQueueSendCommit(&g_testMsgQueue, &slot, 0, false) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MsgQueueGetMsgFree(&g_testMsgQueue) == nums);
+
+    // batch receive reports the length of every message
+    uint8_t data[sizeof(uint32_t)] = {0x11, 0x22, 0x33, 0x44};
+    for (size_t len = 1; len <= sizeof(data); len++) {
+        MDS_TEST_CHECK(MDS_MsgQueueSend(&g_testMsgQueue, data, len, 0) == MDS_EOK);
+    }
+    uint8_t recv[TEST_MSGQUEUE_BATCH][sizeof(uint32_t)];
+    size_t lens[TEST_MSGQUEUE_BATCH] = {0};
+    size_t cnt = 0;
+    err = MDS_MsgQueueRecvBatch(&g_testMsgQueue, recv, sizeof(recv[0]), TEST_MSGQUEUE_BATCH, lens, &cnt, 0);
+    MDS_TEST_CHECK((err == MDS_EOK) && (cnt == sizeof(data)));
+    for (size_t idx = 0; idx < cnt; idx++) {
+        MDS_TEST_CHECK(lens[idx] == (idx + 1));
+        MDS_TEST_CHECK(recv[idx][idx] == data[idx]);
+    }
+    err = MDS_MsgQueueRecvBatch(&g_testMsgQueue, recv, sizeof(recv[0]), TEST_MSGQUEUE_BATCH, NULL, &cnt, 0);
+    MDS_TEST_CHECK((err == MDS_ETIME) && (cnt == 0));
+
+    // batches keep fifo order across a blocking consumer
+    MDS_Thread_t *consumer = MDS_ThreadCreate("consumer", TEST_ConsumerEntry, NULL, 32768, 1, 10);
+    MDS_TEST_CHECK(consumer != NULL);
+    MDS_ThreadStartup(consumer);
+
+    uint32_t seq[TEST_MSGQUEUE_BATCH];
+    uint64_t start = MDS_TEST_ClockNs();
+    for (uint32_t round = 0; round < TEST_MSGQUEUE_ROUNDS; round++) {
+        for (size_t idx = 0; idx < TEST_MSGQUEUE_BATCH; idx++) {
+            seq[idx] = (round * TEST_MSGQUEUE_BATCH) + idx;
+        }
+        for (size_t ofs = 0; ofs < TEST_MSGQUEUE_BATCH; ofs += cnt) {
+            err = MDS_MsgQueueSendBatch(&g_testMsgQueue, &seq[ofs], sizeof(uint32_t), TEST_MSGQUEUE_BATCH - ofs, &cnt,
+                                        MDS_TICK_FOREVER);
+            if (err != MDS_EOK) {
+                break;
+            }
+        }
+        if (!MDS_TEST_CHECK(err == MDS_EOK)) {
+            break;
+        }
+    }
+    for (size_t retry = 0; (g_testRecvCount < (TEST_MSGQUEUE_ROUNDS * TEST_MSGQUEUE_BATCH)) && (retry < 100); retry++) {
+        MDS_ThreadDelay(1);
+    }
+    MDS_TEST_CHECK(g_testRecvCount == (TEST_MSGQUEUE_ROUNDS * TEST_MSGQUEUE_BATCH));
+    MDS_TEST_CHECK(g_testRecvError == 0);
+    MDS_LOG_I("[test] batch %u ns/msg",
+              (unsigned)((MDS_TEST_ClockNs() - start) / (TEST_MSGQUEUE_ROUNDS * TEST_MSGQUEUE_BATCH)));
+
+    MDS_MsgQueueDeInit(&g_testMsgQueue);
+}
@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_MUTEX_WORKERS 4
+#define TEST_MUTEX_ROUNDS  20000
+#define TEST_MUTEX_BENCH   1000000
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_Mutex_t g_testMutex;
+static volatile size_t g_testShared = 0;
+static volatile size_t g_testRace = 0;
+static volatile size_t g_testDone = 0;
+
+/* Function ---------------------------------------------------------------- */
+static void TEST_WorkerEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    for (size_t round = 0; round < TEST_MUTEX_ROUNDS; round++) {
+        MDS_MutexAcquire(&g_testMutex, MDS_TICK_FOREVER);
+        if (MDS_MutexGetOwner(&g_testMutex) != MDS_KernelCurrentThread()) {
+            g_testRace += 1;
+        }
+        // a read-modify-write spread out enough for the time slice to end inside it
+        size_t shared = g_testShared;
+        for (volatile size_t cnt = 0; cnt < 16; cnt++) {
+        }
+        g_testShared = shared + 1;
+        MDS_MutexRelease(&g_testMutex);
+    }
+
+    g_testDone += 1;
+}
+
+static void TEST_Uncontended(void)
+{
+    MDS_Thread_t *self = MDS_KernelCurrentThread();
+
+    MDS_TEST_CHECK(MDS_MutexRelease(&g_testMutex) == MDS_EACCES);
+    MDS_TEST_CHECK(MDS_MutexAcquire(&g_testMutex, 0) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MutexAcquire(&g_testMutex, 0) == MDS_EOK);
+    MDS_TEST_CHECK((MDS_MutexGetOwner(&g_testMutex) == self) && (g_testMutex.nest == 2));
+    MDS_TEST_CHECK(MDS_MutexRelease(&g_testMutex) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MutexGetOwner(&g_testMutex) == self);
+    MDS_TEST_CHECK(MDS_MutexRelease(&g_testMutex) == MDS_EOK);
+
+    // a mutex nobody waited on is never linked to its owner
+    MDS_TEST_CHECK(MDS_MutexGetOwner(&g_testMutex) == NULL);
+    MDS_TEST_CHECK((g_testMutex.value == 1) && MDS_ListIsEmpty(&(g_testMutex.node)));
+    MDS_TEST_CHECK(self->currPrio == self->initPrio);
+}
+
+static void TEST_Contended(void)
+{
+    for (size_t idx = 0; idx < TEST_MUTEX_WORKERS; idx++) {
+        MDS_Thread_t *worker = MDS_ThreadCreate("worker", TEST_WorkerEntry, NULL, 32768, 5, 1);
+        if (MDS_TEST_CHECK(worker != NULL)) {
+            MDS_ThreadStartup(worker);
+        }
+    }
+    while (g_testDone < TEST_MUTEX_WORKERS) {
+        MDS_ThreadDelay(10);
+    }
+
+    MDS_LOG_I("[test] mutex shared:%u race:%u", (unsigned)g_testShared, (unsigned)g_testRace);
+    MDS_TEST_CHECK(g_testRace == 0);
+    MDS_TEST_CHECK(g_testShared == (TEST_MUTEX_WORKERS * TEST_MUTEX_ROUNDS));
+    MDS_TEST_CHECK(MDS_MutexGetOwner(&g_testMutex) == NULL);
+    MDS_TEST_CHECK(MDS_ListIsEmpty(&(g_testMutex.node)));
+}
+
+static void TEST_Bench(void)
+{
+    uint64_t start = MDS_TEST_ClockNs();
+    for (size_t round = 0; round < TEST_MUTEX_BENCH; round++) {
+        MDS_MutexAcquire(&g_testMutex, MDS_TICK_FOREVER);
+        MDS_MutexRelease(&g_testMutex);
+    }
+    uint64_t flat = MDS_TEST_ClockNs() - start;
+
+    MDS_MutexAcquire(&g_testMutex, MDS_TICK_FOREVER);
+    start = MDS_TEST_ClockNs();
+    for (size_t round = 0; round < TEST_MUTEX_BENCH; round++) {
+        MDS_MutexAcquire(&g_testMutex, MDS_TICK_FOREVER);
+        MDS_MutexRelease(&g_testMutex);
+    }
+    uint64_t nested = MDS_TEST_ClockNs() - start;
+    MDS_MutexRelease(&g_testMutex);
+
+    MDS_LOG_I("[test] mutex uncontended pair:%uns nested pair:%uns", (unsigned)(flat / TEST_MUTEX_BENCH),
+              (unsigned)(nested / TEST_MUTEX_BENCH));
+}
+
+void MDS_TEST_Main(void)
+{
+    if (!MDS_TEST_CHECK(MDS_MutexInit(&g_testMutex, "mutex") == MDS_EOK)) {
+        return;
+    }
+
+    TEST_Uncontended();
+    TEST_Contended();
+    TEST_Uncontended();
+    TEST_Bench();
+
+    MDS_TEST_CHECK(MDS_MutexDeInit(&g_testMutex) == MDS_EOK);
+}
@@ -0,0 +1,249 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_PRIO_HIGH  3
+#define TEST_PRIO_HIGH2 5
+#define TEST_PRIO_MID   10
+#define TEST_PRIO_LOW   20
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_Mutex_t g_testMutex1;
+static MDS_Mutex_t g_testMutex2;
+static MDS_Mutex_t *g_testMutexDyn;
+static MDS_Thread_t *g_testLow;
+static volatile MDS_Err_t g_testErr;
+static volatile size_t g_testStep;
+
+/* Function ---------------------------------------------------------------- */
+static MDS_Thread_t *TEST_Spawn(const char *name, void (*entry)(MDS_Arg_t *), MDS_ThreadPriority_t prio)
+{
+    MDS_Thread_t *thread = MDS_ThreadCreate(name, entry, NULL, 32768, prio, 10);
+    if (MDS_TEST_CHECK(thread != NULL)) {
+        MDS_ThreadStartup(thread);
+    }
+
+    return (thread);
+}
+
+static void TEST_ChainLowEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex1, MDS_TICK_FOREVER);
+    MDS_ThreadDelay(50);
+    MDS_MutexRelease(&g_testMutex1);
+}
+
+static void TEST_ChainMidEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex2, MDS_TICK_FOREVER);
+    MDS_MutexAcquire(&g_testMutex1, MDS_TICK_FOREVER);
+    MDS_MutexRelease(&g_testMutex1);
+    MDS_MutexRelease(&g_testMutex2);
+}
+
+static void TEST_ChainHighEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex2, MDS_TICK_FOREVER);
+    MDS_MutexRelease(&g_testMutex2);
+}
+
+static void TEST_Chain(void)
+{
+    // high waits on mid, mid waits on low: the boost walks the whole chain
+    g_testLow = TEST_Spawn("low", TEST_ChainLowEntry, TEST_PRIO_LOW);
+    MDS_ThreadDelay(5);
+    MDS_Thread_t *mid = TEST_Spawn("mid", TEST_ChainMidEntry, TEST_PRIO_MID);
+    MDS_ThreadDelay(5);
+    MDS_TEST_CHECK(g_testLow->currPrio == TEST_PRIO_MID);
+
+    TEST_Spawn("high", TEST_ChainHighEntry, TEST_PRIO_HIGH);
+    MDS_ThreadDelay(5);
+    MDS_TEST_CHECK(mid->currPrio == TEST_PRIO_HIGH);
+    MDS_TEST_CHECK(g_testLow->currPrio == TEST_PRIO_HIGH);
+
+    MDS_ThreadDelay(100);
+    MDS_TEST_CHECK(MDS_MutexGetOwner(&g_testMutex1) == NULL);
+    MDS_TEST_CHECK(MDS_MutexGetOwner(&g_testMutex2) == NULL);
+}
+
+static void TEST_MultiLowEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex1, MDS_TICK_FOREVER);
+    MDS_MutexAcquire(&g_testMutex2, MDS_TICK_FOREVER);
+    MDS_ThreadDelay(50);
+
+    // each release drops to the best waiter among the mutexes still held
+    MDS_TEST_CHECK(g_testLow->currPrio == TEST_PRIO_HIGH);
+    MDS_MutexRelease(&g_testMutex1);
+    MDS_TEST_CHECK(g_testLow->currPrio == TEST_PRIO_HIGH2);
+    MDS_MutexRelease(&g_testMutex2);
+    MDS_TEST_CHECK(g_testLow->currPrio == TEST_PRIO_LOW);
+    g_testStep = 1;
+}
+
+static void TEST_MultiHighEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex1, MDS_TICK_FOREVER);
+    MDS_MutexRelease(&g_testMutex1);
+}
+
+static void TEST_MultiHigh2Entry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex2, MDS_TICK_FOREVER);
+    MDS_MutexRelease(&g_testMutex2);
+}
+
+static void TEST_Multi(void)
+{
+    g_testStep = 0;
+    g_testLow = TEST_Spawn("low", TEST_MultiLowEntry, TEST_PRIO_LOW);
+    MDS_ThreadDelay(5);
+    TEST_Spawn("high", TEST_MultiHighEntry, TEST_PRIO_HIGH);
+    TEST_Spawn("high2", TEST_MultiHigh2Entry, TEST_PRIO_HIGH2);
+    MDS_ThreadDelay(100);
+    MDS_TEST_CHECK(g_testStep == 1);
+}
+
+static void TEST_TimeoutLowEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex1, MDS_TICK_FOREVER);
+    MDS_ThreadDelay(100);
+    MDS_MutexRelease(&g_testMutex1);
+}
+
+static void TEST_TimeoutHighEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    g_testErr = MDS_MutexAcquire(&g_testMutex1, 20);
+}
+
+static void TEST_Timeout(void)
+{
+    // a waiter that gives up takes its boost back
+    g_testLow = TEST_Spawn("low", TEST_TimeoutLowEntry, TEST_PRIO_LOW);
+    MDS_ThreadDelay(5);
+    TEST_Spawn("high", TEST_TimeoutHighEntry, TEST_PRIO_HIGH);
+    MDS_ThreadDelay(5);
+    MDS_TEST_CHECK(g_testLow->currPrio == TEST_PRIO_HIGH);
+
+    MDS_ThreadDelay(40);
+    MDS_TEST_CHECK(g_testErr == MDS_ETIME);
+    MDS_TEST_CHECK(g_testLow->currPrio == TEST_PRIO_LOW);
+    MDS_ThreadDelay(100);
+    MDS_TEST_CHECK(MDS_MutexGetOwner(&g_testMutex1) == NULL);
+}
+
+static void TEST_WakeOwnerEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex1, MDS_TICK_FOREVER);
+    MDS_ThreadDelay(200);
+    MDS_MutexRelease(&g_testMutex1);
+}
+
+static void TEST_WakeTimedEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex2, MDS_TICK_FOREVER);
+    g_testErr = MDS_MutexAcquire(&g_testMutex1, 10);
+    MDS_MutexRelease(&g_testMutex2);
+}
+
+static void TEST_WakeHighEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(&g_testMutex2, MDS_TICK_FOREVER);
+    MDS_MutexRelease(&g_testMutex2);
+}
+
+static void TEST_WakeDynEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_MutexAcquire(g_testMutexDyn, MDS_TICK_FOREVER);
+    MDS_ThreadDelay(300);
+}
+
+static void TEST_WakeWaitEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    g_testErr = MDS_MutexAcquire(g_testMutexDyn, MDS_TICK_FOREVER);
+}
+
+static void TEST_Wake(void)
+{
+    g_testErr = MDS_EOK;
+    MDS_Thread_t *owner = TEST_Spawn("owner", TEST_WakeOwnerEntry, TEST_PRIO_LOW + 5);
+    MDS_ThreadDelay(5);
+    MDS_Thread_t *timed = TEST_Spawn("timed", TEST_WakeTimedEntry, TEST_PRIO_LOW);
+    MDS_ThreadDelay(5);
+
+    // the timed waiter woke up but did not run yet: it must not be walked as a waiter any more
+    MDS_TEST_BusyWait(30);
+    MDS_TEST_CHECK((timed->state & MDS_THREAD_STATE_MASK) == MDS_THREAD_STATE_READY);
+    MDS_TEST_CHECK(timed->pendMutex == NULL);
+    TEST_Spawn("high", TEST_WakeHighEntry, 1);
+    MDS_TEST_CHECK(MDS_ListIsEmpty(&(g_testMutex1.list)));
+    MDS_ThreadDelay(50);
+    MDS_TEST_CHECK(g_testErr == MDS_ETIME);
+    MDS_TEST_CHECK(owner->currPrio == (TEST_PRIO_LOW + 5));
+    MDS_ThreadDelay(200);
+
+    // destroying a mutex wakes its waiters with EAGAIN
+    g_testMutexDyn = MDS_MutexCreate("dyn");
+    if (!MDS_TEST_CHECK(g_testMutexDyn != NULL)) {
+        return;
+    }
+    TEST_Spawn("dyn", TEST_WakeDynEntry, TEST_PRIO_LOW + 5);
+    MDS_ThreadDelay(5);
+    TEST_Spawn("wait", TEST_WakeWaitEntry, TEST_PRIO_HIGH2);
+    MDS_ThreadDelay(5);
+    MDS_MutexDestroy(g_testMutexDyn);
+    MDS_ThreadDelay(5);
+    MDS_TEST_CHECK(g_testErr == MDS_EAGAIN);
+    MDS_ThreadDelay(300);
+}
+
+void MDS_TEST_Main(void)
+{
+    MDS_TEST_CHECK(MDS_MutexInit(&g_testMutex1, "mutex1") == MDS_EOK);
+    MDS_TEST_CHECK(MDS_MutexInit(&g_testMutex2, "mutex2") == MDS_EOK);
+
+    TEST_Chain();
+    TEST_Multi();
+    TEST_Timeout();
+    TEST_Wake();
+
+    MDS_MutexDeInit(&g_testMutex1);
+    MDS_MutexDeInit(&g_testMutex2);
+}
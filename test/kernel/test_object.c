@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+#include "mds_dev.h"
+#include <stdio.h>
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_OBJECT_NUMS  500
+#define TEST_OBJECT_ROUND 200
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_Semaphore_t g_testSem[TEST_OBJECT_NUMS];
+static char g_testName[TEST_OBJECT_NUMS][MDS_OBJECT_NAME_SIZE];
+static MDS_Semaphore_t g_testDup;
+static MDS_Mutex_t g_testMutex;
+
+/* Function ---------------------------------------------------------------- */
+static size_t TEST_FindAll(void)
+{
+    size_t bad = 0;
+
+    for (size_t idx = 0; idx < TEST_OBJECT_NUMS; idx++) {
+        MDS_Object_t *object = MDS_ObjectFind(MDS_OBJECT_TYPE_SEMAPHORE, g_testName[idx]);
+        if (object != ((g_testSem[idx].object.name[0] != '\0') ? (&(g_testSem[idx].object)) : (NULL))) {
+            bad += 1;
+        }
+    }
+
+    return (bad);
+}
+
+void MDS_TEST_Main(void)
+{
+    for (size_t idx = 0; idx < TEST_OBJECT_NUMS; idx++) {
+        snprintf(g_testName[idx], sizeof(g_testName[idx]), "sem%03u", (unsigned)idx);
+        MDS_TEST_CHECK(MDS_SemaphoreInit(&(g_testSem[idx]), g_testName[idx], 0, 1) == MDS_EOK);
+    }
+    MDS_TEST_CHECK(TEST_FindAll() == 0);
+
+    // a duplicate name still resolves to the object registered first
+    MDS_TEST_CHECK(MDS_SemaphoreInit(&g_testDup, g_testName[7], 0, 1) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_ObjectFind(MDS_OBJECT_TYPE_SEMAPHORE, g_testName[7]) == &(g_testSem[7].object));
+
+    // the type is part of the key
+    MDS_TEST_CHECK(MDS_MutexInit(&g_testMutex, g_testName[9]) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_ObjectFind(MDS_OBJECT_TYPE_MUTEX, g_testName[9]) == &(g_testMutex.object));
+    MDS_TEST_CHECK(MDS_ObjectFind(MDS_OBJECT_TYPE_MUTEX, g_testName[8]) == NULL);
+    MDS_TEST_CHECK(MDS_ObjectFind(MDS_OBJECT_TYPE_SEMAPHORE, g_testName[9]) == &(g_testSem[9].object));
+    MDS_TEST_CHECK(MDS_DeviceFind("nodev") == NULL);
+
+    uint64_t start = MDS_TEST_ClockNs();
+    size_t bad = 0;
+    for (size_t round = 0; round < TEST_OBJECT_ROUND; round++) {
+        bad += TEST_FindAll();
+    }
+    uint64_t cost = MDS_TEST_ClockNs() - start;
+    MDS_LOG_I("[test] object find %u objects:%uns", (unsigned)TEST_OBJECT_NUMS,
+              (unsigned)(cost / (TEST_OBJECT_ROUND * TEST_OBJECT_NUMS)));
+    MDS_TEST_CHECK(bad == 0);
+
+    // removed objects drop out of the index, the ones left behind them stay reachable
+    for (size_t idx = 0; idx < TEST_OBJECT_NUMS; idx += 2) {
+        MDS_TEST_CHECK(MDS_SemaphoreDeInit(&(g_testSem[idx])) == MDS_EOK);
+        memset(&(g_testSem[idx]), 0, sizeof(g_testSem[idx]));
+    }
+    MDS_TEST_CHECK(TEST_FindAll() == 0);
+    MDS_TEST_CHECK(MDS_SemaphoreDeInit(&(g_testSem[7])) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_ObjectFind(MDS_OBJECT_TYPE_SEMAPHORE, g_testName[7]) == &(g_testDup.object));
+    MDS_TEST_CHECK(MDS_SemaphoreDeInit(&g_testDup) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_ObjectFind(MDS_OBJECT_TYPE_SEMAPHORE, g_testName[7]) == NULL);
+    memset(&(g_testSem[7]), 0, sizeof(g_testSem[7]));
+
+    // and come back once initialized again
+    for (size_t idx = 0; idx < TEST_OBJECT_NUMS; idx += 2) {
+        MDS_TEST_CHECK(MDS_SemaphoreInit(&(g_testSem[idx]), g_testName[idx], 0, 1) == MDS_EOK);
+    }
+    MDS_TEST_CHECK(TEST_FindAll() == 0);
+
+    for (size_t idx = 0; idx < TEST_OBJECT_NUMS; idx++) {
+        if (g_testSem[idx].object.name[0] != '\0') {
+            MDS_SemaphoreDeInit(&(g_testSem[idx]));
+        }
+    }
+    MDS_MutexDeInit(&g_testMutex);
+}
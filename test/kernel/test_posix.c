@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_PINGPONG_ROUNDS 10000
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_Semaphore_t g_testPing, g_testPong;
+static volatile size_t g_testSlowCount = 0;
+static volatile size_t g_testFastCount = 0;
+
+/* Function ---------------------------------------------------------------- */
+static void TEST_PeriodEntry(MDS_Arg_t *arg)
+{
+    volatile size_t *count = (volatile size_t *)arg;
+    MDS_Tick_t period = (count == &g_testFastCount) ? (10) : (100);
+    MDS_Tick_t next = MDS_SysTickGetCount();
+
+    for (;;) {
+        *count += 1;
+        next += period;
+
+        // a late tick batch may wake this thread several periods on, count each of them
+        MDS_Tick_t delay = next - MDS_SysTickGetCount();
+        if ((delay > 0) && (delay <= MDS_TIMER_TICK_MAX)) {
+            MDS_ThreadDelay(delay);
+        }
+    }
+}
+
+static void TEST_PongEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    for (;;) {
+        MDS_SemaphoreAcquire(&g_testPing, MDS_TICK_FOREVER);
+        MDS_SemaphoreRelease(&g_testPong);
+    }
+}
+
+void MDS_TEST_Main(void)
+{
+    // ticks follow the wall clock
+    uint64_t wall = MDS_TEST_ClockNs();
+    MDS_Tick_t tick = MDS_SysTickGetCount();
+    MDS_ThreadDelay(MDS_SYSTICK_FREQ_HZ / 2);
+    wall = MDS_TEST_ClockNs() - wall;
+    tick = MDS_SysTickGetCount() - tick;
+    MDS_TEST_CHECK(tick >= (MDS_SYSTICK_FREQ_HZ / 2));
+    MDS_TEST_CHECK(tick <= ((MDS_SYSTICK_FREQ_HZ / 2) + 10));
+    MDS_TEST_CHECK((wall / 1000000U) >= 490U);
+    MDS_TEST_CHECK((wall / 1000000U) <= 600U);
+
+    // preemptive threads of different periods, above this thread so they run first when a late tick batch wakes all
+    MDS_Thread_t *fast = MDS_ThreadCreate("fast", TEST_PeriodEntry, (MDS_Arg_t *)&g_testFastCount, 32768, 0, 10);
+    MDS_Thread_t *slow = MDS_ThreadCreate("slow", TEST_PeriodEntry, (MDS_Arg_t *)&g_testSlowCount, 32768, 1, 10);
+    MDS_TEST_CHECK((fast != NULL) && (slow != NULL));
+    MDS_ThreadStartup(fast);
+    MDS_ThreadStartup(slow);
+    MDS_ThreadDelay(1005);
+    MDS_TEST_CHECK(g_testFastCount == 101);
+    MDS_TEST_CHECK(g_testSlowCount == 11);
+    MDS_ThreadDestroy(fast);
+    MDS_ThreadDestroy(slow);
+
+    // context switches through a semaphore ping-pong
+    MDS_SemaphoreInit(&g_testPing, "ping", 0, 1);
+    MDS_SemaphoreInit(&g_testPong, "pong", 0, 1);
+    MDS_Thread_t *pong = MDS_ThreadCreate("pong", TEST_PongEntry, NULL, 32768, 1, 10);
+    MDS_TEST_CHECK(pong != NULL);
+    MDS_ThreadStartup(pong);
+
+    size_t rounds = 0;
+    uint64_t start = MDS_TEST_ClockNs();
+    for (; rounds < TEST_PINGPONG_ROUNDS; rounds++) {
+        MDS_SemaphoreRelease(&g_testPing);
+        if (MDS_SemaphoreAcquire(&g_testPong, MDS_SYSTICK_FREQ_HZ) != MDS_EOK) {
+            break;
+        }
+    }
+    MDS_TEST_CHECK(rounds == TEST_PINGPONG_ROUNDS);
+    MDS_LOG_I("[test] ping-pong %u ns/round", (unsigned)((MDS_TEST_ClockNs() - start) / TEST_PINGPONG_ROUNDS));
+}
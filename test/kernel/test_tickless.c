@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Variable ---------------------------------------------------------------- */
+static volatile size_t g_testWakeups = 0;
+
+/* Function ---------------------------------------------------------------- */
+static void TEST_PeriodEntry(MDS_Arg_t *arg)
+{
+    MDS_Tick_t period = (MDS_Tick_t)(uintptr_t)arg;
+
+    for (;;) {
+        MDS_ThreadDelay(period);
+        g_testWakeups += 1;
+    }
+}
+
+static void TEST_SleepExact(const MDS_Tick_t *delays, size_t nums)
+{
+    uint64_t wall = MDS_TEST_ClockNs();
+    MDS_Tick_t total = 0;
+    MDS_Tick_t tick = MDS_SysTickGetCount();
+
+    for (size_t idx = 0; idx < nums; idx++) {
+        MDS_Tick_t start = MDS_SysTickGetCount();
+        MDS_ThreadDelay(delays[idx]);
+        MDS_Tick_t elapsed = MDS_SysTickGetCount() - start;
+        if (!MDS_TEST_CHECK(elapsed == delays[idx])) {
+            MDS_LOG_E("[test] delay:%u elapsed:%u", delays[idx], elapsed);
+        }
+        total += delays[idx];
+    }
+
+    // the idle sleep must neither lose nor invent ticks against the wall clock
+    uint64_t wallms = (MDS_TEST_ClockNs() - wall) / 1000000U;
+    tick = MDS_SysTickGetCount() - tick;
+    MDS_TEST_CHECK(tick == total);
+    MDS_TEST_CHECK((wallms + 5 + (total / 100)) >= tick);
+    MDS_TEST_CHECK(wallms <= (tick + 5 + (total / 100)));
+    MDS_LOG_I("[test] slept ticks:%u wall:%ums", tick, (MDS_Tick_t)wallms);
+}
+
+void MDS_TEST_Main(void)
+{
+    static const MDS_Tick_t delays[] = {500, 1234, 3, 77, 2000, 1, 999};
+
+    // alone, every sleep is a single long idle period
+    TEST_SleepExact(delays, ARRAY_SIZE(delays));
+
+    // with a periodic neighbour, long sleeps are cut short and resumed many times
+    MDS_Thread_t *period = MDS_ThreadCreate("period", TEST_PeriodEntry, (MDS_Arg_t *)(uintptr_t)7, 32768, 5, 10);
+    MDS_TEST_CHECK(period != NULL);
+    MDS_ThreadStartup(period);
+    TEST_SleepExact(delays, ARRAY_SIZE(delays));
+    MDS_ThreadDestroy(period);
+
+    // the neighbour may wake a tick late under host load, but must keep running
+    MDS_TEST_CHECK(g_testWakeups >= ((500 + 1234 + 3 + 77 + 2000 + 1 + 999) / 7 / 2));
+}
@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_TIMER_NUMS  48
+#define TEST_TIMER_ROUND 4000
+#define TEST_TIMER_SLOTS 32U
+#define TEST_TIMER_RANGE (1UL << 20)
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_Timer_t g_testTimer[TEST_TIMER_NUMS];
+static bool g_testActive[TEST_TIMER_NUMS];
+static MDS_Tick_t g_testExpire[TEST_TIMER_NUMS];
+static size_t g_testFired[TEST_TIMER_NUMS * 2];
+static size_t g_testFiredNums = 0;
+static size_t g_testNums = TEST_TIMER_NUMS;
+static bool g_testOverflow = false;
+static uint32_t g_testSeed = 0x2545F491U;
+
+/* Function ---------------------------------------------------------------- */
+// kernel internals from kernel/src/sys/kernel.h, called directly so the test owns every tick
+// the model holds for the skip list and the timer wheel, MDS_TIMER_WHEEL picks which one runs
+extern void MDS_SysTimerCheck(void);
+extern MDS_Tick_t MDS_SysTimerNextTick(void);
+
+static uint32_t TEST_Random(void)
+{
+    g_testSeed ^= g_testSeed << 13;
+    g_testSeed ^= g_testSeed >> 17;
+    g_testSeed ^= g_testSeed << 5;
+
+    return (g_testSeed);
+}
+
+static void TEST_TimerEntry(MDS_Arg_t *arg)
+{
+    if (g_testFiredNums < ARRAY_SIZE(g_testFired)) {
+        g_testFired[g_testFiredNums] = (size_t)(uintptr_t)arg;
+    }
+    g_testFiredNums += 1;
+}
+
+static MDS_Tick_t TEST_TimerTimeout(void)
+{
+    // spread over every wheel level and past the wheel range into the overflow list
+    size_t lvl = (g_testOverflow) ? (4) : (TEST_Random() % 5);
+    if (lvl == 4) {
+        return (TEST_TIMER_RANGE + (TEST_Random() % (TEST_TIMER_RANGE * 2)));
+    }
+
+    MDS_Tick_t span = TEST_TIMER_SLOTS;
+    while (lvl-- > 0) {
+        span *= TEST_TIMER_SLOTS;
+    }
+
+    return (1 + (TEST_Random() % span));
+}
+
+static void TEST_TimerStart(size_t idx)
+{
+    MDS_Tick_t timeout = TEST_TimerTimeout();
+
+    MDS_TEST_CHECK(MDS_TimerStart(&(g_testTimer[idx]), timeout) == MDS_EOK);
+    g_testActive[idx] = true;
+    g_testExpire[idx] = MDS_SysTickGetCount() + timeout;
+}
+
+static MDS_Tick_t TEST_ModelNextTick(MDS_Tick_t currTick)
+{
+    MDS_Tick_t diffTick = MDS_TICK_FOREVER;
+
+    for (size_t idx = 0; idx < g_testNums; idx++) {
+        if ((g_testActive[idx]) && ((g_testExpire[idx] - currTick) < diffTick)) {
+            diffTick = g_testExpire[idx] - currTick;
+        }
+    }
+
+    return ((diffTick == MDS_TICK_FOREVER) ? (MDS_TICK_FOREVER) : (currTick + diffTick));
+}
+
+static void TEST_TimerAdvance(MDS_Tick_t currTick, MDS_Tick_t target)
+{
+    g_testFiredNums = 0;
+    MDS_SysTickSetCount(target);
+    MDS_SysTimerCheck();
+
+    // exactly the timers due up to the target fire, once each and in expiry order
+    size_t expect = 0;
+    for (size_t idx = 0; idx < g_testNums; idx++) {
+        if ((g_testActive[idx]) && ((g_testExpire[idx] - currTick) <= (target - currTick))) {
+            expect += 1;
+        }
+    }
+    if (!MDS_TEST_CHECK(g_testFiredNums == expect)) {
+        MDS_LOG_E("[test] tick:%u target:%u fired:%u expect:%u", currTick, target, (unsigned)g_testFiredNums,
+                  (unsigned)expect);
+        return;
+    }
+
+    MDS_Tick_t last = 0;
+    for (size_t pos = 0; pos < g_testFiredNums; pos++) {
+        size_t idx = g_testFired[pos];
+        MDS_Tick_t diffTick = g_testExpire[idx] - currTick;
+        if (!MDS_TEST_CHECK((g_testActive[idx]) && (diffTick <= (target - currTick)) && (diffTick >= last))) {
+            MDS_LOG_E("[test] tick:%u timer:%u expire:%u out of order", currTick, (unsigned)idx, g_testExpire[idx]);
+        }
+        MDS_TEST_CHECK(!MDS_TimerIsActived(&(g_testTimer[idx])));
+        g_testActive[idx] = false;
+        last = diffTick;
+    }
+}
+
+static MDS_Tick_t TEST_TimerStride(MDS_Tick_t currTick, MDS_Tick_t nextTick)
+{
+    switch (TEST_Random() % 4) {
+        case 0:
+            // land on the next expiry, a single timer fires on its own tick
+            return ((nextTick != MDS_TICK_FOREVER) ? (nextTick - currTick) : (1));
+        case 1:
+            // stop one tick short, nothing may fire early
+            return (((nextTick != MDS_TICK_FOREVER) && ((nextTick - currTick) > 1)) ? (nextTick - currTick - 1) : (1));
+        case 2:
+            return (1 + (TEST_Random() % (TEST_TIMER_SLOTS * 2)));
+        default:
+            // a long jump cascades several levels and refiles the overflow list
+            return (1 + (TEST_Random() % (TEST_TIMER_RANGE * 2)));
+    }
+}
+
+static void TEST_TimerList(size_t nums, bool overflow)
+{
+    g_testNums = nums;
+    g_testOverflow = overflow;
+    for (size_t idx = 0; idx < nums; idx++) {
+        MDS_TEST_CHECK(MDS_TimerInit(&(g_testTimer[idx]), "timer", MDS_TIMER_TYPE_SYSTEM, TEST_TimerEntry,
+                                     (MDS_Arg_t *)(uintptr_t)idx) == MDS_EOK);
+        TEST_TimerStart(idx);
+    }
+
+    size_t fired = 0;
+    for (size_t round = 0; round < TEST_TIMER_ROUND; round++) {
+        MDS_Tick_t currTick = MDS_SysTickGetCount();
+        MDS_Tick_t nextTick = MDS_SysTimerNextTick();
+        if (!MDS_TEST_CHECK(nextTick == TEST_ModelNextTick(currTick))) {
+            MDS_LOG_E("[test] tick:%u next:%u expect:%u", currTick, nextTick, TEST_ModelNextTick(currTick));
+        }
+
+        TEST_TimerAdvance(currTick, currTick + TEST_TimerStride(currTick, nextTick));
+        fired += g_testFiredNums;
+
+        // refill the fired timers and churn a few pending ones
+        for (size_t idx = 0; idx < nums; idx++) {
+            uint32_t op = TEST_Random() % 16;
+            if ((!g_testActive[idx]) || (op == 0)) {
+                TEST_TimerStart(idx);
+            } else if (op == 1) {
+                MDS_TEST_CHECK(MDS_TimerStop(&(g_testTimer[idx])) == MDS_EOK);
+                g_testActive[idx] = false;
+            }
+        }
+    }
+
+    for (size_t idx = 0; idx < nums; idx++) {
+        MDS_TimerDeInit(&(g_testTimer[idx]));
+    }
+    MDS_TEST_CHECK(MDS_SysTimerNextTick() == MDS_TICK_FOREVER);
+
+    MDS_LOG_I("[test] timer list nums:%u overflow:%u rounds:%u fired:%u tick:%u", (unsigned)nums, overflow,
+              TEST_TIMER_ROUND, (unsigned)fired, MDS_SysTickGetCount());
+}
+
+void MDS_TEST_Main(void)
+{
+    // hold the systick off, the test alone moves the tick count from here on
+    MDS_Item_t lock = MDS_CoreInterruptLock();
+
+    TEST_TimerList(TEST_TIMER_NUMS, false);
+    // a few timers all beyond the wheel range, the next tick is only found in the overflow list
+    TEST_TimerList(4, true);
+
+    MDS_CoreInterruptRestore(lock);
+}
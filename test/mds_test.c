@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_Thread_t g_testThread;
+static uint8_t g_testStack[MDS_TEST_STACKSIZE];
+static volatile size_t g_testFailed = 0;
+
+/* Function ---------------------------------------------------------------- */
+#if !(defined(MDS_LOG_DEFERRED) && (MDS_LOG_DEFERRED > 0))
+void MDS_LOG_VaPrintf(size_t level, const char *fmt, size_t cnt, va_list ap)
+{
+    UNUSED(level);
+    UNUSED(cnt);
+
+    vprintf(fmt, ap);
+}
+#endif
+
+bool MDS_TEST_Check(bool pass, const char *expr, const char *file, int line)
+{
+    if (!pass) {
+        printf("[test] FAIL %s:%d: %s\n", file, line, expr);
+        g_testFailed += 1;
+    }
+
+    return (pass);
+}
+
+void MDS_TEST_Skip(const char *reason)
+{
+    printf("[test] SKIP %s\n", reason);
+    fflush(stdout);
+
+    _exit(0);
+}
+
+void MDS_TEST_Finish(void)
+{
+    printf("[test] %s failed:%zu\n", (g_testFailed == 0) ? ("PASS") : ("FAIL"), (size_t)g_testFailed);
+    fflush(stdout);
+
+    _exit((g_testFailed == 0) ? (0) : (1));
+}
+
+uint64_t MDS_TEST_ClockNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)(ts.tv_sec) * 1000000000U + (uint64_t)(ts.tv_nsec));
+}
+
+void MDS_TEST_BusyWait(MDS_Tick_t ticks)
+{
+    MDS_Tick_t start = MDS_SysTickGetCount();
+
+    while ((MDS_SysTickGetCount() - start) < ticks) {
+    }
+}
+
+static void TEST_ThreadEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    MDS_TEST_Main();
+    MDS_TEST_Finish();
+}
+
+int main(void)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    MDS_KernelInit();
+
+    MDS_Err_t err = MDS_ThreadInit(&g_testThread, "test", TEST_ThreadEntry, NULL, g_testStack, sizeof(g_testStack),
+                                   MDS_TEST_PRIORITY, MDS_TEST_TICKS);
+    if (err != MDS_EOK) {
+        printf("[test] FAIL thread init err:%d\n", err);
+        return (1);
+    }
+    MDS_ThreadStartup(&g_testThread);
+
+    MDS_KernelStartup();
+
+    return (1);
+}
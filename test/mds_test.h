@@ -0,0 +1,51 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+#ifndef __MDS_TEST_H__
+#define __MDS_TEST_H__
+
+/* Include ----------------------------------------------------------------- */
+#include "mds_sys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Define ------------------------------------------------------------------ */
+#ifndef MDS_TEST_STACKSIZE
+#define MDS_TEST_STACKSIZE 65536
+#endif
+
+#ifndef MDS_TEST_PRIORITY
+#define MDS_TEST_PRIORITY 2
+#endif
+
+#ifndef MDS_TEST_TICKS
+#define MDS_TEST_TICKS 10
+#endif
+
+#define MDS_TEST_CHECK(cond) MDS_TEST_Check((cond), #cond, __FILE__, __LINE__)
+
+/* Function ---------------------------------------------------------------- */
+/* implemented by every test program, runs in a thread of MDS_TEST_PRIORITY once the kernel started */
+extern void MDS_TEST_Main(void);
+
+extern bool MDS_TEST_Check(bool pass, const char *expr, const char *file, int line);
+extern void MDS_TEST_Skip(const char *reason);
+extern void MDS_TEST_Finish(void);
+extern uint64_t MDS_TEST_ClockNs(void);
+extern void MDS_TEST_BusyWait(MDS_Tick_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MDS_TEST_H__ */
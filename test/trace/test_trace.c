@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) [2022] [pchom]
+ * [MDS] is licensed under Mulan PSL v2.
+ * You can use this software according to the terms and conditions of the Mulan PSL v2.
+ * You may obtain a copy of Mulan PSL v2 at:
+ *          http://license.coscl.org.cn/MulanPSL2
+ * THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+ * EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+ * MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+ * See the Mulan PSL v2 for more details.
+ **/
+/* Include ----------------------------------------------------------------- */
+#include "mds_test.h"
+#include "mds_trace.h"
+
+/* Define ------------------------------------------------------------------ */
+#define TEST_TRACE_TICKS 500
+#define TEST_TRACE_OBJ   0x5A5AU
+
+/* Variable ---------------------------------------------------------------- */
+static MDS_Timer_t g_testTimer;
+static volatile size_t g_testIsrCount = 0;
+
+/* Function ---------------------------------------------------------------- */
+static void TEST_TimerEntry(MDS_Arg_t *arg)
+{
+    UNUSED(arg);
+
+    // runs in the tick interrupt and lands between the reservation and the stamp of the thread writer
+    MDS_TRACE_Record(MDS_TRACE_TYPE_USER + 1U, TEST_TRACE_OBJ, 0);
+    g_testIsrCount += 1;
+}
+
+#if (defined(MDS_HOOK_ENABLE) && (MDS_HOOK_ENABLE > 0)) && (MDS_HOOK_CHAIN_SIZE <= 4)
+static void TEST_TimerHook0(MDS_Timer_t *timer)
+{
+    UNUSED(timer);
+}
+
+static void TEST_TimerHook1(MDS_Timer_t *timer)
+{
+    UNUSED(timer);
+}
+
+static void TEST_TimerHook2(MDS_Timer_t *timer)
+{
+    UNUSED(timer);
+}
+
+static void TEST_TimerHook3(MDS_Timer_t *timer)
+{
+    UNUSED(timer);
+}
+
+static void TEST_InitFull(void)
+{
+    static void (*const hooks[])(MDS_Timer_t *) = {TEST_TimerHook0, TEST_TimerHook1, TEST_TimerHook2, TEST_TimerHook3};
+
+    // a full chain fails init and leaves none of the trace hooks behind
+    for (size_t idx = 0; idx < MDS_HOOK_CHAIN_SIZE; idx++) {
+        MDS_TEST_CHECK(MDS_HOOK_REGISTER(TIMER_EXIT, hooks[idx]) == MDS_EOK);
+    }
+    MDS_TEST_CHECK(MDS_TRACE_Init(1000000000U) == MDS_ENOMEM);
+    for (size_t idx = 0; idx < MDS_HOOK_CHAIN_SIZE; idx++) {
+        MDS_TEST_CHECK(MDS_HOOK_UNREGISTER(TIMER_EXIT, hooks[idx]) == MDS_EOK);
+        MDS_TEST_CHECK(MDS_HOOK_REGISTER(TIMER_ENTER, hooks[idx]) == MDS_EOK);
+    }
+    for (size_t idx = 0; idx < MDS_HOOK_CHAIN_SIZE; idx++) {
+        MDS_HOOK_UNREGISTER(TIMER_ENTER, hooks[idx]);
+    }
+}
+#endif
+
+void MDS_TEST_Main(void)
+{
+    const MDS_TRACE_Buffer_t *buffer = MDS_TRACE_GetBuffer();
+
+#if (defined(MDS_HOOK_ENABLE) && (MDS_HOOK_ENABLE > 0)) && (MDS_HOOK_CHAIN_SIZE <= 4)
+    TEST_InitFull();
+#endif
+    MDS_TEST_CHECK(MDS_TRACE_Init(1000000000U) == MDS_EOK);
+    MDS_TEST_CHECK(MDS_TRACE_Init(1000000000U) == MDS_EOK);
+    MDS_TRACE_Start();
+
+    // objects keep their full address on 64-bit hosts
+    const MDS_TRACE_Event_t *first = &(buffer->events[(buffer->index - 1U) & (MDS_TRACE_EVENT_NUMS - 1U)]);
+    MDS_TEST_CHECK(first->type == MDS_TRACE_TYPE_THREAD_SWITCH);
+    MDS_TEST_CHECK(first->obj == (uintptr_t)MDS_KernelCurrentThread());
+
+    MDS_Err_t err = MDS_TimerInit(&g_testTimer, "trace", MDS_TIMER_TYPE_PERIOD | MDS_TIMER_TYPE_SYSTEM,
+                                  TEST_TimerEntry, NULL);
+    if (err == MDS_EOK) {
+        err = MDS_TimerStart(&g_testTimer, 1);
+    }
+    MDS_TEST_CHECK(err == MDS_EOK);
+
+    // events in sequence order never step back in time
+    size_t records = 0;
+    size_t reorder = 0;
+    size_t torn = 0;
+    uint32_t checked = buffer->index;
+    uint32_t last = buffer->events[(checked - 1U) & (MDS_TRACE_EVENT_NUMS - 1U)].stamp;
+    MDS_Tick_t start = MDS_SysTickGetCount();
+    while ((MDS_SysTickGetCount() - start) < TEST_TRACE_TICKS) {
+        MDS_TRACE_Record(MDS_TRACE_TYPE_USER, records, 0);
+        records += 1;
+
+        for (uint32_t index = buffer->index; (index - checked) > 0U; checked++) {
+            const MDS_TRACE_Event_t *event = &(buffer->events[checked & (MDS_TRACE_EVENT_NUMS - 1U)]);
+            if (event->seq != (uint16_t)checked) {
+                torn += 1;
+                continue;
+            }
+            if ((int32_t)(event->stamp - last) < 0) {
+                reorder += 1;
+            }
+            last = event->stamp;
+        }
+    }
+    MDS_TimerStop(&g_testTimer);
+    MDS_TRACE_Stop();
+
+    MDS_LOG_I("[test] trace records:%u isr:%u reorder:%u", (unsigned)records, (unsigned)g_testIsrCount,
+              (unsigned)reorder);
+    MDS_TEST_CHECK(g_testIsrCount >= (TEST_TRACE_TICKS / 2));
+    MDS_TEST_CHECK(torn == 0);
+    MDS_TEST_CHECK(reorder == 0);
+
+    MDS_TimerDeInit(&g_testTimer);
+}